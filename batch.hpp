@@ -0,0 +1,271 @@
+// Stapelberechnung von Großkreisdistanzen (alle Paare) über die Winkelfunktionsspalten eines Koordinatenspeichers (store.hpp)
+//
+// Die Kerne rechnen dieselbe Formel wie calcGCDkm, zerlegen cos(lambda_b - lambda_a) aber in
+// cos(la)cos(lb) + sin(la)sin(lb), damit pro Paar keine Winkelfunktion außer arccos anfällt. arccos wird
+// in den SIMD-Kernen über ein Minimax-Polynom (Cephes) ausgewertet.
+//
+// Toleranz gegenüber calcGCDkm (für alle Befehlssätze, die SIMD-Kerne liefern untereinander identische Werte):
+//   Zentriwinkel zwischen 1 und 179 Grad: |d_batch - d_calcGCDkm| <= 0.05 km + 1e-5 * d_calcGCDkm
+//   Zentriwinkel unter 1 bzw. über 179 Grad: |d_batch - d_calcGCDkm| <= 5 km
+// Im zweiten Fall ist arccos schlecht konditioniert; die Abweichung entspricht der Eigenungenauigkeit von
+// calcGCDkm in float-Genauigkeit.
+#pragma once
+
+/// Standardbibliotheken
+#include <cmath>   // std::acos
+#include <cstddef> // size_t
+#include <cstdint> // uintptr_t
+#include <cstring> // std::memcpy
+#include <vector>  // std::vector
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // SSE/AVX-Intrinsics
+#define BATCH_X86
+#endif
+
+/// Eigene Header
+#include "geometry.hpp" // r_E, clampUnit
+#include "matrix.hpp"   // MatrixLayout, matrixSize, matrixRowOffset
+#include "store.hpp"    // CoordinateView, withTrig
+#include "executor.hpp" // ThreadPool, CacheLine
+
+// Verfügbare Befehlssätze der Kerne:
+enum class Isa
+{
+    Scalar,
+    SSE,
+    AVX2,
+    AVX512
+};
+
+// Anzahl Lanes eines Registers für den Skalartyp T (float: 4/8/16, double: 2/4/8):
+template <class T>
+constexpr size_t laneWidth(Isa isa) noexcept
+{
+    switch (isa)
+    {
+    case Isa::SSE:
+        return 16 / sizeof(T);
+    case Isa::AVX2:
+        return 32 / sizeof(T);
+    case Isa::AVX512:
+        return 64 / sizeof(T);
+    default:
+        return 1;
+    }
+}
+
+inline const char *isaName(Isa isa) noexcept
+{
+    switch (isa)
+    {
+    case Isa::SSE:
+        return "SSE";
+    case Isa::AVX2:
+        return "AVX2";
+    case Isa::AVX512:
+        return "AVX-512";
+    default:
+        return "Skalar";
+    }
+}
+
+namespace batch
+{
+    // Skalare Rückfallebene (libm), auch für double:
+    namespace scalar
+    {
+        template <class T>
+        inline void gcdRow(T sinPhi_a, T cosPhi_a, T sinLambda_a, T cosLambda_a,
+                           const T *sinPhi_b, const T *cosPhi_b, const T *sinLambda_b, const T *cosLambda_b,
+                           size_t count, T radius, T *out) noexcept
+        {
+            for (size_t j = 0; j < count; j++)
+            {
+                const auto cosDL{cosLambda_b[j] * cosLambda_a + sinLambda_b[j] * sinLambda_a};
+                const auto x{sinPhi_a * sinPhi_b[j] + cosPhi_a * cosPhi_b[j] * cosDL};
+                out[j] = std::acos(clampUnit(x)) * radius;
+            }
+        }
+
+        template <class T>
+        inline void gcdPairs(const T *sinPhi_a, const T *cosPhi_a, const T *sinLambda_a, const T *cosLambda_a,
+                             const T *sinPhi_b, const T *cosPhi_b, const T *sinLambda_b, const T *cosLambda_b,
+                             size_t count, T radius, T *out) noexcept
+        {
+            for (size_t j = 0; j < count; j++)
+                gcdRow(sinPhi_a[j], cosPhi_a[j], sinLambda_a[j], cosLambda_a[j], sinPhi_b + j, cosPhi_b + j, sinLambda_b + j, cosLambda_b + j,
+                       1, radius, out + j);
+        }
+    } // namespace scalar
+
+#ifdef BATCH_X86
+#pragma GCC push_options
+#pragma GCC target("sse2")
+    namespace sse
+    {
+        constexpr size_t W{laneWidth<float>(Isa::SSE)};
+        using vf = float __attribute__((vector_size(16)));
+        inline vf vsqrt(vf x) noexcept { return _mm_sqrt_ps(x); }
+#include "batch_kernel.inl"
+    } // namespace sse
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+    namespace avx2
+    {
+        constexpr size_t W{laneWidth<float>(Isa::AVX2)};
+        using vf = float __attribute__((vector_size(32)));
+        inline vf vsqrt(vf x) noexcept { return _mm256_sqrt_ps(x); }
+#include "batch_kernel.inl"
+    } // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off") // AVX-512F bringt FMA mit: keine Kontraktion, damit alle Kerne identisch runden
+    namespace avx512
+    {
+        constexpr size_t W{laneWidth<float>(Isa::AVX512)};
+        using vf = float __attribute__((vector_size(64)));
+        inline vf vsqrt(vf x) noexcept { return _mm512_sqrt_ps(x); }
+#include "batch_kernel.inl"
+    } // namespace avx512
+#pragma GCC pop_options
+#endif
+
+    using RowKernel = void (*)(float, float, float, float, const float *, const float *, const float *, const float *, size_t, float, float *) noexcept;
+
+    // Liefert den Kern zum angeforderten Befehlssatz:
+    inline RowKernel kernelFor(Isa isa) noexcept
+    {
+        switch (isa)
+        {
+#ifdef BATCH_X86
+        case Isa::AVX512:
+            return avx512::gcdRow;
+        case Isa::AVX2:
+            return avx2::gcdRow;
+        case Isa::SSE:
+            return sse::gcdRow;
+#endif
+        default:
+            return scalar::gcdRow<float>;
+        }
+    }
+
+    using PairKernel = void (*)(const float *, const float *, const float *, const float *, const float *, const float *, const float *,
+                                const float *, size_t, float, float *) noexcept;
+
+    // Wie kernelFor, für paarweise Distanzen (a[j] nach b[j]):
+    inline PairKernel pairKernelFor(Isa isa) noexcept
+    {
+        switch (isa)
+        {
+#ifdef BATCH_X86
+        case Isa::AVX512:
+            return avx512::gcdPairs;
+        case Isa::AVX2:
+            return avx2::gcdPairs;
+        case Isa::SSE:
+            return sse::gcdPairs;
+#endif
+        default:
+            return scalar::gcdPairs<float>;
+        }
+    }
+} // namespace batch
+
+// Ermittelt zur Laufzeit den besten vom Prozessor unterstützten Befehlssatz:
+inline Isa detectIsa(void) noexcept
+{
+#ifdef BATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return Isa::AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return Isa::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return Isa::SSE;
+#endif
+    return Isa::Scalar;
+}
+
+// Berechnet die Zeilen [rowBegin; rowEnd) der Distanzmatrix in [km]. out zeigt auf den Anfang der gesamten Matrix.
+// Bringt coords keine Winkelfunktionen mit, werden sie für alle Koordinaten berechnet (besser einmal über calcGCDMatrix).
+inline void calcGCDRows(const CoordinateView &coords, size_t rowBegin, size_t rowEnd, float *out, MatrixLayout layout, Isa isa = detectIsa())
+{
+    TrigColumns derived;
+    const auto store{withTrig(coords, derived)};
+    const auto n{store.size()};
+    const auto kernel{batch::kernelFor(isa)};
+
+    for (size_t i = rowBegin; i < rowEnd && i < n; i++)
+    {
+        const auto first{(layout == MatrixLayout::Dense) ? size_t{0} : i + 1}; // erste Spalte der Zeile
+        auto *row{out + matrixRowOffset(n, i, layout)};
+
+        kernel(store.sinPhi[i], store.cosPhi[i], store.sinLambda[i], store.cosLambda[i],
+               store.sinPhi + first, store.cosPhi + first, store.sinLambda + first, store.cosLambda + first,
+               n - first, r_E, row);
+
+        if (layout == MatrixLayout::Dense)
+            row[i] = 0.0f; // Diagonale exakt 0, unabhängig von Rundungsfehlern
+    }
+}
+
+// Teilt die Zeilen der Matrix in Blöcke mit etwa chunkElements Werten auf. Blockgrenzen werden (wenn möglich) auf
+// eine Zeile verschoben, deren Anfang auf einer Cache-Line liegt, damit sich zwei Threads keine Zeile teilen.
+// Liefert die Grenzen inkl. 0 und n.
+inline std::vector<size_t> matrixRowChunks(size_t n, MatrixLayout layout, const float *out, size_t chunkElements = 1 << 16)
+{
+    const auto aligned = [out, n, layout](size_t row) {
+        return (reinterpret_cast<uintptr_t>(out + matrixRowOffset(n, row, layout)) % CacheLine) == 0;
+    };
+
+    std::vector<size_t> bounds{0};
+    size_t row{0};
+    while (row < n)
+    {
+        // Zeilen sammeln, bis der Block voll ist:
+        size_t elements{0};
+        while ((row < n) && (elements < chunkElements))
+        {
+            elements += n - ((layout == MatrixLayout::Dense) ? 0 : row + 1);
+            row++;
+        }
+
+        // Nächste ausgerichtete Zeile suchen (höchstens eine Cache-Line an Zeilen weiter):
+        for (size_t k = 0; (k < CacheLine / sizeof(float)) && (row + k < n); k++)
+            if (aligned(row + k))
+            {
+                row += k;
+                break;
+            }
+
+        bounds.push_back(row);
+    }
+    return bounds;
+}
+
+// Berechnet die gesamte Distanzmatrix in [km]. out muss matrixSize(store.size(), layout) Elemente fassen.
+// Mit pool werden die Zeilenblöcke parallel berechnet; das Ergebnis ist unabhängig von der Anzahl Threads.
+inline void calcGCDMatrix(const CoordinateView &coords, float *out, MatrixLayout layout, Isa isa = detectIsa(), ThreadPool *pool = nullptr)
+{
+    TrigColumns derived; // einmal für alle Zeilenblöcke
+    const auto store{withTrig(coords, derived)};
+    if (!pool || (pool->size() == 1))
+        return calcGCDRows(store, 0, store.size(), out, layout, isa);
+
+    const auto bounds{matrixRowChunks(store.size(), layout, out)};
+    pool->run(bounds.size() - 1, [&](size_t c) { calcGCDRows(store, bounds[c], bounds[c + 1], out, layout, isa); });
+}
+
+// Wie oben, Ergebnis als std::vector:
+inline std::vector<float> calcGCDMatrix(const CoordinateView &store, MatrixLayout layout, Isa isa = detectIsa(), ThreadPool *pool = nullptr)
+{
+    std::vector<float> out(matrixSize(store.size(), layout));
+    calcGCDMatrix(store, out.data(), layout, isa, pool);
+    return out;
+}
@@ -0,0 +1,126 @@
+// Vektorkerne für die Zentriwinkel-Berechnung einer Matrixzeile bzw. von Paaren.
+// Wird von batch.hpp je Befehlssatz einmal in einen eigenen Namespace eingebunden (SSE, AVX2, AVX-512).
+// Vor dem Einbinden müssen definiert sein:
+//   W      - Anzahl float-Lanes
+//   vf     - GCC-Vektortyp mit W float-Elementen
+//   vsqrt  - Quadratwurzel über alle Lanes
+
+using vi = int __attribute__((vector_size(sizeof(vf)))); // Maskentyp passend zu vf
+
+inline vf vset1(float x) noexcept
+{
+    vf v;
+    for (size_t l = 0; l < W; l++)
+        v[l] = x;
+    return v;
+}
+
+inline vf vload(const float *p) noexcept
+{
+    vf v;
+    std::memcpy(&v, p, sizeof(vf)); // unausgerichtetes Laden
+    return v;
+}
+
+inline void vstore(float *p, vf v) noexcept
+{
+    std::memcpy(p, &v, sizeof(vf));
+}
+
+// arccos nach Cephes (acosf), verzweigungsfrei über alle Lanes. Max. Fehler ca. 2 ulp im Intervall [-1; 1]
+inline vf vacos(vf x) noexcept
+{
+    const vf one{vset1(1.0f)}, half{vset1(0.5f)}, zero{vset1(0.0f)};
+
+    x = (x > one) ? one : x; // Rundungsfehler des Skalarprodukts abfangen
+    x = (x < -one) ? -one : x;
+
+    const vi neg{x < zero};
+    const vf a{neg ? -x : x};
+    const vi gross{a > half}; // |x| > 0.5: über Halbwinkel rechnen, sonst über pi/2 - asin(x)
+
+    const vf z{gross ? half * (one - a) : x * x};
+    const vf s{gross ? vsqrt(z) : x};
+
+    // asin(s) für |s| <= 0.5
+    vf p{vset1(4.2163199048E-2f)};
+    p = p * z + vset1(2.4181311049E-2f);
+    p = p * z + vset1(4.5470025998E-2f);
+    p = p * z + vset1(7.4953002686E-2f);
+    p = p * z + vset1(1.6666752422E-1f);
+    p = p * z * s + s;
+
+    const vf r_gross{neg ? vset1(static_cast<float>(M_PI)) - (p + p) : (p + p)};
+    const vf r_klein{vset1(static_cast<float>(M_PI / 2)) - p};
+
+    return gross ? r_gross : r_klein;
+}
+
+// Berechnet count Großkreisdistanzen [km] von Punkt a zu den Punkten b[0..count), Ergebnis nach out
+inline void gcdRow(float sinPhi_a, float cosPhi_a, float sinLambda_a, float cosLambda_a,
+                   const float *sinPhi_b, const float *cosPhi_b, const float *sinLambda_b, const float *cosLambda_b,
+                   size_t count, float radius, float *out) noexcept
+{
+    const vf sa{vset1(sinPhi_a)}, ca{vset1(cosPhi_a)}, sla{vset1(sinLambda_a)}, cla{vset1(cosLambda_a)};
+    const vf r{vset1(radius)};
+
+    const auto kern = [&](const float *sb, const float *cb, const float *slb, const float *clb) -> vf {
+        // cos(lambda_b - lambda_a) = cos(lb)cos(la) + sin(lb)sin(la)
+        const vf cosDL{vload(clb) * cla + vload(slb) * sla};
+        return vacos(sa * vload(sb) + ca * vload(cb) * cosDL) * r;
+    };
+
+    size_t j{0};
+    for (; j + W <= count; j += W)
+        vstore(out + j, kern(sinPhi_b + j, cosPhi_b + j, sinLambda_b + j, cosLambda_b + j));
+
+    // Rest über gepufferte Lanes rechnen, damit alle Elemente denselben Kern durchlaufen:
+    if (j < count)
+    {
+        const auto rest{count - j};
+        float sb[W]{}, cb[W]{}, slb[W]{}, clb[W]{}, res[W];
+        std::memcpy(sb, sinPhi_b + j, rest * sizeof(float));
+        std::memcpy(cb, cosPhi_b + j, rest * sizeof(float));
+        std::memcpy(slb, sinLambda_b + j, rest * sizeof(float));
+        std::memcpy(clb, cosLambda_b + j, rest * sizeof(float));
+        vstore(res, kern(sb, cb, slb, clb));
+        std::memcpy(out + j, res, rest * sizeof(float));
+    }
+}
+
+// Berechnet count Großkreisdistanzen [km] paarweise von a[j] nach b[j] (z.B. für Stapel aus Start/Ziel-Paaren)
+inline void gcdPairs(const float *sinPhi_a, const float *cosPhi_a, const float *sinLambda_a, const float *cosLambda_a,
+                     const float *sinPhi_b, const float *cosPhi_b, const float *sinLambda_b, const float *cosLambda_b,
+                     size_t count, float radius, float *out) noexcept
+{
+    const vf r{vset1(radius)};
+
+    const auto kern = [&r](const float *const *a, const float *const *b, size_t j) -> vf {
+        const vf cosDL{vload(b[3] + j) * vload(a[3] + j) + vload(b[2] + j) * vload(a[2] + j)};
+        return vacos(vload(a[0] + j) * vload(b[0] + j) + vload(a[1] + j) * vload(b[1] + j) * cosDL) * r;
+    };
+
+    const float *a[]{sinPhi_a, cosPhi_a, sinLambda_a, cosLambda_a};
+    const float *b[]{sinPhi_b, cosPhi_b, sinLambda_b, cosLambda_b};
+
+    size_t j{0};
+    for (; j + W <= count; j += W)
+        vstore(out + j, kern(a, b, j));
+
+    // Rest wie in gcdRow über gepufferte Lanes:
+    if (j < count)
+    {
+        const auto rest{count - j};
+        float buffer[8][W]{}, res[W];
+        const float *ra[4], *rb[4];
+        for (size_t c = 0; c < 4; c++)
+        {
+            std::memcpy(buffer[c], a[c] + j, rest * sizeof(float));
+            std::memcpy(buffer[4 + c], b[c] + j, rest * sizeof(float));
+            ra[c] = buffer[c];
+            rb[c] = buffer[4 + c];
+        }
+        vstore(res, kern(ra, rb, 0));
+        std::memcpy(out + j, res, rest * sizeof(float));
+    }
+}
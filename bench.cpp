@@ -0,0 +1,1365 @@
+// Benchmarks (Aufruf: ./bench [Anzahl Zeilen] [--suite] [--json <Datei>])
+
+/// Standardbibliotheken
+#include <chrono>   // Zeitmessung
+#include <cstring>  // std::memcpy
+#include <cstdio>   // std::remove
+#include <fstream>  // std::ifstream, std::ofstream
+#include <algorithm> // std::sort
+#include <iostream> // Konsolenausgabe
+#include <memory>   // std::unique_ptr
+#include <random>   // Zufallskoordinaten
+#include <sstream>  // std::ostringstream
+#include <iomanip>  // std::setprecision, std::setw
+#include <iterator> // std::istreambuf_iterator
+#include <thread>   // std::thread::hardware_concurrency
+#include <regex>    // alter Einleser
+#include <string>   // std::string
+#include <type_traits> // std::is_arithmetic
+#include <vector>   // std::vector
+
+/// Eigene Header
+#include "sphere.hpp"   // Coordinate
+#include "parser.hpp"   // parseCoordinateFile
+#include "database.hpp" // Database
+#include "registry.hpp" // CoordinateRegistry
+#include "spatial.hpp"  // SpatialIndex
+#include "batch.hpp"    // calcGCDMatrix
+#include "executor.hpp" // ThreadPool
+#include "route.hpp"    // GreatCircleLeg
+#include "query.hpp"    // runBatch
+#include "loxodrome.hpp" // calcLoxodromes
+#include "nvector.hpp"   // Backend
+#include "fastmath.hpp"  // fastAcos, screenWithin
+#include "geofence.hpp"  // checkGeofence
+#include "ellipsoid.hpp" // calcGeodesics, wgs84::inverse
+#include "sweep.hpp"     // CrashSweep
+#include "tour.hpp"      // optimizeTour
+#include "catalog.hpp"   // Catalog
+#include "libtrig.hpp"   // Stapelfunktionen der Bibliothek
+#include "server.hpp"    // QueryServer
+
+#define BenchFile "bench_input.txt"   // temporäre Eingabedatei
+#define BenchDatabase "bench_input.db" // temporäre Binärdatenbank
+#define BenchCommands "bench_cmds.txt" // temporäre Befehlsdatei
+#define BenchSocket "bench_server.sock" // temporärer Socket des Servers
+
+// Misst die Laufzeit von f in Sekunden:
+template <class F>
+double measure(F &&f)
+{
+    const auto start{std::chrono::steady_clock::now()};
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Schreibt eine Eingabedatei mit n zufälligen Koordinaten im Format von in.txt:
+void writeInputFile(const char *filename, uint32_t n)
+{
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> el{0, 89}, az{0, 179}, ms{0, 59}, dir{0, 1};
+
+    std::ofstream file(filename);
+    file << "# Benchmark-Eingabe\n";
+    for (uint32_t i = 0; i < n; i++)
+        file << el(gen) << ' ' << ms(gen) << ' ' << ms(gen) << ' ' << (dir(gen) ? 'N' : 'S') << ", "
+             << az(gen) << ' ' << ms(gen) << ' ' << ms(gen) << ' ' << (dir(gen) ? 'W' : 'O') << ", Wegpunkt " << i << '\n';
+}
+
+// Bisheriger Einleser aus main() (std::getline, substr, std::regex, std::atoi) als Vergleichsbasis:
+std::vector<Coordinate> legacyLoad(const char *filename)
+{
+    std::ifstream file(filename);
+    std::vector<Coordinate> coords;
+    std::string input;
+    const std::regex split("\\s");
+
+    const auto retDirAz = [](const char *c) -> directionAz {
+        if (*c == 'W')
+            return directionAz::W;
+        else if (*c == 'O')
+            return directionAz::O;
+        else
+            throw std::logic_error("Ungültige Richtung (Azimut)!");
+    };
+
+    const auto retDirEl = [](const char *c) -> directionEl {
+        if (*c == 'N')
+            return directionEl::N;
+        else if (*c == 'S')
+            return directionEl::S;
+        else
+            throw std::logic_error("Ungültige Richtung (Elevation)!");
+    };
+
+    while (std::getline(file, input))
+    {
+        if (input.at(0) == '#')
+            continue;
+
+        const auto n1{input.find(',')};
+        const auto n2{input.find(',', n1 + 1)};
+
+        const std::string Breitengrad{input.substr(0, n1)};
+        const std::string Laengengrad{input.substr(n1 + 2, n2 - n1 - 1)};
+        const std::string Bezeichnung{input.substr(n2 + 2, input.length())};
+
+        const std::vector<std::string> resultB{
+            std::sregex_token_iterator(Breitengrad.begin(), Breitengrad.end(), split, -1), {}};
+        const std::vector<std::string> resultL{
+            std::sregex_token_iterator(Laengengrad.begin(), Laengengrad.end(), split, -1), {}};
+
+        coords.push_back(Coordinate{static_cast<uint16_t>(std::atoi(resultB[0].c_str())),
+                                    static_cast<uint8_t>(std::atoi(resultB[1].c_str())),
+                                    static_cast<uint8_t>(std::atoi(resultB[2].c_str())),
+                                    retDirEl(resultB[3].c_str()),
+                                    static_cast<uint16_t>(std::atoi(resultL[0].c_str())),
+                                    static_cast<uint8_t>(std::atoi(resultL[1].c_str())),
+                                    static_cast<uint8_t>(std::atoi(resultL[2].c_str())),
+                                    retDirAz(resultL[3].c_str()),
+                                    Bezeichnung,
+                                    0});
+    }
+
+    return coords;
+}
+
+// Neuer Einleser, einmal nur zerlegen und einmal inkl. Aufbau des Koordinatenspeichers wie in main():
+void benchParser(uint32_t lines)
+{
+    writeInputFile(BenchFile, lines);
+
+    size_t legacyCount{0}, parseCount{0}, buildCount{0}, legacyBytes{0};
+
+    const auto tLegacy{measure([&legacyCount, &legacyBytes]() {
+        const auto coords{legacyLoad(BenchFile)};
+        legacyCount = coords.size();
+        legacyBytes = coords.capacity() * sizeof(Coordinate);
+        for (const auto &c : coords)
+            legacyBytes += (c.name.capacity() > 15) ? c.name.capacity() + 1 : 0; // außerhalb des SSO-Puffers
+    })};
+
+    const auto tParse{measure([&parseCount]() {
+        parseCoordinateFile(BenchFile, [&parseCount](const ParsedCoordinate &) { parseCount++; });
+    })};
+
+    // Wie in main(): direkt in den Koordinatenspeicher inkl. Winkelfunktionen (ohne --no-trig)
+    CoordinateStore store;
+    store.cacheTrig();
+    const auto tBuild{measure([&buildCount, &store]() {
+        loadCoordinateFile(BenchFile, store);
+        buildCount = store.size();
+    })};
+
+    // Binärdatenbank einblenden (Umwandlung vorab, nicht gemessen):
+    writeDatabase(store, BenchDatabase);
+
+    size_t dbCount{0};
+    const auto tDatabase{measure([&dbCount]() {
+        const Database db(BenchDatabase);
+        dbCount = db.view().size();
+    })};
+
+    std::remove(BenchFile);
+    std::remove(BenchDatabase);
+
+    const auto report = [](const char *name, size_t count, double seconds, double reference) {
+        std::cout << "  " << std::left << std::setw(34) << name << std::right << std::setw(12) << count << " Zeilen"
+                  << std::setw(14) << std::fixed << std::setprecision(0) << (count / seconds) << " Zeilen/s"
+                  << std::setw(9) << std::setprecision(1) << (reference / seconds) << 'x' << std::defaultfloat << '\n';
+    };
+
+    std::cout << "Einlesen (" << lines << " Zeilen):\n";
+    report("alt (getline/regex/atoi)", legacyCount, tLegacy, tLegacy);
+    report("parseCoordinateFile", parseCount, tParse, tLegacy);
+    report("loadCoordinateFile", buildCount, tBuild, tLegacy);
+    report("Database (mmap)", dbCount, tDatabase, tLegacy);
+    const auto cachedBytes{store.bytes()};
+    store.cacheTrig(false);
+    std::cout << "  Speicher je Koordinate: alt " << (legacyBytes / legacyCount) << " Byte, Koordinatenspeicher " << (store.bytes() / buildCount)
+              << " Byte (Datensatz 16, Rest Arena; " << store.strings->size() << " Bezeichner interniert), mit Winkelfunktionen "
+              << (cachedBytes / buildCount) << " Byte\n";
+    std::cout << std::endl;
+}
+
+// Aufbau des Hash-Verzeichnisses und Suche nach Bezeichner (linear vs. Hashtabelle):
+void benchRegistry(uint32_t count)
+{
+    CoordinateStore store;
+    store.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+        store.add(0.0f, 0.0f, "Wegpunkt " + std::to_string(i));
+
+    std::unique_ptr<CoordinateRegistry> registry;
+    const auto tBuild{measure([&registry, &store]() { registry = std::make_unique<CoordinateRegistry>(store); })};
+
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<uint32_t> pick{0, count - 1};
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; i++)
+        keys.push_back("Wegpunkt " + std::to_string(pick(gen)));
+
+    uint64_t sum{0};
+    const auto tHash{measure([&]() {
+        for (const auto &k : keys)
+            sum += registry->find(k);
+    })};
+
+    const auto view{store.view()};
+    const auto tLinear{measure([&]() {
+        for (size_t k = 0; k < 10; k++) // lineare Suche nur für 10 Schlüssel
+            for (size_t i = 0; i < view.size(); i++)
+                if (view.name(i) == keys[k])
+                {
+                    sum += i;
+                    break;
+                }
+    })};
+
+    std::cout << "Verzeichnis (" << count << " Bezeichner):\n"
+              << "  Aufbau                " << std::fixed << std::setprecision(3) << tBuild << " s\n"
+              << "  Suche Hashtabelle     " << std::setprecision(0) << (tHash / keys.size() * 1e9) << " ns\n"
+              << "  Suche linear          " << (tLinear / 10 * 1e9) << " ns\n"
+              << std::defaultfloat << "  (Prüfsumme " << sum << ")\n"
+              << std::endl;
+}
+
+// Räumlicher Index gegen Vergleich mit allen Koordinaten (k nächste und Umkreis 300 km), inkl. Ergebnisprüfung:
+void benchSpatial(uint32_t count)
+{
+    std::mt19937 gen{11};
+    std::uniform_real_distribution<float> z{-1.0f, 1.0f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+
+    CoordinateStore store; // gleichverteilt auf der Kugel
+    store.cacheTrig();
+    store.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+        store.add(asinf(z(gen)), az(gen));
+    const auto view{store.view()};
+
+    std::unique_ptr<SpatialIndex> index;
+    const auto tBuild{measure([&index, &view]() { index = std::make_unique<SpatialIndex>(view); })};
+
+    constexpr size_t k{5};
+    constexpr float radius{300.0f};
+    constexpr uint32_t bruteQueries{20}, indexQueries{2000};
+
+    const auto brute = [&view](const PreparedCoordinate &q, size_t k, float radius) {
+        std::vector<Neighbour> all;
+        for (size_t i = 0; i < view.size(); i++)
+            if (i != q.id)
+                all.push_back(Neighbour{static_cast<uint32_t>(i), calcGCDkm(q, view.prepared(i))});
+
+        std::vector<Neighbour> near(std::min(k, all.size())), inside;
+        std::partial_sort_copy(all.begin(), all.end(), near.begin(), near.end());
+        for (const auto &n : all)
+            if (n.km <= radius)
+                inside.push_back(n);
+        std::sort(inside.begin(), inside.end());
+        return std::make_pair(near, inside);
+    };
+
+    const auto same = [](const std::vector<Neighbour> &a, const std::vector<Neighbour> &b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                          [](const Neighbour &x, const Neighbour &y) { return (x.id == y.id) && (x.km == y.km); });
+    };
+
+    uint32_t mismatches{0};
+    const auto tBrute{measure([&]() {
+        for (uint32_t q = 0; q < bruteQueries; q++)
+        {
+            const auto p{view.prepared(q * (count / bruteQueries))};
+            const auto expected{brute(p, k, radius)};
+            mismatches += !same(index->nearest(p, k, p.id), expected.first) + !same(index->within(p, radius, p.id), expected.second);
+        }
+    })};
+
+    size_t found{0};
+    const auto tNearest{measure([&]() {
+        for (uint32_t q = 0; q < indexQueries; q++)
+        {
+            const auto p{view.prepared((q * 7919u) % count)};
+            found += index->nearest(p, k, p.id).size();
+        }
+    })};
+    const auto tWithin{measure([&]() {
+        for (uint32_t q = 0; q < indexQueries; q++)
+        {
+            const auto p{view.prepared((q * 7919u) % count)};
+            found += index->within(p, radius, p.id).size();
+        }
+    })};
+
+    const auto us = [](double seconds, uint32_t n) { return seconds / n * 1e6; };
+    std::cout << "Räumlicher Index (" << count << " Koordinaten, k = " << k << ", Umkreis " << static_cast<uint32_t>(radius) << " km):\n"
+              << std::fixed << std::setprecision(1)
+              << "  Aufbau                " << (tBuild * 1e3) << " ms\n"
+              << "  alle (k + Umkreis)    " << us(tBrute, bruteQueries) << " us/Abfrage\n"
+              << "  k nächste             " << us(tNearest, indexQueries) << " us/Abfrage\n"
+              << "  Umkreis               " << us(tWithin, indexQueries) << " us/Abfrage\n"
+              << std::defaultfloat
+              << "  Abweichungen          " << mismatches << " (Treffer " << found << ")\n"
+              << std::endl;
+}
+
+// Distanzmatrix und k-nächste-Abfragen mit 1, 2, 4, ... Threads, Ergebnis muss bitgleich zum seriellen sein:
+void benchExecutor(uint32_t count)
+{
+    std::mt19937 gen{5};
+    std::uniform_real_distribution<float> z{-1.0f, 1.0f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+
+    CoordinateStore store;
+    store.cacheTrig();
+    store.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+        store.add(asinf(z(gen)), az(gen));
+    const auto view{store.view()};
+    const SpatialIndex index(view);
+
+    const auto hardware{std::max(1u, std::thread::hardware_concurrency())};
+    std::vector<float> reference, matrix;
+    std::vector<uint32_t> referenceIds, ids(count);
+    double tMatrix1{0}, tNearest1{0};
+
+    std::cout << "Thread-Pool (" << count << " Koordinaten, " << hardware << " Hardware-Threads):\n";
+    for (unsigned threads = 1; threads <= std::max(4u, hardware); threads *= 2)
+    {
+        ThreadPool pool(threads);
+
+        const auto tMatrix{measure([&]() { matrix = calcGCDMatrix(view, MatrixLayout::UpperTriangle, detectIsa(), &pool); })};
+        const auto tNearest{measure([&]() {
+            pool.parallelFor(count, 1024, [&](size_t begin, size_t end) {
+                for (auto i = begin; i < end; i++)
+                    ids[i] = index.nearest(view.prepared(i), 1, static_cast<uint32_t>(i)).front().id;
+            });
+        })};
+
+        if (threads == 1)
+        {
+            reference = matrix;
+            referenceIds = ids;
+            tMatrix1 = tMatrix;
+            tNearest1 = tNearest;
+        }
+
+        std::cout << "  " << std::setw(3) << threads << " Threads:  Matrix " << std::fixed << std::setprecision(1)
+                  << std::setw(8) << (tMatrix * 1e3) << " ms (" << std::setprecision(2) << (tMatrix1 / tMatrix) << "x)  "
+                  << "Nachbarn " << std::setprecision(1) << std::setw(8) << (tNearest * 1e3) << " ms ("
+                  << std::setprecision(2) << (tNearest1 / tNearest) << "x)" << std::defaultfloat
+                  << ((matrix == reference) && (ids == referenceIds) ? "" : "  ABWEICHUNG!") << '\n';
+    }
+    std::cout << std::endl;
+}
+
+// Verdichtung einer Strecke gegen wiederholtes calcCrashPointRad (ein Aufruf je Wegpunkt):
+void benchRoute(uint32_t points)
+{
+    const PreparedCoordinate A{deg2rad(49.79f), deg2rad(9.95f)}, B{deg2rad(-22.9f), deg2rad(-43.2f)};
+    const GreatCircleLeg leg(A, B);
+    const auto total{static_cast<float>(leg.km())};
+
+    std::vector<float> phi(points), lambda(points);
+    const auto tDensify{measure([&]() {
+        leg.densify(points, [&](const float *p, const float *l, const float *, size_t n, size_t first) {
+            std::copy(p, p + n, phi.begin() + first);
+            std::copy(l, l + n, lambda.begin() + first);
+        });
+    })};
+
+    float maxDeviation{0};
+    const auto tCrash{measure([&]() {
+        for (uint32_t i = 0; i < points; i++)
+        {
+            // v * fuel / k = Strecke ab A
+            const auto p{calcCrashPointRad(A, B, total * i / (points - 1), 1.0f, 1.0f)};
+            // Haversine in double, calcGCDkm ist für kleine Abstände zu ungenau:
+            const auto dPhi{std::sin((double{p.phi} - phi[i]) / 2)}, dLambda{std::sin((double{p.lambda} - lambda[i]) / 2)};
+            const auto h{dPhi * dPhi + std::cos(double{p.phi}) * std::cos(double{phi[i]}) * dLambda * dLambda};
+            maxDeviation = std::max(maxDeviation, static_cast<float>(2 * std::asin(std::sqrt(h)) * r_E));
+        }
+    })};
+
+    std::cout << "Wegpunkte (" << points << " Punkte, " << std::fixed << std::setprecision(0) << total << " km):\n"
+              << std::setprecision(1)
+              << "  densify               " << (tDensify * 1e9 / points) << " ns/Punkt\n"
+              << "  calcCrashPointRad     " << (tCrash * 1e9 / points) << " ns/Punkt (inkl. Vergleich)\n"
+              << std::setprecision(3)
+              << "  max. Abweichung       " << maxDeviation << " km\n"
+              << std::defaultfloat << std::endl;
+}
+
+// float- gegen double-Pfad der Kernfunktionen; Referenz für die Distanz ist Haversine in long double:
+void benchPrecision(uint32_t pairs)
+{
+    std::mt19937 gen{6};
+    std::uniform_real_distribution<double> z{-0.95, 0.95}, az{-M_PI, M_PI}, offset{-1e-3, 1e-3};
+
+    // Hälfte kurze Strecken (unter ca. 10 km), Hälfte beliebige:
+    std::vector<PreparedCoordinate> af, bf;
+    std::vector<PreparedCoordinateD> ad, bd;
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        const auto phi{std::asin(z(gen))}, lambda{az(gen)};
+        const auto phi_b{(i % 2) ? phi + offset(gen) : std::asin(z(gen))};
+        const auto lambda_b{(i % 2) ? lambda + offset(gen) : az(gen)};
+        ad.emplace_back(phi, lambda);
+        bd.emplace_back(phi_b, lambda_b);
+        af.emplace_back(static_cast<float>(phi), static_cast<float>(lambda));
+        bf.emplace_back(static_cast<float>(phi_b), static_cast<float>(lambda_b));
+    }
+
+    const auto reference = [](const PreparedCoordinateD &a, const PreparedCoordinateD &b) {
+        const auto dPhi{std::sin((static_cast<long double>(b.phi) - a.phi) / 2)};
+        const auto dLambda{std::sin((static_cast<long double>(b.lambda) - a.lambda) / 2)};
+        const auto h{dPhi * dPhi + std::cos(static_cast<long double>(a.phi)) * std::cos(static_cast<long double>(b.phi)) * dLambda * dLambda};
+        return static_cast<double>(2 * std::asin(std::sqrt(h)) * 6378.137L);
+    };
+
+    // Misst f(i) über alle Paare; die Summe verhindert, dass der Compiler die Aufrufe entfernt:
+    volatile double sink{0};
+    const auto perCall = [&](auto &&f) {
+        double sum{0};
+        const auto t{measure([&]() {
+            for (uint32_t i = 0; i < pairs; i++)
+                sum += f(i);
+        })};
+        sink = sink + sum;
+        return t * 1e9 / pairs;
+    };
+
+    std::cout << "Genauigkeit float/double (" << pairs << " Paare, davon die Hälfte unter 10 km):\n" << std::fixed << std::setprecision(1);
+    const auto row = [](const char *name, double tf, double td) {
+        std::cout << "  " << std::left << std::setw(22) << name << std::right << std::setw(6) << tf << " ns float  "
+                  << std::setw(6) << td << " ns double\n";
+    };
+
+    row("calcGCDkm", perCall([&](uint32_t i) { return calcGCDkm(af[i], bf[i]); }), perCall([&](uint32_t i) { return calcGCDkm(ad[i], bd[i]); }));
+    row("calcLoxodromicLength", perCall([&](uint32_t i) { return calcLoxodromicLength(af[i], bf[i]); }),
+        perCall([&](uint32_t i) { return calcLoxodromicLength(ad[i], bd[i]); }));
+    // Nur lange Strecken: bei sehr kurzen wird cos(zeta) in float zu 1 und calcCosAlpha wirft
+    row("calcCrashPointRad", perCall([&](uint32_t i) { return calcCrashPointRad(af[i & ~1u], bf[i & ~1u], 500.0, 1.0, 1000.0).phi; }),
+        perCall([&](uint32_t i) { return calcCrashPointRad(ad[i & ~1u], bd[i & ~1u], 500.0, 1.0, 1000.0).phi; }));
+
+    // Matrixzeilen: float mit SIMD-Kern, double skalar (laneWidth gibt die mögliche Breite an)
+    const auto isa{detectIsa()};
+    std::vector<float> sf(pairs), cf(pairs), slf(pairs), clf(pairs), outf(pairs);
+    std::vector<double> sd(pairs), cd(pairs), sld(pairs), cld(pairs), outd(pairs);
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        sf[i] = bf[i].sinPhi, cf[i] = bf[i].cosPhi, slf[i] = bf[i].sinLambda, clf[i] = bf[i].cosLambda;
+        sd[i] = bd[i].sinPhi, cd[i] = bd[i].cosPhi, sld[i] = bd[i].sinLambda, cld[i] = bd[i].cosLambda;
+    }
+    const auto tRowF{measure([&]() {
+        batch::kernelFor(isa)(af[0].sinPhi, af[0].cosPhi, af[0].sinLambda, af[0].cosLambda, sf.data(), cf.data(), slf.data(), clf.data(), pairs, r_E, outf.data());
+    })};
+    const auto tRowD{measure([&]() {
+        batch::scalar::gcdRow(ad[0].sinPhi, ad[0].cosPhi, ad[0].sinLambda, ad[0].cosLambda, sd.data(), cd.data(), sld.data(), cld.data(), pairs,
+                              earthRadius<double>, outd.data());
+    })};
+    std::cout << "  Matrixzeile           " << std::setw(6) << (tRowF * 1e9 / pairs) << " ns float (" << isaName(isa) << ", "
+              << laneWidth<float>(isa) << " Lanes)  " << std::setw(6) << (tRowD * 1e9 / pairs) << " ns double (Skalar, "
+              << laneWidth<double>(isa) << " Lanes möglich)\n";
+
+    // Maximaler Fehler der Distanz gegen die Referenz, getrennt nach kurzen und langen Strecken:
+    double errF[2]{0, 0}, errD[2]{0, 0};
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        const auto ref{reference(ad[i], bd[i])};
+        errF[i % 2] = std::max(errF[i % 2], std::fabs(calcGCDkm(af[i], bf[i]) - reference(PreparedCoordinateD(af[i].phi, af[i].lambda),
+                                                                                            PreparedCoordinateD(bf[i].phi, bf[i].lambda))));
+        errD[i % 2] = std::max(errD[i % 2], std::fabs(calcGCDkm(ad[i], bd[i]) - ref));
+    }
+    std::cout << std::setprecision(3) << "  max. Fehler calcGCDkm  float: " << (errF[1] * 1e3) << " m kurz, " << (errF[0] * 1e3)
+              << " m lang  double: " << (errD[1] * 1e3) << " m kurz, " << (errD[0] * 1e3) << " m lang\n"
+              << std::defaultfloat << std::endl;
+}
+
+// Loxodromen im Stapel gegen Einzelaufrufe von calcLoxodromicCourse und calcLoxodromicLength:
+void benchLoxodrome(uint32_t legs)
+{
+    std::mt19937 gen{8};
+    std::uniform_real_distribution<float> z{-0.95f, 0.95f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+
+    constexpr uint32_t Count{10000};
+    CoordinateStore store;
+    store.cacheTrig();
+    store.reserve(Count);
+    for (uint32_t i = 0; i < Count; i++)
+        store.add(asinf(z(gen)), az(gen));
+    // Jeder zehnte Punkt auf der Breite seines Vorgängers (Kurs 90 bzw. 270 Grad):
+    for (uint32_t i = 1; i < Count; i += 10)
+        store.add(store.records[i - 1].phi, az(gen));
+    const auto view{store.view()};
+
+    std::uniform_int_distribution<uint32_t> pick{0, static_cast<uint32_t>(view.size() - 1)};
+    std::vector<uint32_t> from(legs), to(legs);
+    for (uint32_t i = 0; i < legs; i++)
+        from[i] = pick(gen), to[i] = pick(gen);
+
+    std::vector<float> course(legs), km(legs), course1(legs), km1(legs);
+    const auto tBulk{measure([&]() { calcLoxodromes(view, from.data(), to.data(), legs, course.data(), km.data()); })};
+    const auto tSingle{measure([&]() {
+        for (uint32_t i = 0; i < legs; i++)
+        {
+            const auto A{view.prepared(from[i])}, B{view.prepared(to[i])};
+            course1[i] = calcLoxodromicCourse(A, B);
+            km1[i] = calcLoxodromicLength(A, B);
+        }
+    })};
+
+    // Breitenkreise: Länge gegen R * cos(phi) * |dlambda| (Referenz in double)
+    double maxParallel{0};
+    size_t parallels{0};
+    for (uint32_t i = Count; i < view.size(); i++)
+    {
+        const auto p{view.prepared(i)}, q{view.prepared((i - Count) * 10)};
+        const auto ref{r_E * std::cos(double{q.phi}) * std::fabs(double{p.lambda} - q.lambda)};
+        maxParallel = std::max(maxParallel, std::fabs(calcLoxodromicLength(q, p) - ref));
+        parallels++;
+    }
+
+    std::cout << "Loxodromen (" << legs << " Strecken):\n" << std::fixed << std::setprecision(1)
+              << "  calcLoxodromes        " << (tBulk * 1e9 / legs) << " ns/Strecke\n"
+              << "  Einzelaufrufe         " << (tSingle * 1e9 / legs) << " ns/Strecke"
+              << ((course == course1) && (km == km1) ? "" : "  ABWEICHUNG!") << '\n'
+              << std::setprecision(3) << "  max. Fehler auf " << parallels << " Breitenkreisen " << (maxParallel * 1e3) << " m\n"
+              << std::defaultfloat << std::endl;
+}
+
+// Messreihe aller Kernfunktionen für die JSON-Ausgabe (--json), je Funktion und Skalartyp ein Eintrag:
+struct SuiteResult
+{
+    std::string name;
+    uint32_t calls;
+    double nsPerCall;
+    double maxError;       // gegen die long-double-Auswertung derselben Funktion bzw. -1 ohne Referenz
+    double meanError;      // ...
+    const char *errorUnit; // rad, km bzw. leer
+};
+
+std::vector<SuiteResult> suite;
+
+// Großkreisabstand zweier Punkte in km (Haversine in long double), Maß für die Abweichung von Punktergebnissen:
+template <class T>
+double pointErrorKm(const BasicPoint<T> &p, const BasicPoint<long double> &ref)
+{
+    const auto dPhi{std::sin((ref.phi - p.phi) / 2)}, dLambda{std::sin((ref.lambda - p.lambda) / 2)};
+    const auto h{dPhi * dPhi + std::cos(ref.phi) * std::cos(static_cast<long double>(p.phi)) * dLambda * dLambda};
+    return static_cast<double>(2 * std::asin(std::sqrt(std::min(1.0L, h))) * earthRadius<long double>);
+}
+
+// Latenz je Aufruf und maximale Abweichung gegen die long-double-Instanz für zufällige Paare:
+template <class T>
+void benchKernels(uint32_t pairs, const char *type)
+{
+    std::mt19937 gen{12};
+    std::uniform_real_distribution<long double> z{-0.95L, 0.95L}, az{-M_PI, M_PI};
+
+    std::vector<BasicPreparedCoordinate<T>> a, b;
+    std::vector<BasicPreparedCoordinate<long double>> ra, rb;
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        const auto phi_a{std::asin(z(gen))}, lambda_a{az(gen)}, phi_b{std::asin(z(gen))}, lambda_b{az(gen)};
+        a.emplace_back(static_cast<T>(phi_a), static_cast<T>(lambda_a));
+        b.emplace_back(static_cast<T>(phi_b), static_cast<T>(lambda_b));
+        // Referenz aus den bereits gerundeten Eingaben, damit nur der Rechenfehler gemessen wird:
+        ra.emplace_back(a.back().phi, a.back().lambda);
+        rb.emplace_back(b.back().phi, b.back().lambda);
+    }
+
+    // f(A, B) liefert T bzw. BasicPoint<T>; error(i, Ergebnis) die Abweichung zur Referenz
+    const auto run = [&](const char *name, const char *unit, auto &&f, auto &&error) {
+        volatile double sink{0};
+        double sum{0};
+        const auto t{measure([&]() {
+            for (uint32_t i = 0; i < pairs; i++)
+            {
+                const auto res{f(a[i], b[i])};
+                if constexpr (std::is_arithmetic<std::decay_t<decltype(res)>>::value)
+                    sum += res;
+                else
+                    sum += res.phi;
+            }
+        })};
+        sink = sink + sum;
+
+        double maxError{0}, sumError{0};
+        for (uint32_t i = 0; i < pairs; i++)
+        {
+            const auto e{error(i, f(a[i], b[i]))};
+            maxError = std::max(maxError, e);
+            sumError += e;
+        }
+
+        suite.push_back(SuiteResult{std::string(name) + '<' + type + '>', pairs, t * 1e9 / pairs, maxError, sumError / pairs, unit});
+    };
+
+    const auto angleError = [](auto &&ref) { return [ref](uint32_t i, T res) { return static_cast<double>(std::fabs(res - ref(i))); }; };
+
+    // v * fuel / k = 3000 km, bei kürzeren Strecken wird ab B zurückgeflogen
+    const auto crash = [](const auto &A, const auto &B) { return calcCrashPointRad(A, B, 600.0, 5.0, 1.0); };
+    const auto peak = [](const auto &A, const auto &B) { return calcNorthPeakPointRad(A, B, calcAlphaRad(A, B)); };
+
+    run("calcGCDrad", "rad", [](const auto &A, const auto &B) { return calcGCDrad(A, B); },
+        angleError([&](uint32_t i) { return calcGCDrad(ra[i], rb[i]); }));
+    run("calcAlphaRad", "rad", [](const auto &A, const auto &B) { return calcAlphaRad(A, B); },
+        angleError([&](uint32_t i) { return calcAlphaRad(ra[i], rb[i]); }));
+    run("calcNorthPeakPoint", "km", peak, [&](uint32_t i, const BasicPoint<T> &p) { return pointErrorKm(p, peak(ra[i], rb[i])); });
+    run("calcLoxodromicCourse", "rad", [](const auto &A, const auto &B) { return calcLoxodromicCourse(A, B); },
+        angleError([&](uint32_t i) { return calcLoxodromicCourse(ra[i], rb[i]); }));
+    run("calcLoxodromicLength", "km", [](const auto &A, const auto &B) { return calcLoxodromicLength(A, B); },
+        angleError([&](uint32_t i) { return calcLoxodromicLength(ra[i], rb[i]); }));
+    run("calcCrashPoint", "km", crash, [&](uint32_t i, const BasicPoint<T> &p) { return pointErrorKm(p, crash(ra[i], rb[i])); });
+}
+
+// Rechenweisen im Vergleich: Laufzeit trig/nvector und Abweichung beider gegen die long-double-Auswertung (trig).
+// Für float zeigt sich der Unterschied der Kondition: acos bei kleinen bzw. fast gegenüberliegenden Winkeln gegen atan2.
+void benchBackend(uint32_t pairs)
+{
+    std::mt19937 gen{14};
+    std::uniform_real_distribution<long double> z{-0.95L, 0.95L}, az{-M_PI, M_PI};
+
+    std::vector<PreparedCoordinate> a, b;
+    std::vector<BasicPreparedCoordinate<long double>> ra, rb;
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        a.emplace_back(static_cast<float>(std::asin(z(gen))), static_cast<float>(az(gen)));
+        b.emplace_back(static_cast<float>(std::asin(z(gen))), static_cast<float>(az(gen)));
+        ra.emplace_back(a.back().phi, a.back().lambda);
+        rb.emplace_back(b.back().phi, b.back().lambda);
+    }
+
+    std::cout << "Rechenweisen (" << pairs << " Paare, float, Abweichung gegen long double):\n";
+    const auto compare = [&](const char *name, const char *unit, auto &&f, auto &&error) {
+        std::cout << "  " << std::left << std::setw(22) << name << std::right;
+        for (const auto backend : {Backend::Trig, Backend::NVector})
+        {
+            volatile float sink{0};
+            float sum{0};
+            const auto t{measure([&]() {
+                for (uint32_t i = 0; i < pairs; i++)
+                    sum += f(a[i], b[i], backend);
+            })};
+            sink = sink + sum;
+
+            double maxError{0};
+            for (uint32_t i = 0; i < pairs; i++)
+                maxError = std::max(maxError, error(i, backend));
+
+            std::cout << std::setw(9) << backendName(backend) << std::fixed << std::setprecision(1) << std::setw(7) << (t * 1e9 / pairs)
+                      << " ns" << std::scientific << std::setprecision(2) << std::setw(11) << maxError << ' ' << unit << std::defaultfloat;
+        }
+        std::cout << '\n';
+    };
+
+    const auto peak = [](const auto &A, const auto &B, Backend backend) { return calcNorthPeakPointRad(A, B, backend); };
+    const auto crash = [](const auto &A, const auto &B, Backend backend) { return calcCrashPointRad(A, B, 600.0, 5.0, 1.0, backend); };
+
+    compare("calcGCDrad", "rad", [](const auto &A, const auto &B, Backend backend) { return calcGCDrad(A, B, backend); },
+            [&](uint32_t i, Backend backend) { return double(std::fabs(calcGCDrad(a[i], b[i], backend) - calcGCDrad(ra[i], rb[i]))); });
+    compare("calcAlphaRad", "rad", [](const auto &A, const auto &B, Backend backend) { return calcAlphaRad(A, B, backend); },
+            [&](uint32_t i, Backend backend) { return double(std::fabs(calcAlphaRad(a[i], b[i], backend) - calcAlphaRad(ra[i], rb[i]))); });
+    compare("calcNorthPeakPoint", "km", [&](const auto &A, const auto &B, Backend backend) { return peak(A, B, backend).phi; },
+            [&](uint32_t i, Backend backend) { return pointErrorKm(peak(a[i], b[i], backend), peak(ra[i], rb[i], Backend::Trig)); });
+    compare("calcCrashPoint", "km", [&](const auto &A, const auto &B, Backend backend) { return crash(A, B, backend).phi; },
+            [&](uint32_t i, Backend backend) { return pointErrorKm(crash(a[i], b[i], backend), crash(ra[i], rb[i], Backend::Trig)); });
+    std::cout << std::endl;
+}
+
+// Näherungen für arccos/atan2: Fehlerschranken über dichte Stichproben prüfen, Screening genähert gegen exakt:
+void benchFastMath(uint32_t count)
+{
+    // Jedes 16. float in [-1; 1] (über das Bitmuster):
+    double maxAcos{0};
+    for (uint32_t bits = 0; bits <= 0x3f800000u; bits += 16)
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        for (const auto v : {x, -x})
+            maxAcos = std::max(maxAcos, std::fabs(double{fastAcos(v)} - std::acos(double{v})));
+    }
+
+    std::mt19937 gen{15};
+    std::uniform_real_distribution<float> any{-10.0f, 10.0f};
+    double maxAtan2{0};
+    for (uint32_t i = 0; i < 10000000; i++)
+    {
+        const auto y{any(gen)}, x{any(gen)};
+        maxAtan2 = std::max(maxAtan2, std::fabs(double{fastAtan2(y, x)} - std::atan2(double{y}, double{x})));
+    }
+
+    // Jedes 16. float in [0; pi], cos über fastSin(pi/2 - x):
+    double maxSin{0};
+    for (uint32_t bits = 0; bits <= 0x40490fdbu; bits += 16)
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        maxSin = std::max(maxSin, std::fabs(double{fastSin(x)} - std::sin(double{x})));
+        maxSin = std::max(maxSin, std::fabs(double{fastSin(-x)} - std::sin(-double{x})));
+        maxSin = std::max(maxSin, std::fabs(double{fastSin(static_cast<float>(M_PI / 2) - x)} - std::cos(double{x})));
+    }
+
+    std::uniform_real_distribution<float> z{-1.0f, 1.0f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+    CoordinateStore store;
+    store.cacheTrig();
+    store.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+        store.add(asinf(z(gen)), az(gen));
+    const auto view{store.view()};
+
+    // Radien um 2000 km, viele Punkte liegen nahe an der Schwelle
+    std::vector<uint32_t> fastHits, exactHits;
+    bool same{true};
+    double tFast{0}, tExact{0};
+    for (int k = 0; k < 20; k++)
+    {
+        const auto q{view.prepared(static_cast<size_t>(k) * (count / 20))};
+        const auto km{1500.0f + 50.0f * k};
+        tFast += measure([&]() { fastHits = screenWithin(view, q, km, Accuracy::Fast); });
+        tExact += measure([&]() { exactHits = screenWithin(view, q, km, Accuracy::Exact); });
+        same = same && (fastHits == exactHits);
+    }
+
+    std::cout << "Näherungen (arccos/atan2/sin):\n" << std::scientific << std::setprecision(2)
+              << "  fastAcos  max. Fehler  " << maxAcos << " rad (Schranke " << FastAcosMaxError << ")\n"
+              << "  fastAtan2 max. Fehler  " << maxAtan2 << " rad (Schranke " << FastAtan2MaxError << ")\n"
+              << "  fastSin   max. Fehler  " << maxSin << " (Schranke " << FastSinMaxError << ")\n"
+              << std::fixed << std::setprecision(2)
+              << "  screenWithin " << count << " Koordinaten: exakt " << (tExact * 1e9 / (20.0 * count)) << " ns, genähert "
+              << (tFast * 1e9 / (20.0 * count)) << " ns je Koordinate" << (same ? "" : "  ABWEICHUNG!") << '\n'
+              << std::defaultfloat << std::endl;
+}
+
+// Korridorprüfung: Positionen gegen Strecken mit Vorauswahl über Kugelkappe/Band gegen vollständige Rechnung aller Paare,
+// Abweichung des Querabstands gegen double:
+void benchGeofence(uint32_t count, uint32_t legCount)
+{
+    std::mt19937 gen{19};
+    std::uniform_real_distribution<float> z{-1.0f, 1.0f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+    CoordinateStore store;
+    store.cacheTrig();
+    store.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+        store.add(asinf(z(gen)), az(gen));
+    const auto view{store.view()};
+
+    // Strecken zwischen zufälligen Positionen (Luftstraßen um 200 bis 3000 km):
+    std::vector<FenceLeg> legs;
+    std::uniform_int_distribution<uint32_t> pick{0, count - 1};
+    while (legs.size() < legCount)
+    {
+        const auto A{view.prepared(pick(gen))}, B{view.prepared(pick(gen))};
+        const auto km{calcGCDkm(A, B)};
+        if ((km > 200.0f) && (km < 3000.0f))
+            legs.emplace_back(A, B);
+    }
+
+    constexpr float Corridor{50.0f};
+    std::vector<FenceHit> hits;
+    const auto tScreen{measure([&]() { hits = checkGeofence(view, legs.data(), legs.size(), Corridor); })};
+
+    // Alle Paare vollständig rechnen:
+    std::vector<FenceHit> all;
+    const auto tAll{measure([&]() {
+        for (uint32_t p = 0; p < count; p++)
+            for (uint32_t l = 0; l < legCount; l++)
+            {
+                const auto track{calcCrossTrack(legs[l], view.prepared(p))};
+                if (track.distance <= Corridor)
+                    all.push_back(FenceHit{p, l, track});
+            }
+    })};
+
+    bool same{hits.size() == all.size()};
+    double maxCross{0};
+    for (size_t i = 0; same && (i < hits.size()); i++)
+    {
+        same = (hits[i].point == all[i].point) && (hits[i].leg == all[i].leg);
+
+        // Referenz in double:
+        const auto &leg{legs[hits[i].leg]};
+        const auto P{PreparedCoordinateD(view.phi[hits[i].point], view.lambda[hits[i].point])};
+        const double a[3]{std::cos(double{view.phi[leg.from]}) * std::cos(double{view.lambda[leg.from]}), std::cos(double{view.phi[leg.from]}) * std::sin(double{view.lambda[leg.from]}), std::sin(double{view.phi[leg.from]})};
+        const double b[3]{std::cos(double{view.phi[leg.to]}) * std::cos(double{view.lambda[leg.to]}), std::cos(double{view.phi[leg.to]}) * std::sin(double{view.lambda[leg.to]}), std::sin(double{view.phi[leg.to]})};
+        double n[3]{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        const auto norm{std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2])};
+        const auto dot{(P.cosPhi * P.cosLambda * n[0] + P.cosPhi * P.sinLambda * n[1] + P.sinPhi * n[2]) / norm};
+        maxCross = std::max(maxCross, std::fabs(std::asin(dot) * earthRadius<double> - hits[i].track.cross));
+    }
+
+    const auto pairs{static_cast<double>(count) * legCount};
+    std::cout << "Korridorprüfung (" << count << " Positionen x " << legCount << " Strecken, " << Corridor << " km):\n"
+              << std::fixed << std::setprecision(2)
+              << "  alle Paare     " << (tAll * 1e9 / pairs) << " ns je Paar\n"
+              << "  Vorauswahl     " << (tScreen * 1e9 / pairs) << " ns je Paar, " << hits.size() << " Treffer" << (same ? "" : "  ABWEICHUNG!") << '\n'
+              << std::scientific << "  Querabstand max. Abweichung " << maxCross << " km (gegen double)\n"
+              << std::defaultfloat << std::endl;
+}
+
+// Strecken auf dem WGS84-Ellipsoid: Stapel im Gleichschritt gegen Einzelpaare, Abweichung der Kugel und Gegenprobe über
+// die direkte Aufgabe (die Hälfte der Paare liegt fast gegenüber):
+void benchEllipsoid(uint32_t count, uint32_t pairs)
+{
+    std::mt19937 gen{23};
+    std::uniform_real_distribution<float> z{-1.0f, 1.0f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)}, jitter{-0.01f, 0.01f};
+    CoordinateStore store;
+    store.cacheTrig();
+    store.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const auto phi{asinf(z(gen))}, lambda{az(gen)};
+        store.add(phi, lambda);
+        if (++i < count) // fast gegenüberliegender Punkt
+            store.add(std::max(-static_cast<float>(M_PI / 2), std::min(static_cast<float>(M_PI / 2), -phi + jitter(gen))),
+                      std::remainder(lambda + static_cast<float>(M_PI) + jitter(gen), static_cast<float>(2 * M_PI)));
+    }
+    const auto view{store.view()};
+
+    std::vector<uint32_t> from(pairs), to(pairs);
+    std::uniform_int_distribution<uint32_t> pick{0, count / 2 - 1};
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        from[i] = 2 * pick(gen);
+        to[i] = (i % 2) ? from[i] + 1 : 2 * pick(gen) + 1;
+    }
+
+    std::vector<float> km(pairs), azimuth(pairs), single(pairs);
+    size_t fallbacks{0};
+    double tTable{0}, tBatch{0};
+    std::unique_ptr<WGS84Table> table;
+    tTable = measure([&]() { table = std::make_unique<WGS84Table>(view); });
+    tBatch = measure([&]() { fallbacks = calcGeodesics(*table, from.data(), to.data(), pairs, km.data(), azimuth.data()); });
+    const auto tSingle{measure([&]() {
+        for (uint32_t i = 0; i < pairs; i++)
+            single[i] = calcGeodesicKm(view.prepared(from[i]), view.prepared(to[i]));
+    })};
+
+    double maxDiff{0}, maxSphere{0}, maxRoundTrip{0};
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        maxDiff = std::max(maxDiff, std::fabs(double{km[i]} - single[i]));
+        if (km[i] > 100.0f) // kurze Strecken: Kugel in float ungenau
+            maxSphere = std::max(maxSphere, std::fabs(calcGCDkm(view.prepared(from[i]), view.prepared(to[i])) / double{km[i]} - 1.0));
+
+        const auto g{wgs84::inverse(view.phi[from[i]], view.lambda[from[i]], view.phi[to[i]], view.lambda[to[i]])};
+        const auto d{wgs84::direct(view.phi[from[i]], view.lambda[from[i]], g.azimuth1, g.km)};
+        const auto dLon{std::remainder(d.lon - double{view.lambda[to[i]]}, 2 * M_PI)};
+        maxRoundTrip = std::max(maxRoundTrip, std::hypot(d.phi - view.phi[to[i]], dLon * std::cos(double{view.phi[to[i]]})) * wgs84::a);
+    }
+
+    std::cout << "WGS84-Strecken (" << pairs << " Paare, davon die Hälfte fast gegenüber):\n"
+              << std::fixed << std::setprecision(2)
+              << "  Tabelle        " << (tTable * 1e9 / count) << " ns je Koordinate\n"
+              << "  Einzelpaare    " << (tSingle * 1e9 / pairs) << " ns je Paar\n"
+              << "  Gleichschritt  " << (tBatch * 1e9 / pairs) << " ns je Paar, " << fallbacks << " im Einschlussverfahren\n"
+              << std::scientific << "  max. Abweichung Stapel/Einzel " << maxDiff << " km\n"
+              << "  max. rel. Abweichung der Kugel (> 100 km) " << maxSphere << '\n'
+              << "  max. Fehler Gegenprobe (direkte Aufgabe) " << maxRoundTrip * 1e3 << " m\n"
+              << std::defaultfloat << std::endl;
+}
+
+// Parameterstudie zum Zwischenpunkt: Gitter nv x nf x nk, je Kombination calcCrashPointRad gegen CrashSweep (exakt,
+// genähert, genähert mit Thread-Pool), Abweichung gegen calcCrashPointRad in double, auf einer allgemeinen Strecke und
+// einem Meridian:
+void benchSweep(uint32_t nv, uint32_t nf, uint32_t nk)
+{
+    SweepAxis v, fuel, k;
+    for (uint32_t i = 0; i < nv; i++)
+        v.values.push_back(400.0f + 600.0f * i / nv);
+    for (uint32_t i = 0; i < nf; i++)
+        fuel.values.push_back(1.0f + 49.0f * i / nf);
+    for (uint32_t i = 0; i < nk; i++)
+        k.values.push_back(0.5f + 4.5f * i / nk);
+    const auto total{static_cast<size_t>(nv) * nf * nk};
+
+    const Coordinate legs[2][2]{{Coordinate(49.79f, 9.95f, "Würzburg", 0), Coordinate(-22.9f, -43.2f, "Rio de Janeiro", 1)},
+                                {Coordinate(60.0f, 25.0f, "Helsinki", 0), Coordinate(-10.0f, 25.0f, "Meridian 25 O", 1)}};
+
+    ThreadPool pool;
+    for (const auto &leg : legs)
+    {
+        const auto A{prepared(leg[0])}, B{prepared(leg[1])};
+        const auto Ad{prepared<double>(leg[0])}, Bd{prepared<double>(leg[1])};
+
+        std::vector<Point> single(total);
+        const auto tSingle{measure([&]() {
+            size_t i{0};
+            for (const auto sv : v.values)
+                for (const auto sf : fuel.values)
+                    for (const auto sk : k.values)
+                        single[i++] = calcCrashPointRad(A, B, sv, sf, sk);
+        })};
+
+        const CrashSweep sweep(A, B);
+        std::vector<SweepPoint> exact(total), fast(total);
+        const auto into = [](std::vector<SweepPoint> &points) {
+            return [&points](const SweepPoint *block, size_t count, size_t first) { std::copy(block, block + count, points.begin() + first); };
+        };
+        const auto tExact{measure([&]() { sweep.sweep(v, fuel, k, into(exact)); })};
+        const auto tFast{measure([&]() { sweep.sweep(v, fuel, k, into(fast), nullptr, Accuracy::Fast); })};
+        const auto tPool{measure([&]() { sweep.sweep(v, fuel, k, into(fast), &pool, Accuracy::Fast); })};
+
+        // Abweichungen in km gegen double:
+        double maxSingle{0}, maxExact{0}, maxFast{0};
+        const auto offset = [](double phi, double lambda, const BasicPoint<double> &ref) {
+            return std::hypot(phi - ref.phi, std::remainder(lambda - ref.lambda, 2 * M_PI) * std::cos(ref.phi)) * earthRadius<double>;
+        };
+        size_t i{0};
+        for (const auto sv : v.values)
+            for (const auto sf : fuel.values)
+                for (const auto sk : k.values)
+                {
+                    const auto ref{calcCrashPointRad(Ad, Bd, double{sv}, double{sf}, double{sk})};
+                    maxSingle = std::max(maxSingle, offset(single[i].phi, single[i].lambda, ref));
+                    maxExact = std::max(maxExact, offset(exact[i].phi, exact[i].lambda, ref));
+                    maxFast = std::max(maxFast, offset(fast[i].phi, fast[i].lambda, ref));
+                    i++;
+                }
+
+        std::cout << "Parameterstudie Zwischenpunkt " << leg[0].name << " - " << leg[1].name << " (" << total << " Kombinationen):\n"
+                  << std::fixed << std::setprecision(2)
+                  << "  calcCrashPoint " << (tSingle * 1e9 / total) << " ns je Kombination\n"
+                  << "  exakt          " << (tExact * 1e9 / total) << " ns je Kombination\n"
+                  << "  genähert       " << (tFast * 1e9 / total) << " ns je Kombination\n"
+                  << "  mit Pool       " << (tPool * 1e9 / total) << " ns je Kombination (" << pool.size() << " Threads)\n"
+                  << std::scientific << "  max. Abweichung gegen double: calcCrashPoint " << maxSingle << " km, exakt " << maxExact
+                  << " km, genähert " << maxFast << " km\n"
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+// Rundreise über zufällige Stopps in Mitteleuropa: Aufbau von Matrix und Kandidaten, Starttour (nächster Nachbar und
+// lokale Suche) und Verbesserung im Zeitbudget, Länge jeweils gegen die Eingabereihenfolge:
+void benchTour(uint32_t count, double seconds)
+{
+    std::mt19937 gen{21};
+    std::uniform_real_distribution<float> phi{deg2rad(40.0f), deg2rad(55.0f)}, lambda{deg2rad(-5.0f), deg2rad(25.0f)};
+    CoordinateStore store;
+    store.cacheTrig();
+    store.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+        store.add(phi(gen), lambda(gen));
+    const auto view{store.view()};
+
+    std::vector<uint32_t> stops(count);
+    double inputKm{0};
+    for (uint32_t i = 0; i < count; i++)
+    {
+        stops[i] = i;
+        inputKm += calcGCDkm(view.prepared(i), view.prepared((i + 1) % count));
+    }
+
+    ThreadPool pool;
+    const auto tBuild{measure([&]() { const tour::Instance inst(view, stops, TourOptions{}.neighbours, &pool); })};
+
+    TourOptions options;
+    options.seconds = seconds;
+    options.reportInterval = seconds; // nur Start und Ende
+    double startKm{0}, finalKm{0};
+    uint64_t kicks{0};
+    const auto tTotal{measure([&]() {
+        optimizeTour(view, stops, options, [&](const TourProgress &p) {
+            (p.final ? finalKm : startKm) = p.km;
+            kicks = p.kicks;
+        }, &pool);
+    })};
+
+    std::cout << "Rundreise " << count << " Stopps (" << pool.size() << " Threads):\n"
+              << std::fixed << std::setprecision(1)
+              << "  Matrix und Kandidaten " << (tBuild * 1e3) << " ms\n"
+              << "  Eingabereihenfolge    " << inputKm << " km\n"
+              << "  Starttour             " << startKm << " km (" << (tTotal - seconds) * 1e3 << " ms inkl. Aufbau)\n"
+              << "  nach Zeitbudget       " << finalKm << " km (" << seconds << " s, " << (100.0 * (startKm - finalKm) / startKm) << " % kürzer, "
+              << static_cast<uint64_t>(kicks / seconds) << " Störungen/s)\n"
+              << std::defaultfloat << std::endl;
+}
+
+// Neuladen der Textdatei: vollständiges Einlesen gegen angehängte bzw. eine geänderte Zeile in der Mitte:
+void benchReload(uint32_t lines)
+{
+    writeInputFile(BenchFile, lines);
+    std::unique_ptr<Catalog> catalog;
+    const auto tLoad{measure([&catalog]() { catalog = std::make_unique<Catalog>(BenchFile, 4096); })};
+
+    ReloadReport append, modify;
+    {
+        std::ofstream file(BenchFile, std::ios::app);
+        for (uint32_t i = 0; i < 100; i++)
+            file << "12 34 56 N, 65 43 21 O, Nachtrag " << i << '\n';
+    }
+    const auto tAppend{measure([&]() { catalog->reload(&append, true); })};
+
+    // Zeile in der Mitte ersetzen (gleiche Länge, die Änderungszeit allein reicht nicht):
+    {
+        std::fstream file(BenchFile, std::ios::in | std::ios::out);
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const auto at{text.find("Wegpunkt " + std::to_string(lines / 2) + '\n')};
+        file.seekp(static_cast<std::streamoff>(at));
+        file << "Wegpunkt X";
+    }
+    const auto tModify{measure([&]() { catalog->reload(&modify, true); })};
+    std::remove(BenchFile);
+
+    std::cout << "Neuladen " << lines << " Zeilen:\n"
+              << std::fixed << std::setprecision(1)
+              << "  vollständig        " << (tLoad * 1e3) << " ms\n"
+              << "  100 angehängt      " << (tAppend * 1e3) << " ms (" << append.parsed << " Zeilen zerlegt, Stand " << append.generation
+              << (append.appended ? ", nur neue Zeilen gelesen" : "") << ")\n"
+              << "  1 geändert (Mitte) " << (tModify * 1e3) << " ms (" << modify.parsed << " Zeilen zerlegt, Index "
+              << (modify.indexKept ? "übernommen" : "neu") << ")\n"
+              << std::defaultfloat << std::endl;
+}
+
+// Stapelfunktionen der Bibliothek gegen Einzelaufrufe von query::evaluate (wie die Konsole, mit Exceptions):
+void benchLibrary(uint32_t pairs)
+{
+    std::mt19937 gen{12};
+    std::uniform_real_distribution<float> z{-0.95f, 0.95f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+
+    std::vector<Point> a(pairs), b(pairs);
+    for (uint32_t i = 0; i < pairs; i++)
+        a[i] = Point{asinf(z(gen)), az(gen)}, b[i] = Point{asinf(z(gen)), az(gen)};
+    b[0] = a[0]; // ein unbestimmter Kurswinkel
+
+    std::vector<float> km(pairs), rad(pairs), km1(pairs), rad1(pairs);
+    const auto tDistances{measure([&]() { trig::distances(a, b, km); })};
+    trig::Status status{};
+    const auto tCourses{measure([&]() { status = trig::courses(a, b, rad); })};
+
+    uint32_t errors{0};
+    const auto tSingle{measure([&]() {
+        for (uint32_t i = 0; i < pairs; i++)
+        {
+            const PreparedCoordinate A{a[i].phi, a[i].lambda}, B{b[i].phi, b[i].lambda};
+            km1[i] = query::evaluate(4, A, B, nullptr).value;
+            try
+            {
+                rad1[i] = deg2rad(query::evaluate(2, A, B, nullptr).value);
+            }
+            catch (const std::exception &)
+            {
+                rad1[i] = std::numeric_limits<float>::quiet_NaN();
+                errors++;
+            }
+        }
+    })};
+
+    double maxDiff{0};
+    for (uint32_t i = 0; i < pairs; i++)
+        if (!std::isnan(rad[i]))
+            maxDiff = std::max({maxDiff, double{std::fabs(km[i] - km1[i])}, double{std::fabs(rad[i] - rad1[i])}});
+
+    std::cout << "Bibliothek (" << pairs << " Paare, Strecke und Kurswinkel):\n" << std::fixed << std::setprecision(1)
+              << "  trig::distances         " << (tDistances * 1e9 / pairs) << " ns/Paar\n"
+              << "  trig::courses           " << (tCourses * 1e9 / pairs) << " ns/Paar ("
+              << ((status == trig::Status::Undefined) && std::isnan(rad[0]) ? "unbestimmt als NaN" : "FEHLER") << ")\n"
+              << "  query::evaluate (4, 2)  " << (tSingle * 1e9 / pairs) << " ns/Paar, beide Befehle (" << errors << " Exception)\n"
+              << std::setprecision(6) << "  max. Abweichung         " << maxDiff << '\n'
+              << std::defaultfloat << std::endl;
+}
+
+// Verbindet sich mit dem Server des Benchmarks (Unix-Socket):
+int connectBenchServer(void)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, BenchSocket);
+    const auto fd{::socket(AF_UNIX, SOCK_STREAM, 0)};
+    if ((fd < 0) || (::connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0))
+        throw std::runtime_error("Verbindung zum Server nicht möglich!");
+    return fd;
+}
+
+// Liest bis bytes Byte angekommen sind (Antworten werden verworfen):
+void receiveAll(int fd, size_t bytes)
+{
+    char chunk[1 << 16];
+    for (size_t got = 0; got < bytes;)
+    {
+        const auto n{::recv(fd, chunk, std::min(sizeof(chunk), bytes - got), 0)};
+        if (n <= 0)
+            throw std::runtime_error("Verbindung zum Server unterbrochen!");
+        got += static_cast<size_t>(n);
+    }
+}
+
+// Abfrageserver über Unix-Socket: Einzelanfragen (Umlaufzeit), Binäranfragen ohne Warten auf Antworten auf einer bzw.
+// mehreren Verbindungen (Durchsatz, Stapeltiefe):
+void benchServer(uint32_t requests)
+{
+    std::mt19937 gen{14};
+    std::uniform_real_distribution<float> z{-0.95f, 0.95f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+
+    constexpr uint32_t Count{1000};
+    CoordinateStore store;
+    store.cacheTrig();
+    for (uint32_t i = 0; i < Count; i++)
+        store.add(asinf(z(gen)), az(gen), "Wegpunkt " + std::to_string(i));
+    const Catalog catalog(store.view(), 0);
+
+    std::uniform_int_distribution<uint32_t> pick{0, Count - 1}, cmd{1, 6};
+    std::vector<query::BinaryRequest> binary(requests);
+    for (auto &r : binary)
+    {
+        r = query::BinaryRequest{static_cast<uint8_t>(cmd(gen)), {}, pick(gen), pick(gen), {}};
+        r.to = (r.to == r.from) ? (r.from + 1) % Count : r.to;
+    }
+
+    QueryServer server(BenchSocket);
+    ThreadPool pool;
+    std::thread thread([&]() { server.run(catalog, pool, QueryServer::Options{OutputFormat::Text, Backend::Trig, Earth::Sphere, false}); });
+
+    // Umlaufzeit einzelner Textanfragen (Antwort: eine Zeile und Leerzeile):
+    constexpr uint32_t RoundTrips{20000};
+    double tRoundTrip{0};
+    {
+        const auto fd{connectBenchServer()};
+        const std::string line{"4 #1 #2\n"};
+        char reply[256];
+        tRoundTrip = measure([&]() {
+            for (uint32_t i = 0; i < RoundTrips; i++)
+            {
+                (void)!::send(fd, line.data(), line.size(), 0);
+                for (size_t got = 0; (got < 2) || (reply[got - 2] != '\n') || (reply[got - 1] != '\n');)
+                {
+                    const auto n{::recv(fd, reply + got, sizeof(reply) - got, 0)};
+                    if (n <= 0)
+                        throw std::runtime_error("Verbindung zum Server unterbrochen!");
+                    got += static_cast<size_t>(n);
+                }
+            }
+        });
+        ::close(fd);
+    }
+
+    // Binäranfragen ohne Warten, verteilt auf clients Verbindungen (Senden und Empfangen je Verbindung parallel):
+    const auto pipelined = [&](uint32_t clients) {
+        std::vector<std::thread> threads;
+        const auto per{requests / clients};
+        return measure([&]() {
+            for (uint32_t c = 0; c < clients; c++)
+                threads.emplace_back([&, c]() {
+                    const auto fd{connectBenchServer()};
+                    std::thread sender([&]() {
+                        (void)!::send(fd, "TRGB", 4, 0);
+                        (void)!::send(fd, binary.data() + c * per, per * sizeof(query::BinaryRequest), 0);
+                    });
+                    receiveAll(fd, sizeof(BinaryHeader) + per * sizeof(query::BinaryRecord));
+                    sender.join();
+                    ::close(fd);
+                });
+            for (auto &t : threads)
+                t.join();
+        }) / (per * clients);
+    };
+    const auto tSingle{pipelined(1)};
+    const auto tMulti{pipelined(8)};
+
+    server.stop();
+    thread.join();
+
+    std::cout << "Abfrageserver (Unix-Socket, " << pool.size() << " Threads):\n" << std::fixed << std::setprecision(1)
+              << "  Umlaufzeit Einzelanfrage   " << (tRoundTrip * 1e6 / RoundTrips) << " µs (Text, " << RoundTrips << " nacheinander)\n"
+              << "  Binär ohne Warten          " << (tSingle * 1e9) << " ns/Anfrage (" << requests << " auf 1 Verbindung)\n"
+              << "  Binär ohne Warten          " << (tMulti * 1e9) << " ns/Anfrage (" << requests << " auf 8 Verbindungen)\n"
+              << "  ";
+    server.report(std::cout);
+    std::cout << std::defaultfloat << std::endl;
+}
+
+// Einlesen einer Textdatei in den Koordinatenspeicher (ohne Referenzwert):
+void benchIngest(uint32_t lines)
+{
+    writeInputFile(BenchFile, lines);
+    CoordinateStore store;
+    store.cacheTrig();
+    const auto t{measure([&store]() { loadCoordinateFile(BenchFile, store); })};
+    std::remove(BenchFile);
+
+    suite.push_back(SuiteResult{"loadCoordinateFile", static_cast<uint32_t>(store.size()), t * 1e9 / store.size(), -1, -1, ""});
+}
+
+// Ausgabe eines Ergebnisses wie in der Konsole (Strecke und Zwischenpunkt), iostream gegen OutputBuffer:
+void benchOutput(uint32_t count)
+{
+    std::mt19937 gen{17};
+    std::uniform_real_distribution<float> km{1.0f, 20000.0f}, el{-90.0f, 90.0f}, az{-180.0f, 180.0f};
+    std::vector<float> value(count), phi(count), lambda(count);
+    for (uint32_t i = 0; i < count; i++)
+        value[i] = km(gen), phi[i] = el(gen), lambda[i] = az(gen);
+
+    // bisherige Ausgabe über iostream (setprecision/setw), Inhalt wie Coordinate::print ohne Farben:
+    std::ostringstream stream;
+    const auto tStream{measure([&]() {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const AngleEl p{phi[i]};
+            const AngleAz l{lambda[i]};
+            stream << "Strecke auf Großkreis von Würzburg nach Peking:\t" << std::setprecision(5) << value[i] << " km\n";
+            stream << '\0' << ".) Zwischenpunkt\n\t\u03A6: " << std::setw(3) << p.angle << "° " << std::setw(2) << uint16_t{p.min} << "' "
+                   << std::setw(2) << uint16_t{p.sec} << "'' " << ((p.dir == directionEl::N) ? 'N' : 'S') << "\t\u03BB: " << std::setw(3) << l.angle
+                   << "° " << std::setw(2) << uint16_t{l.min} << "' " << std::setw(2) << uint16_t{l.sec} << "'' " << ((l.dir == directionAz::W) ? 'W' : 'O')
+                   << "\n\n";
+        }
+    })};
+
+    OutputBuffer buffer(nullptr, 0);
+    const auto tBuffer{measure([&]() {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            buffer << "Strecke auf Großkreis von Würzburg nach Peking:\t";
+            buffer.number(value[i], 5) << " km\n";
+            Coordinate(phi[i], lambda[i], "Zwischenpunkt", 0).print(buffer);
+        }
+    })};
+
+    const auto text{buffer.take()};
+    if (text != stream.str())
+        std::cout << "Ausgabe OutputBuffer weicht von iostream ab!\n";
+
+    suite.push_back(SuiteResult{"Ausgabe (iostream)", count, tStream * 1e9 / count, -1, -1, ""});
+    suite.push_back(SuiteResult{"Ausgabe (OutputBuffer)", count, tBuffer * 1e9 / count, -1, -1, ""});
+}
+
+// Befehlsschleife im Stapelmodus: Befehle 1 bis 7 mit zufälligen IDs, Textausgabe nach /dev/null:
+void benchCommandLoop(uint32_t commands)
+{
+    std::mt19937 gen{13};
+    std::uniform_real_distribution<float> z{-0.95f, 0.95f}, az{-static_cast<float>(M_PI), static_cast<float>(M_PI)};
+
+    constexpr uint32_t Count{1000};
+    CoordinateStore store;
+    store.cacheTrig();
+    for (uint32_t i = 0; i < Count; i++)
+        store.add(asinf(z(gen)), az(gen), "Wegpunkt " + std::to_string(i));
+    const CoordinateRegistry registry(store.view());
+
+    std::uniform_int_distribution<uint32_t> pick{0, Count - 1}, cmd{1, 7};
+    {
+        std::ofstream file(BenchCommands);
+        for (uint32_t i = 0; i < commands; i++)
+        {
+            const auto c{cmd(gen)};
+            file << c << " #" << pick(gen) << " #" << pick(gen) << ((c == 7) ? " 600 5 1\n" : "\n");
+        }
+    }
+
+    const std::unique_ptr<std::FILE, int (*)(std::FILE *)> in(std::fopen(BenchCommands, "rb"), std::fclose);
+    const std::unique_ptr<std::FILE, int (*)(std::FILE *)> out(std::fopen("/dev/null", "wb"), std::fclose);
+    if (!in || !out)
+        throw std::runtime_error("Befehlsdatei kann nicht geöffnet werden!");
+
+    const auto t{measure([&]() { runBatch(registry, in.get(), out.get(), OutputFormat::Text); })};
+    suite.push_back(SuiteResult{"runBatch", commands, t * 1e9 / commands, -1, -1, ""});
+
+    // Wiederholte Abfragen weniger Paare (typischer Disponenten-Verkehr), ohne und mit Ergebnis-Cache:
+    constexpr uint32_t Pairs{300};
+    uint32_t pairs[Pairs][3];
+    for (auto &p : pairs)
+        p[0] = cmd(gen), p[1] = pick(gen), p[2] = pick(gen);
+    {
+        std::ofstream file(BenchCommands);
+        for (uint32_t i = 0; i < commands; i++)
+        {
+            const auto &p{pairs[pick(gen) % Pairs]};
+            file << p[0] << " #" << p[1] << " #" << p[2] << ((p[0] == 7) ? " 600 5 1\n" : "\n");
+        }
+    }
+
+    query::Cache cache(4096);
+    for (const auto cached : {false, true})
+    {
+        const std::unique_ptr<std::FILE, int (*)(std::FILE *)> repeated(std::fopen(BenchCommands, "rb"), std::fclose);
+        if (!repeated)
+            throw std::runtime_error("Befehlsdatei kann nicht geöffnet werden!");
+
+        const auto tr{measure([&]() { runBatch(registry, repeated.get(), out.get(), OutputFormat::Text, nullptr, Backend::Trig, cached ? &cache : nullptr); })};
+        suite.push_back(SuiteResult{cached ? "runBatch 300 Paare (Cache)" : "runBatch 300 Paare", commands, tr * 1e9 / commands, -1, -1, ""});
+    }
+    std::remove(BenchCommands);
+    std::cout << "Ergebnis-Cache: Trefferquote " << std::fixed << std::setprecision(1) << cache.hitRate() * 100.0 << " %\n";
+}
+
+void printSuite(void)
+{
+    std::cout << "Kernfunktionen (mittlere/maximale Abweichung gegen long double):\n";
+    for (const auto &r : suite)
+    {
+        std::cout << "  " << std::left << std::setw(30) << r.name << std::right << std::fixed << std::setprecision(1) << std::setw(9)
+                  << r.nsPerCall << " ns" << std::setprecision(0) << std::setw(14) << (1e9 / r.nsPerCall) << " Aufrufe/s";
+        if (r.maxError >= 0)
+            std::cout << std::scientific << std::setprecision(2) << std::setw(11) << r.meanError << std::setw(11) << r.maxError << ' ' << r.errorUnit;
+        std::cout << std::defaultfloat << '\n';
+    }
+    std::cout << std::endl;
+}
+
+// Schreibt die Messreihe als JSON (zum Vergleich zweier Builds):
+void writeSuiteJson(const char *filename)
+{
+    std::ofstream file(filename);
+    file << "{\"isa\":\"" << isaName(detectIsa()) << "\",\"results\":[";
+    for (size_t i = 0; i < suite.size(); i++)
+    {
+        const auto &r{suite[i]};
+        file << (i ? ",\n" : "\n") << "{\"name\":\"" << r.name << "\",\"calls\":" << r.calls << ",\"ns_per_op\":" << std::setprecision(6)
+             << r.nsPerCall << ",\"ops_per_s\":" << std::setprecision(9) << (1e9 / r.nsPerCall);
+        if (r.maxError >= 0)
+            file << ",\"mean_error\":" << std::setprecision(6) << r.meanError << ",\"max_error\":" << r.maxError << ",\"error_unit\":\""
+                 << r.errorUnit << '"';
+        file << '}';
+    }
+    file << "\n]}\n";
+}
+
+int main(int argc, char *argv[])
+{
+    // Aufruf: ./bench [Anzahl Zeilen] [--suite] [--json <Datei>]
+    uint32_t lines{1000000};
+    bool onlySuite{false};
+    const char *json{nullptr};
+    for (int a = 1; a < argc; a++)
+    {
+        const std::string arg{argv[a]};
+        if (arg == "--suite")
+            onlySuite = true;
+        else if ((arg == "--json") && (a + 1 < argc))
+            json = argv[++a];
+        else
+            lines = static_cast<uint32_t>(std::stoul(arg));
+    }
+
+    if (!onlySuite)
+    {
+        benchParser(lines);
+        benchRegistry(lines);
+
+        for (const uint32_t count : {10000u, 100000u, 1000000u})
+            benchSpatial(count);
+
+        benchExecutor(8000);
+        benchRoute(1000000);
+        benchPrecision(1000000);
+        benchLoxodrome(1000000);
+        benchBackend(200000);
+        benchFastMath(1000000);
+        benchGeofence(100000, 200);
+        benchEllipsoid(200000, 200000);
+        benchSweep(100, 100, 100);
+        for (const uint32_t count : {200u, 1000u, 5000u})
+            benchTour(count, 1.0);
+        benchReload(lines);
+        benchLibrary(1000000);
+        benchServer(1000000);
+    }
+
+    benchKernels<float>(200000, "float");
+    benchKernels<double>(200000, "double");
+    benchIngest(lines);
+    benchOutput(200000);
+    benchCommandLoop(200000);
+    printSuite();
+
+    if (json)
+        writeSuiteJson(json);
+}
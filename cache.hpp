@@ -0,0 +1,224 @@
+// Begrenzter Ergebnis-Cache (LRU) für wiederholte Abfragen desselben Koordinatenpaars
+//
+// Schlüssel ist (Befehl, ID A, ID B, Parameter, Rechenweise). Die Einträge liegen in einem Feld fester Größe und sind
+// über Indizes doppelt verkettet (vorne = zuletzt benutzt); die Hashtabelle bildet den Schlüssel auf den Index ab.
+// Ist der Cache voll, wird der am längsten nicht benutzte Eintrag überschrieben. Alle Zugriffe sind über einen Mutex
+// geschützt, damit der parallele Stapelmodus einen gemeinsamen Cache nutzen kann; die Trefferstatistik ist atomar und kann
+// ohne Mutex gelesen werden. Plätze sind 32-Bit-Indizes, die Größe ist daher auf MaxCacheCapacity begrenzt.
+//
+// IDs sind nur innerhalb eines Koordinatensatzes eindeutig: nach dem Neuladen der Koordinaten muss invalidate()
+// aufgerufen bzw. der Inhalt mit adopt() auf die neuen IDs umgeschrieben werden.
+#pragma once
+
+/// Standardbibliotheken
+#include <atomic>        // std::atomic
+#include <charconv>      // std::from_chars
+#include <cstddef>       // size_t
+#include <cstdint>       // int-Typen
+#include <cstring>       // std::memcmp, std::memcpy
+#include <mutex>         // std::mutex
+#include <stdexcept>     // std::invalid_argument, std::length_error
+#include <string>        // std::string
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+// Schlüssel einer Abfrage, bitweise verglichen (Parameter nicht benötigter Stellen müssen 0 sein):
+struct QueryKey
+{
+    int32_t cmd;
+    uint32_t a, b;
+    float params[3];
+    uint32_t backend;
+
+    bool operator==(const QueryKey &other) const noexcept
+    {
+        return std::memcmp(this, &other, sizeof(QueryKey)) == 0;
+    }
+};
+static_assert(sizeof(QueryKey) == 28, "QueryKey darf keine Füllbytes enthalten (bitweiser Vergleich)");
+
+// Hash über die 32-Bit-Wörter des Schlüssels (Multiplikation und Verschiebung je Wort):
+struct QueryKeyHash
+{
+    size_t operator()(const QueryKey &key) const noexcept
+    {
+        uint32_t words[sizeof(QueryKey) / 4];
+        std::memcpy(words, &key, sizeof(QueryKey));
+
+        uint64_t h{0};
+        for (const auto w : words)
+            h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+constexpr size_t MaxCacheCapacity{UINT32_MAX - 1}; // Plätze sind 32-Bit-Indizes, UINT32_MAX ist als None reserviert
+
+template <class Value>
+class ResultCache
+{
+public:
+    // capacity = 0: Cache ausgeschaltet (find liefert immer false, insert speichert nichts)
+    explicit ResultCache(size_t capacity = 4096)
+    {
+        resize(capacity);
+    }
+
+    // Sucht einen Eintrag und markiert ihn als zuletzt benutzt:
+    bool find(const QueryKey &key, Value &value)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        const auto it{index.find(key)};
+        if (it == index.end())
+        {
+            misses++;
+            return false;
+        }
+
+        hits++;
+        moveToFront(it->second);
+        value = entries[it->second].value;
+        return true;
+    }
+
+    void insert(const QueryKey &key, const Value &value)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (entries.empty() || (index.find(key) != index.end()))
+            return;
+
+        uint32_t slot;
+        if (used < entries.size())
+            slot = used++;
+        else
+        {
+            slot = tail; // am längsten nicht benutzt
+            unlink(slot);
+            index.erase(entries[slot].key);
+        }
+
+        entries[slot].key = key;
+        entries[slot].value = value;
+        pushFront(slot);
+        index.emplace(key, slot);
+    }
+
+    // Verwirft alle Einträge (z.B. nach dem Neuladen der Koordinaten), die Statistik bleibt erhalten:
+    void invalidate(void)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        index.clear();
+        used = 0;
+        head = tail = None;
+    }
+
+    // Übernimmt die Einträge eines anderen Caches (z.B. des vorherigen Koordinatensatzes) in LRU-Reihenfolge samt
+    // Statistik. remap(QueryKey &) passt den Schlüssel an (neue IDs) und liefert false für verworfene Einträge.
+    template <class F>
+    void adopt(ResultCache &other, F &&remap)
+    {
+        std::vector<Entry> kept;
+        {
+            const std::lock_guard<std::mutex> lock(other.mutex);
+            kept.reserve(other.used);
+            for (auto slot = other.tail; slot != None; slot = other.entries[slot].prev) // älteste zuerst
+            {
+                auto entry{other.entries[slot]};
+                if (remap(entry.key))
+                    kept.push_back(entry);
+            }
+            hits += other.hits.load(std::memory_order_relaxed);
+            misses += other.misses.load(std::memory_order_relaxed);
+        }
+
+        for (const auto &entry : kept)
+            insert(entry.key, entry.value);
+    }
+
+    // Ändert die Größe, dabei werden alle Einträge verworfen. Wirft std::length_error über MaxCacheCapacity:
+    void resize(size_t capacity)
+    {
+        if (capacity > MaxCacheCapacity)
+            throw std::length_error("Cache ist auf " + std::to_string(MaxCacheCapacity) + " Einträge begrenzt!");
+        const std::lock_guard<std::mutex> lock(mutex);
+        entries.assign(capacity, Entry{});
+        index.clear();
+        index.reserve(capacity);
+        used = 0;
+        head = tail = None;
+    }
+
+    size_t capacity(void) const noexcept
+    {
+        return entries.size();
+    }
+
+    uint64_t hitCount(void) const noexcept
+    {
+        return hits.load(std::memory_order_relaxed);
+    }
+
+    uint64_t missCount(void) const noexcept
+    {
+        return misses.load(std::memory_order_relaxed);
+    }
+
+    // Trefferquote in [0; 1]:
+    double hitRate(void) const noexcept
+    {
+        const auto h{hitCount()}, total{h + missCount()};
+        return total ? static_cast<double>(h) / total : 0.0;
+    }
+
+private:
+    static constexpr uint32_t None{UINT32_MAX};
+
+    struct Entry
+    {
+        QueryKey key;
+        Value value;
+        uint32_t prev{None}, next{None};
+    };
+
+    std::vector<Entry> entries;
+    std::unordered_map<QueryKey, uint32_t, QueryKeyHash> index;
+    uint32_t used{0};
+    uint32_t head{None}, tail{None};
+    std::atomic<uint64_t> hits{0}, misses{0}; // werden unter mutex erhöht, ohne gelesen
+    std::mutex mutex;
+
+    void unlink(uint32_t slot) noexcept
+    {
+        auto &e{entries[slot]};
+        (e.prev != None ? entries[e.prev].next : head) = e.next;
+        (e.next != None ? entries[e.next].prev : tail) = e.prev;
+        e.prev = e.next = None;
+    }
+
+    void pushFront(uint32_t slot) noexcept
+    {
+        auto &e{entries[slot]};
+        e.prev = None;
+        e.next = head;
+        (head != None ? entries[head].prev : tail) = slot;
+        head = slot;
+    }
+
+    void moveToFront(uint32_t slot) noexcept
+    {
+        if (slot == head)
+            return;
+        unlink(slot);
+        pushFront(slot);
+    }
+};
+
+// Cache-Größe aus der Befehlszeile (--cache), nur Ziffern bis MaxCacheCapacity:
+inline size_t toCacheSize(const std::string &text)
+{
+    uint64_t value{0};
+    const auto res{std::from_chars(text.data(), text.data() + text.size(), value)};
+    if ((res.ec != std::errc{}) || (res.ptr != text.data() + text.size()) || (value > MaxCacheCapacity))
+        throw std::invalid_argument("Cache-Größe muss zwischen 0 und " + std::to_string(MaxCacheCapacity) + " liegen: " + text);
+    return static_cast<size_t>(value);
+}
@@ -0,0 +1,640 @@
+// Koordinatensatz mit Neuladen der Eingabedatei im laufenden Betrieb
+//
+// Abfragen holen sich zu Beginn mit current() einen Stand (CatalogSnapshot) und arbeiten bis zum Ende darauf. Ein neuer
+// Stand wird daneben aufgebaut und dann atomar getauscht (std::atomic_store auf den shared_ptr); laufende
+// Abfragen werden dabei weder blockiert noch gestört, der alte Stand lebt, bis die letzte Abfrage ihn freigibt.
+//
+// Neuladen (reload):
+//   - Nur angehängte Zeilen (gleiche Datei, gewachsen, Anfang und bisheriges Ende unverändert, siehe appendedOnly):
+//     gelesen, gehasht und zerlegt werden nur die neuen Zeilen. Ihre Koordinaten kommen hinter die des bisherigen
+//     Stands in denselben Speicher, solange dessen Reserve reicht (laufende Abfragen lesen nur ihre ersten Datensätze),
+//     das Verzeichnis erhält eine Ebene für die neuen Bezeichner. Cache-Einträge bleiben vollständig erhalten.
+//   - Sonst wird die Datei blockweise gelesen, je Zeile ein Hashwert gebildet und der Text aufbewahrt. Gleiche Zeilen
+//     (Hashwert und Text) am Anfang und am Ende gegenüber dem letzten Stand werden übernommen, nur der Bereich
+//     dazwischen wird zerlegt. Unveränderte Koordinaten werden als Datensätze samt vorberechneten Winkelfunktionen
+//     kopiert.
+//   - IDs vor dem geänderten Bereich bleiben, IDs dahinter verschieben sich um die Differenz der Koordinaten.
+//   - Abgeleitete Daten: Cache-Einträge unveränderter Koordinaten werden mit den neuen IDs übernommen, nur Einträge
+//     geänderter Koordinaten entfallen. Der räumliche Index wird weitergegeben, wenn sich keine Position geändert hat
+//     (z.B. nur Bezeichner), sonst beim ersten Suchbefehl neu aufgebaut. Ändert der Bereich keine Koordinate
+//     (Kommentare, Leerzeilen), bleibt der Stand erhalten.
+//   - Fehlerhafte Zeilen im geänderten Bereich: der bisherige Stand bleibt, der Fehler wird gemeldet. Dabei angelegte
+//     Bezeichner werden aus der Arena entfernt.
+//   - Ersetzte Bezeichner bleiben in der gemeinsamen Arena, bis mehr als die Hälfte ihrer Einträge nicht mehr verwendet
+//     wird; dann erhält der neue Stand eine neu aufgebaute Arena (--watch wächst so nicht unbegrenzt).
+// Änderungen erkennt watch() per inotify (Linux) sofort und zusätzlich über Größe und Änderungszeit im Abstand interval
+// (z.B. für Netzlaufwerke, sonst ausschließlich so).
+#pragma once
+
+/// Standardbibliotheken
+#include <atomic>      // std::atomic_load, std::atomic_store
+#include <chrono>      // std::chrono::milliseconds
+#include <cstdint>     // int-Typen
+#include <cstdio>      // std::fopen
+#include <cstring>     // std::memcpy
+#include <functional>  // std::function
+#include <memory>      // std::shared_ptr
+#include <mutex>       // std::mutex, std::call_once
+#include <stdexcept>   // std::runtime_error
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <thread>      // std::thread
+#include <vector>      // std::vector
+
+#include <poll.h>     // poll
+#include <sys/stat.h> // stat
+#include <unistd.h>   // pipe, read, write, close
+#ifdef __linux__
+#include <sys/inotify.h> // inotify_init1
+#endif
+
+/// Eigene Header
+#include "store.hpp"    // CoordinateStore, CoordinateView
+#include "parser.hpp"   // forEachLine, parser::parseLine
+#include "registry.hpp" // CoordinateRegistry
+#include "spatial.hpp"  // SpatialIndex
+#include "query.hpp"    // query::Cache
+
+// Geänderter Bereich gegenüber dem vorherigen Stand: die Koordinaten [first; end) wurden durch [first; end + delta)
+// ersetzt, IDs ab end verschieben sich um delta.
+struct CatalogChange
+{
+    size_t first, end;
+    int64_t delta;
+    bool positionsKept; // gleiche Anzahl und Positionen im Bereich (z.B. nur Bezeichner geändert)
+};
+
+// Ein Stand des Koordinatensatzes mit allen davon abgeleiteten Daten. Unveränderlich bis auf Cache und räumlichen
+// Index (beide threadsicher):
+struct CatalogSnapshot
+{
+    // Speicher der Sicht, nullptr wenn sie auf fremde Spalten zeigt (eingeblendete Datenbank). Nach angehängten Zeilen
+    // teilen sich Vorgänger und Nachfolger den Speicher, der Vorgänger sieht nur seine ersten view.size() Datensätze.
+    const std::shared_ptr<CoordinateStore> store;
+    const CoordinateView view;
+    const std::shared_ptr<const CoordinateRegistry> registryLayers; // besitzt registry, Ebenen siehe registry.hpp
+    const CoordinateRegistry &registry;
+    mutable query::Cache cache; // Kapazität 0: aus
+    const uint64_t generation;  // 0 = erster Stand
+
+    CatalogSnapshot(CoordinateStore &&_store, size_t cacheSize)
+        : store(std::make_shared<CoordinateStore>(std::move(_store))), view(store->view()), registryLayers(std::make_shared<const CoordinateRegistry>(view)),
+          registry(*registryLayers), cache(cacheSize), generation(0) {}
+
+    // Fremde Sicht, diese muss den Stand überleben:
+    CatalogSnapshot(const CoordinateView &_view, size_t cacheSize)
+        : view(_view), registryLayers(std::make_shared<const CoordinateRegistry>(view)), registry(*registryLayers), cache(cacheSize), generation(0) {}
+
+    // Nachfolger von previous: Verzeichnis und Cache werden nur im geänderten Bereich angepasst, der räumliche Index
+    // bei unveränderten Positionen übernommen.
+    CatalogSnapshot(CoordinateStore &&_store, size_t cacheSize, const CatalogSnapshot &previous, const CatalogChange &change)
+        : store(std::make_shared<CoordinateStore>(std::move(_store))), view(store->view()),
+          registryLayers(std::make_shared<const CoordinateRegistry>(view, previous.registry, change.first, change.end, change.delta)),
+          registry(*registryLayers), cache(cacheSize), generation(previous.generation + 1),
+          spatial(change.positionsKept ? previous.builtIndex() : nullptr)
+    {
+        // Cache-Einträge unveränderter Koordinaten mit neuen IDs übernehmen:
+        const auto remap = [&change](uint32_t &id) {
+            if (id < change.first)
+                return true;
+            if (id < change.end)
+                return false;
+            id = static_cast<uint32_t>(id + change.delta);
+            return true;
+        };
+        cache.adopt(previous.cache, [&remap](QueryKey &key) { return remap(key.a) && remap(key.b); });
+    }
+
+    // Nachfolger von previous mit angehängten Koordinaten, _store enthält previous.view als Anfang (derselbe oder ein
+    // umgelagerter Speicher): das Verzeichnis erhält eine Ebene für die neuen Koordinaten, der Cache wird vollständig
+    // übernommen (IDs bleiben), der räumliche Index beim ersten Suchbefehl neu aufgebaut.
+    CatalogSnapshot(std::shared_ptr<CoordinateStore> _store, size_t cacheSize, const CatalogSnapshot &previous)
+        : store(std::move(_store)), view(store->view()), registryLayers(std::make_shared<const CoordinateRegistry>(view, previous.registryLayers)),
+          registry(*registryLayers), cache(cacheSize), generation(previous.generation + 1)
+    {
+        cache.adopt(previous.cache, [](QueryKey &) { return true; });
+    }
+
+    // Räumlicher Index, beim ersten Aufruf aufgebaut:
+    const SpatialIndex &index(void) const
+    {
+        std::call_once(indexBuilt, [this]() {
+            if (!std::atomic_load(&spatial))
+                std::atomic_store(&spatial, std::make_shared<const SpatialIndex>(view));
+        });
+        return *spatial;
+    }
+
+    // Bereits aufgebauter Index (sonst nullptr), zur Weitergabe an den nächsten Stand:
+    std::shared_ptr<const SpatialIndex> builtIndex(void) const noexcept
+    {
+        return std::atomic_load(&spatial);
+    }
+
+private:
+    mutable std::once_flag indexBuilt;
+    mutable std::shared_ptr<const SpatialIndex> spatial;
+};
+
+// Ergebnis eines Neuladens:
+struct ReloadReport
+{
+    uint64_t generation{0};    // Stand danach
+    uint32_t parsed{0};        // zerlegte Zeilen
+    size_t added{0};           // Koordinaten im geänderten Bereich, neu
+    size_t removed{0};         // ... bisher
+    size_t count{0};           // Koordinaten insgesamt
+    bool indexKept{false};     // räumlicher Index übernommen
+    bool appended{false};      // nur angehängte Zeilen gelesen (bisherige weder gelesen noch gehasht)
+    bool poolRebuilt{false};   // Arena ohne nicht mehr verwendete Bezeichner neu aufgebaut
+    double ms{0};              // Dauer des Neuladens
+    const char *error{nullptr}; // nur während des Callbacks gültig, der bisherige Stand bleibt
+    uint32_t line{0};          // Zeile des Fehlers (0: kein Zerlegungsfehler)
+};
+
+class Catalog
+{
+public:
+    // Fester Koordinatensatz ohne Neuladen, die Sicht muss den Katalog überleben:
+    Catalog(const CoordinateView &view, size_t _cacheSize) : cacheSize(_cacheSize), snapshot(std::make_shared<const CatalogSnapshot>(view, _cacheSize)) {}
+
+    // Liest die Textdatei vollständig ein und merkt sich die Zeilen für das Neuladen. Wirft ParseError bzw.
+    // std::runtime_error wie loadCoordinateFile. trigCache: Winkelfunktionen in jedem Stand vorberechnen (cacheTrig).
+    Catalog(std::string _filename, size_t _cacheSize, bool _trigCache = true) : filename(std::move(_filename)), cacheSize(_cacheSize), trigCache(_trigCache)
+    {
+        reload();
+    }
+
+    Catalog(const Catalog &) = delete;
+    Catalog &operator=(const Catalog &) = delete;
+
+    ~Catalog()
+    {
+        unwatch();
+    }
+
+    // Aktueller Stand, für die Dauer einer Abfrage festhalten:
+    std::shared_ptr<const CatalogSnapshot> current(void) const noexcept
+    {
+        return std::atomic_load(&snapshot);
+    }
+
+    // Lädt geänderte Zeilen nach, falls sich Größe oder Änderungszeit der Datei geändert haben (force: immer prüfen,
+    // Änderungszeiten sind nur so fein wie der Zeitgeber des Kernels). Liefert true, wenn ein neuer Stand übernommen
+    // wurde. Wirft ParseError bei fehlerhaften Zeilen (der bisherige Stand bleibt).
+    bool reload(ReloadReport *report = nullptr, bool force = false)
+    {
+        const std::lock_guard<std::mutex> lock(reloading);
+        if (filename.empty())
+            return false;
+
+        struct stat st;
+        if (::stat(filename.c_str(), &st) != 0)
+        {
+            if (!snapshot)
+                throw std::runtime_error("Input-Datei ist fehlerhaft bzw. existiert nicht.");
+            return false; // z.B. beim Ersetzen kurzzeitig nicht vorhanden
+        }
+
+        const FileStamp now{st.st_ino, st.st_size, st.st_mtim.tv_sec, st.st_mtim.tv_nsec};
+        if (snapshot && !force && (now == stamp))
+            return false;
+        stamp = now; // fehlerhafter Stand wird erst nach der nächsten Änderung erneut gelesen
+
+        const auto start{std::chrono::steady_clock::now()};
+        const std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::fopen(filename.c_str(), "rb"), std::fclose};
+        if (!file)
+            throw std::runtime_error("Input-Datei ist fehlerhaft bzw. existiert nicht.");
+
+        // Kennzeichen der tatsächlich geöffneten Datei (kann inzwischen ersetzt worden sein):
+        struct stat opened;
+        if (::fstat(::fileno(file.get()), &opened) != 0)
+            opened = st;
+
+        const auto old{current()};
+        if (old && appendedOnly(file.get(), opened))
+            return reloadAppended(file.get(), *old, start, report);
+        std::rewind(file.get());
+
+        // Zeilen hashen und aufbewahren; gleich ist eine Zeile bei gleichem Hashwert und gleichem Text (kein stiller
+        // Fehler bei Kollisionen), der gleiche Anfang steht nach dem Lesen fest:
+        const auto oldLines{hashes.size()};
+        std::vector<uint64_t> lines;
+        std::string content;      // Text aller Zeilen
+        std::vector<size_t> ends; // Ende je Zeile in content
+        lines.reserve(oldLines);
+        ends.reserve(oldLines);
+        content.reserve(text.size());
+        size_t prefix{0};
+        bool diverged{false};
+
+        forEachLine(file.get(), [&](const char *begin, const char *end, uint32_t line) {
+            const auto h{hashLine(begin, end)};
+            lines.push_back(h);
+            content.append(begin, end);
+            ends.push_back(content.size());
+            if (!diverged && old && (line <= oldLines) && (hashes[line - 1] == h) &&
+                (lineAt(text, lineEnds, line - 1) == std::string_view(begin, static_cast<size_t>(end - begin))))
+                prefix = line;
+            else
+                diverged = true;
+        });
+        const auto bytes{static_cast<uint64_t>(::ftello(file.get()))};
+
+        // Gleiches Ende, ohne mit dem Anfang zu überlappen:
+        const auto newLines{lines.size()};
+        size_t suffix{0};
+        if (old)
+            while ((suffix < newLines - prefix) && (suffix < oldLines - prefix) && (lines[newLines - 1 - suffix] == hashes[oldLines - 1 - suffix]) &&
+                   (lineAt(content, ends, newLines - 1 - suffix) == lineAt(text, lineEnds, oldLines - 1 - suffix)))
+                suffix++;
+
+        // Geänderten Bereich zerlegen, in die gemeinsame Arena. Bei einem Fehler werden die dabei angelegten Bezeichner
+        // wieder entfernt, sonst wüchse die Arena mit jedem fehlerhaften Speichern:
+        const auto parsedLines{newLines - prefix - suffix};
+        CoordinateStore changed{old ? old->store->strings : std::make_shared<StringPool>()};
+        std::vector<uint32_t> changedBefore{0}; // Koordinaten vor jeder Zeile des Bereichs (relativ)
+        const auto mark{changed.strings->mark()};
+        changed.cacheTrig(trigCache);
+        try
+        {
+            ParsedCoordinate record;
+            for (size_t i = prefix; i < prefix + parsedLines; i++)
+            {
+                const auto line{lineAt(content, ends, i)};
+                if (parser::parseLine(line.data(), line.data() + line.size(), static_cast<uint32_t>(i + 1), record))
+                    addParsedCoordinate(changed, record);
+                changedBefore.push_back(static_cast<uint32_t>(changed.size()));
+            }
+        }
+        catch (...)
+        {
+            changed.strings->rollback(mark);
+            throw;
+        }
+
+        // Koordinaten des Bereichs [first; end) im bisherigen Stand, delta = Differenz der Anzahl:
+        const auto oldView{old ? old->view : CoordinateView{}};
+        const size_t first{old ? before[prefix] : 0}, end{old ? before[oldLines - suffix] : 0};
+        const auto count{changed.size()};
+        const auto delta{static_cast<int64_t>(count) - static_cast<int64_t>(end - first)};
+
+        // Zeilentabellen fortschreiben:
+        std::vector<uint32_t> positions(newLines + 1);
+        if (old)
+            std::copy(before.begin(), before.begin() + prefix + 1, positions.begin());
+        for (size_t i = 1; i <= parsedLines; i++)
+            positions[prefix + i] = static_cast<uint32_t>(first + changedBefore[i]);
+        for (size_t i = 1; i <= suffix; i++)
+            positions[newLines - suffix + i] = static_cast<uint32_t>(before[oldLines - suffix + i] + delta);
+        hashes = std::move(lines);
+        before = std::move(positions);
+        loaded = Loaded{opened.st_ino, bytes, content.size() + newLines == bytes};
+        text = std::move(content);
+        lineEnds = std::move(ends);
+
+        ReloadReport result;
+        result.parsed = static_cast<uint32_t>(parsedLines);
+        result.added = count;
+        result.removed = end - first;
+
+        // Gleiche Koordinaten (Positionen bzw. zusätzlich Bezeichner und Kennung) im geänderten Bereich:
+        const auto same = [&](bool names) {
+            if (count != end - first)
+                return false;
+            const auto view{changed.view()};
+            for (size_t i = 0; i < count; i++)
+                if ((view.phi[i] != oldView.phi[first + i]) || (view.lambda[i] != oldView.lambda[first + i]) ||
+                    (names && ((view.name(i) != oldView.name(first + i)) || (view.code(i) != oldView.code(first + i)))))
+                    return false;
+            return true;
+        };
+
+        if (old && same(true))
+        {
+            result.generation = old->generation;
+            result.count = oldView.size();
+            result.indexKept = true;
+            if (report)
+                *report = result;
+            return false;
+        }
+
+        std::shared_ptr<const CatalogSnapshot> next;
+        if (!old)
+            next = std::make_shared<const CatalogSnapshot>(std::move(changed), cacheSize);
+        else
+        {
+            CoordinateStore store(old->store->strings); // unveränderte Bezeichner werden nicht kopiert
+            store.cacheTrig(trigCache);
+            store.reserve(oldView.size() - (end - first) + count);
+            store.append(oldView, 0, first);
+            store.append(changed.view(), 0, count);
+            store.append(oldView, end, oldView.size() - end);
+
+            // Ersetzte Bezeichner bleiben in der Arena, bis höchstens die Hälfte ihrer Einträge noch verwendet wird (je
+            // Koordinate höchstens zwei), dann Neuaufbau mit den verwendeten:
+            size_t refs{0};
+            for (const auto &r : store.records)
+                refs += (r.name != StringPool::Empty) + (r.code != StringPool::Empty);
+            if (store.strings->size() > 2 * refs)
+            {
+                CoordinateStore compact;
+                compact.cacheTrig(trigCache);
+                compact.reserve(store.size());
+                compact.append(store.view(), 0, store.size());
+                store = std::move(compact);
+                result.poolRebuilt = true;
+            }
+
+            result.indexKept = same(false);
+            next = std::make_shared<const CatalogSnapshot>(std::move(store), cacheSize, *old, CatalogChange{first, end, delta, result.indexKept});
+        }
+
+        std::atomic_store(&snapshot, next);
+
+        result.generation = next->generation;
+        result.count = next->view.size();
+        result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (report)
+            *report = result;
+        return true;
+    }
+
+    // Überwacht die Datei in einem eigenen Thread und lädt Änderungen nach. onReload wird im Überwachungsthread nach
+    // jedem neuen Stand bzw. Fehler aufgerufen.
+    void watch(std::function<void(const ReloadReport &)> onReload, std::chrono::milliseconds interval = std::chrono::milliseconds{500})
+    {
+        unwatch();
+        if (filename.empty())
+            return;
+        if (::pipe(wake) != 0)
+            throw std::runtime_error("Überwachung der Input-Datei kann nicht gestartet werden!");
+
+        watcher = std::thread([this, onReload = std::move(onReload), interval]() {
+            int notify{-1};
+            const auto slash{filename.rfind('/')};
+            const std::string_view name{(slash == std::string::npos) ? std::string_view{filename} : std::string_view{filename}.substr(slash + 1)};
+#ifdef __linux__
+            // Verzeichnis überwachen, damit auch Ersetzen per Umbenennen (Editoren) erkannt wird:
+            const auto directory{(slash == std::string::npos) ? std::string{"."} : filename.substr(0, slash + 1)};
+            notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if ((notify >= 0) && (inotify_add_watch(notify, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE) < 0))
+            {
+                ::close(notify);
+                notify = -1;
+            }
+#endif
+            // Liest alle anstehenden Ereignisse, liefert true, wenn eines die Datei betrifft:
+            const auto drain = [notify, name]() {
+                bool hit{false};
+#ifdef __linux__
+                alignas(inotify_event) char events[4096];
+                ssize_t n;
+                while ((n = ::read(notify, events, sizeof(events))) > 0)
+                    for (auto p = events; p < events + n; p += sizeof(inotify_event) + reinterpret_cast<const inotify_event *>(p)->len)
+                    {
+                        const auto *event{reinterpret_cast<const inotify_event *>(p)};
+                        hit |= (event->len > 0) && (std::string_view{event->name} == name);
+                    }
+#endif
+                return hit;
+            };
+
+            while (true)
+            {
+                pollfd fds[2]{{wake[0], POLLIN, 0}, {notify, POLLIN, 0}};
+                const auto ready{::poll(fds, (notify >= 0) ? 2 : 1, static_cast<int>(interval.count()))};
+                if ((ready > 0) && (fds[0].revents & POLLIN))
+                    break;
+
+                // Ereignisse sammeln, bis die Datei kurz ruhig ist (Schreiben in mehreren Schritten):
+                bool touched{false};
+                if ((ready > 0) && (fds[1].revents & POLLIN))
+                {
+                    constexpr int Quiet{50}; // ms
+                    touched = drain();
+                    for (auto waited = 0; (waited < interval.count()) && (::poll(&fds[1], 1, Quiet) > 0); waited += Quiet)
+                        touched |= drain();
+                }
+
+                ReloadReport report;
+                try
+                {
+                    if (reload(&report, touched))
+                        onReload(report);
+                }
+                catch (const ParseError &ex)
+                {
+                    report.error = ex.what();
+                    report.line = ex.line;
+                    onReload(report);
+                }
+                catch (const std::exception &ex)
+                {
+                    report.error = ex.what();
+                    onReload(report);
+                }
+            }
+
+            if (notify >= 0)
+                ::close(notify);
+        });
+    }
+
+    // Beendet die Überwachung:
+    void unwatch(void)
+    {
+        if (!watcher.joinable())
+            return;
+        const char stop{0};
+        (void)!::write(wake[1], &stop, 1);
+        watcher.join();
+        ::close(wake[0]);
+        ::close(wake[1]);
+    }
+
+private:
+    // Kennzeichen eines Dateistands:
+    struct FileStamp
+    {
+        ino_t inode{0};
+        off_t size{0};
+        time_t sec{0};
+        long nsec{0};
+
+        bool operator==(const FileStamp &other) const noexcept
+        {
+            return (inode == other.inode) && (size == other.size) && (sec == other.sec) && (nsec == other.nsec);
+        }
+    };
+
+    const std::string filename; // leer: fester Koordinatensatz
+    const size_t cacheSize;
+    const bool trigCache{true}; // Winkelfunktionen in jedem Stand vorberechnen
+    std::shared_ptr<const CatalogSnapshot> snapshot; // nur über std::atomic_load/std::atomic_store
+
+    // Nur unter reloading:
+    std::mutex reloading;
+    FileStamp stamp;
+    std::vector<uint64_t> hashes; // je Zeile der Datei
+    std::vector<uint32_t> before; // Koordinaten vor jeder Zeile (Zeilen + 1 Einträge)
+    std::string text;              // Text aller Zeilen (Vergleich bei gleichem Hashwert)
+    std::vector<size_t> lineEnds;  // Ende je Zeile in text
+
+    // Zuletzt übernommener Dateistand (Grundlage für angehängte Zeilen):
+    struct Loaded
+    {
+        ino_t inode{0};
+        uint64_t size{0};        // gelesene Byte
+        bool terminated{false};  // letzte Zeile mit Zeilenumbruch abgeschlossen
+    } loaded;
+
+    std::thread watcher;
+    int wake[2]{-1, -1}; // Pipe zum Beenden des Überwachungsthreads
+
+    static constexpr size_t EdgeCheck{4096}; // Byte am Anfang und am bisherigen Ende, die bei angehängten Zeilen verglichen werden
+
+    // Wurden seit dem letzten Stand nur Zeilen angehängt? Gleiche Datei (Inode), gewachsen, letzte Zeile war
+    // abgeschlossen, und die ersten und letzten Zeilen (je mindestens EdgeCheck Byte) stehen unverändert an ihrer Stelle;
+    // der Rest wird wie bei Werkzeugen zum Verfolgen von Protokolldateien nicht gelesen. Eine Änderung nur dazwischen bei
+    // gleicher Länge und gleichzeitigem Anhängen bleibt so unerkannt (Ersetzen der Datei bzw. Kürzen werden erkannt).
+    // Danach steht file am bisherigen Dateiende, sonst ist die Position unbestimmt.
+    bool appendedOnly(std::FILE *file, const struct stat &st) const
+    {
+        if (hashes.empty() || !loaded.terminated || (st.st_ino != loaded.inode) || (static_cast<uint64_t>(st.st_size) <= loaded.size))
+            return false;
+
+        // Zeilen [first; end) wie in der Datei, mit Zeilenumbrüchen:
+        const auto raw = [this](size_t first, size_t end) {
+            std::string lines;
+            for (auto i = first; i < end; i++)
+                lines.append(lineAt(text, lineEnds, i)).push_back('\n');
+            return lines;
+        };
+        const auto matches = [file](uint64_t offset, const std::string &expected) {
+            std::string actual(expected.size(), '\0');
+            return (::fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0) &&
+                   (std::fread(&actual[0], 1, actual.size(), file) == actual.size()) && (actual == expected);
+        };
+
+        size_t headLines{0}, headLength{0}, tailLines{hashes.size()}, tailLength{0};
+        while ((headLines < hashes.size()) && (headLength < EdgeCheck))
+            headLength += lineAt(text, lineEnds, headLines++).size() + 1;
+        while ((tailLines > 0) && (tailLength < EdgeCheck))
+            tailLength += lineAt(text, lineEnds, --tailLines).size() + 1;
+
+        return (tailLength <= loaded.size) && matches(0, raw(0, headLines)) && matches(loaded.size - tailLength, raw(tailLines, hashes.size()));
+    }
+
+    // Zerlegt nur die angehängten Zeilen (file steht am bisherigen Ende) und hängt ihre Koordinaten an den Speicher des
+    // bisherigen Stands an. Solange dessen Reserve reicht, wird dabei nichts kopiert; sonst wird er mit doppelter
+    // Kapazität umgelagert (amortisiert O(1) je Koordinate).
+    bool reloadAppended(std::FILE *file, const CatalogSnapshot &old, std::chrono::steady_clock::time_point start, ReloadReport *report)
+    {
+        const auto oldLines{hashes.size()};
+        std::vector<uint64_t> lines;
+        std::string content;
+        std::vector<size_t> ends;
+        forEachLine(
+            file,
+            [&](const char *begin, const char *end, uint32_t) {
+                lines.push_back(hashLine(begin, end));
+                content.append(begin, end);
+                ends.push_back(content.size());
+            },
+            [oldLines](uint32_t line) { throw ParseError(static_cast<uint32_t>(oldLines + line), "Zeile zu lang!"); });
+        const auto bytes{static_cast<uint64_t>(::ftello(file)) - loaded.size};
+
+        CoordinateStore changed{old.store->strings};
+        changed.cacheTrig(trigCache);
+        std::vector<uint32_t> positions; // Koordinaten vor jeder neuen Zeile (ab der zweiten) bzw. am Ende
+        const auto mark{changed.strings->mark()};
+        try
+        {
+            ParsedCoordinate record;
+            for (size_t i = 0; i < lines.size(); i++)
+            {
+                const auto line{lineAt(content, ends, i)};
+                if (parser::parseLine(line.data(), line.data() + line.size(), static_cast<uint32_t>(oldLines + i + 1), record))
+                    addParsedCoordinate(changed, record);
+                positions.push_back(static_cast<uint32_t>(before.back() + changed.size()));
+            }
+        }
+        catch (...)
+        {
+            changed.strings->rollback(mark);
+            throw;
+        }
+
+        // Zeilentabellen fortschreiben:
+        hashes.insert(hashes.end(), lines.begin(), lines.end());
+        before.insert(before.end(), positions.begin(), positions.end());
+        for (const auto e : ends)
+            lineEnds.push_back(text.size() + e);
+        text += content;
+        loaded.size += bytes;
+        loaded.terminated = content.size() + lines.size() == bytes;
+
+        ReloadReport result;
+        result.parsed = static_cast<uint32_t>(lines.size());
+        result.added = changed.size();
+        result.appended = true;
+
+        if (changed.size() == 0) // nur Kommentare bzw. Leerzeilen
+        {
+            result.generation = old.generation;
+            result.count = old.view.size();
+            result.indexKept = true;
+            if (report)
+                *report = result;
+            return false;
+        }
+
+        auto store{old.store};
+        if ((store->size() != old.view.size()) || (store->spare() < changed.size()))
+        {
+            auto grown{std::make_shared<CoordinateStore>(store->strings)};
+            grown->cacheTrig(trigCache);
+            grown->reserve(2 * (old.view.size() + changed.size()));
+            grown->append(old.view, 0, old.view.size());
+            store = std::move(grown);
+        }
+        store->append(changed.view(), 0, changed.size()); // hinter dem Ende des bisherigen Stands, den niemand liest
+
+        const auto next{std::make_shared<const CatalogSnapshot>(std::move(store), cacheSize, old)};
+        std::atomic_store(&snapshot, next);
+
+        result.generation = next->generation;
+        result.count = next->view.size();
+        result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (report)
+            *report = result;
+        return true;
+    }
+
+    // Zeile i aus aufbewahrtem Text:
+    static std::string_view lineAt(const std::string &content, const std::vector<size_t> &ends, size_t i) noexcept
+    {
+        const auto begin{i ? ends[i - 1] : 0};
+        return std::string_view(content.data() + begin, ends[i] - begin);
+    }
+
+    // Hashwert einer Zeile, je 8 Byte ein Schritt (Multiplikation und Verschiebung):
+    static uint64_t hashLine(const char *begin, const char *end) noexcept
+    {
+        constexpr uint64_t K{0x9E3779B97F4A7C15ull};
+        auto h{static_cast<uint64_t>(end - begin) * K};
+        uint64_t word;
+        for (; end - begin >= 8; begin += 8)
+        {
+            std::memcpy(&word, begin, 8);
+            h = (h ^ word) * K;
+            h ^= h >> 29;
+        }
+        word = 0;
+        std::memcpy(&word, begin, static_cast<size_t>(end - begin));
+        h = (h ^ word) * K;
+        return h ^ (h >> 32);
+    }
+};
@@ -0,0 +1,327 @@
+// Binäre Koordinatendatenbank, wird per mmap eingeblendet
+//
+// Aufbau (alle Werte in Byte-Reihenfolge des erzeugenden Rechners, Spalten auf 64 Byte ausgerichtet):
+//   DatabaseHeader
+//   phi[count], lambda[count]                                   Bogenmaß, float oder double (Flag DbDouble)
+//   sinPhi, cosPhi, sinLambda, cosLambda, sigma je [count]      optional (Flag DbTrig), gleicher Typ wie phi
+//   nameOffsets[count + 1]                                      uint32_t, Bezeichner i in [nameOffsets[i]; nameOffsets[i + 1])
+//   names                                                       Bezeichner hintereinander, ohne Nullterminierung
+//   codeOffsets[count + 1], codes                               Kennungen wie Bezeichner (ab Version 2)
+//
+// Liegt die Datei in float mit Winkelfunktionen vor, zeigt die CoordinateView direkt in die eingeblendete Datei
+// (kein Zerlegen, keine Allokation). Sonst werden nur die fehlenden Spalten einmalig berechnet.
+#pragma once
+
+/// Standardbibliotheken
+#include <cstdint>   // int-Typen
+#include <cstdio>    // std::FILE
+#include <cstring>   // std::memcmp
+#include <memory>    // std::unique_ptr
+#include <stdexcept> // std::runtime_error, std::length_error
+#include <string_view> // std::string_view
+#include <vector>    // std::vector
+
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+/// Eigene Header
+#include "store.hpp" // CoordinateStore, CoordinateView
+
+constexpr char DbMagic[8]{'S', 'P', 'H', 'T', 'R', 'I', 'G', '\0'};
+constexpr uint32_t DbEndian{0x01020304}; // erkennt fremde Byte-Reihenfolge
+constexpr uint16_t DbVersion{2}; // Version 1 (ohne Kennungen) wird weiterhin gelesen
+
+// Flags im Header:
+enum DbFlags : uint16_t
+{
+    DbDouble = 1 << 0, // Winkelspalten als double statt float
+    DbTrig = 1 << 1    // vorberechnete Winkelfunktionen enthalten
+};
+
+struct DatabaseHeader
+{
+    char magic[8];
+    uint32_t endian;
+    uint16_t version;
+    uint16_t flags;
+    uint64_t count;           // Anzahl Koordinaten
+    uint64_t phiOffset;       // Byte-Offsets ab Dateianfang
+    uint64_t lambdaOffset;
+    uint64_t trigOffset;      // 0, wenn nicht vorhanden
+    uint64_t nameIndexOffset;
+    uint64_t nameDataOffset;
+    uint64_t nameDataSize;
+    uint64_t fileSize;        // zur Erkennung abgeschnittener Dateien
+    uint64_t codeIndexOffset; // ab Version 2
+    uint64_t codeDataOffset;
+    uint64_t codeDataSize;
+};
+
+// Schreibt die Koordinaten als Binärdatenbank:
+inline void writeDatabase(const CoordinateView &coords, const char *filename, bool withTrig = true, bool doublePrecision = false)
+{
+    const auto n{coords.size()};
+    const size_t elem{doublePrecision ? sizeof(double) : sizeof(float)};
+
+    // Bezeichner und Kennungen hintereinander mit Versatztabelle (aus der Arena bzw. direkt aus der Sicht):
+    std::vector<uint32_t> nameOffsets, codeOffsets;
+    std::vector<char> names, codes;
+    const auto flatten = [n](auto &&text, std::vector<uint32_t> &offsets, std::vector<char> &chars) {
+        offsets.reserve(n + 1);
+        offsets.push_back(0);
+        for (size_t i = 0; i < n; i++)
+        {
+            const std::string_view str{text(i)};
+            if (chars.size() + str.size() > UINT32_MAX)
+                throw std::length_error("Bezeichner überschreiten 4 GiB!");
+            chars.insert(chars.end(), str.begin(), str.end());
+            offsets.push_back(static_cast<uint32_t>(chars.size()));
+        }
+    };
+    flatten([&coords](size_t i) { return coords.name(i); }, nameOffsets, names);
+    flatten([&coords](size_t i) { return coords.code(i); }, codeOffsets, codes);
+    const auto align = [](uint64_t offset) -> uint64_t { return (offset + 63) & ~uint64_t{63}; };
+
+    DatabaseHeader header{};
+    std::memcpy(header.magic, DbMagic, sizeof(DbMagic));
+    header.endian = DbEndian;
+    header.version = DbVersion;
+    header.flags = static_cast<uint16_t>((doublePrecision ? DbDouble : 0) | (withTrig ? DbTrig : 0));
+    header.count = n;
+    header.phiOffset = align(sizeof(DatabaseHeader));
+    header.lambdaOffset = align(header.phiOffset + n * elem);
+    header.trigOffset = withTrig ? align(header.lambdaOffset + n * elem) : 0;
+    header.nameIndexOffset = align((withTrig ? header.trigOffset + 5 * n * elem : header.lambdaOffset + n * elem));
+    header.nameDataOffset = header.nameIndexOffset + (n + 1) * sizeof(uint32_t);
+    header.nameDataSize = nameOffsets[n];
+    header.codeIndexOffset = align(header.nameDataOffset + header.nameDataSize);
+    header.codeDataOffset = header.codeIndexOffset + (n + 1) * sizeof(uint32_t);
+    header.codeDataSize = codeOffsets[n];
+    header.fileSize = header.codeDataOffset + header.codeDataSize;
+
+    const std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::fopen(filename, "wb"), std::fclose};
+    if (!file)
+        throw std::runtime_error("Datenbank kann nicht geschrieben werden!");
+
+    uint64_t pos{0};
+    const auto write = [&file, &pos](const void *data, size_t size) {
+        if (std::fwrite(data, 1, size, file.get()) != size)
+            throw std::runtime_error("Schreibfehler in Datenbank!");
+        pos += size;
+    };
+    const auto pad = [&write, &pos](uint64_t offset) {
+        static const char zeros[64]{};
+        write(zeros, offset - pos);
+    };
+    const auto column = [&write, &pad, n, doublePrecision](uint64_t offset, FloatColumn data) {
+        pad(offset);
+        if (!doublePrecision && (data.stride == 1))
+            return write(data.data, n * sizeof(float));
+
+        // Felder eines Koordinatenspeichers bzw. Umwandlung in double als Spalte sammeln:
+        const auto gather = [&write, n, &data](auto zero) {
+            std::vector<decltype(zero)> col(n);
+            for (size_t i = 0; i < n; i++)
+                col[i] = data[i];
+            write(col.data(), n * sizeof(zero));
+        };
+        if (doublePrecision)
+            return gather(0.0);
+        gather(0.0f);
+    };
+
+    write(&header, sizeof(header));
+    column(header.phiOffset, coords.phi);
+    column(header.lambdaOffset, coords.lambda);
+    if (withTrig)
+    {
+        TrigColumns derived; // Winkelfunktionen aus phi/lambda, falls die Sicht keine mitbringt
+        const auto source{::withTrig(coords, derived)};
+        const float *trig[]{source.sinPhi, source.cosPhi, source.sinLambda, source.cosLambda, source.sigma};
+        for (size_t c = 0; c < 5; c++)
+            column(header.trigOffset + c * n * elem, trig[c]);
+    }
+    pad(header.nameIndexOffset);
+    write(nameOffsets.data(), (n + 1) * sizeof(uint32_t));
+    write(names.data(), header.nameDataSize);
+    pad(header.codeIndexOffset);
+    write(codeOffsets.data(), (n + 1) * sizeof(uint32_t));
+    write(codes.data(), header.codeDataSize);
+}
+
+// Eingeblendete Binärdatenbank:
+class Database
+{
+public:
+    explicit Database(const char *filename)
+    {
+        const int fd{::open(filename, O_RDONLY)};
+        if (fd < 0)
+            throw std::runtime_error("Datenbank ist fehlerhaft bzw. existiert nicht.");
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(DatabaseHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("Datenbank ist zu kurz!");
+        }
+
+        size = static_cast<size_t>(st.st_size);
+        data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // Einblendung bleibt auch nach close bestehen
+
+        if (data == MAP_FAILED)
+            throw std::runtime_error("Datenbank kann nicht eingeblendet werden!");
+
+        try
+        {
+            open();
+        }
+        catch (...)
+        {
+            ::munmap(data, size);
+            throw;
+        }
+    }
+
+    ~Database()
+    {
+        ::munmap(data, size);
+    }
+
+    Database(const Database &) = delete;
+    Database &operator=(const Database &) = delete;
+
+    const DatabaseHeader &header(void) const noexcept
+    {
+        return *static_cast<const DatabaseHeader *>(data);
+    }
+
+    // Sicht auf die Koordinaten, bleibt gültig solange das Database-Objekt existiert:
+    const CoordinateView &view(void) const noexcept
+    {
+        return coords;
+    }
+
+    // true, wenn die Spalten ohne Umwandlung direkt aus der Datei stammen:
+    bool zeroCopy(void) const noexcept
+    {
+        return converted.size() == 0;
+    }
+
+private:
+    void *data{nullptr};
+    size_t size{0};
+    CoordinateView coords;
+    CoordinateStore converted; // nur belegt, wenn Spalten umgewandelt bzw. berechnet werden mussten
+
+    const char *at(uint64_t offset) const noexcept
+    {
+        return static_cast<const char *>(data) + offset;
+    }
+
+    // Abschnitt aus count Elementen zu elem Byte ab offset: liegt vollständig in der Datei und ist auf elem ausgerichtet
+    // (Prüfung ohne Überlauf, auch bei beliebigen Werten im Header):
+    bool fits(uint64_t offset, uint64_t count, uint64_t elem) const noexcept
+    {
+        return (offset <= size) && ((offset % elem) == 0) && (count <= (size - offset) / elem);
+    }
+
+    // Versatztabelle mit count + 1 Einträgen: beginnt bei 0, fällt nie und endet bei dataSize:
+    static bool monotonic(const uint32_t *offsets, size_t count, uint64_t dataSize) noexcept
+    {
+        if (offsets[0] != 0)
+            return false;
+        for (size_t i = 0; i < count; i++)
+            if (offsets[i + 1] < offsets[i])
+                return false;
+        return offsets[count] == dataSize;
+    }
+
+    // Header prüfen und Sicht aufbauen:
+    void open(void)
+    {
+        const auto &h{header()};
+
+        if (std::memcmp(h.magic, DbMagic, sizeof(DbMagic)) != 0)
+            throw std::runtime_error("Keine Koordinatendatenbank!");
+        if (h.endian != DbEndian)
+            throw std::runtime_error("Datenbank hat fremde Byte-Reihenfolge!");
+        if ((h.version != 1) && (h.version != DbVersion))
+            throw std::runtime_error("Nicht unterstützte Datenbankversion!");
+        if (h.fileSize != size)
+            throw std::runtime_error("Datenbank ist abgeschnitten!");
+
+        // Jeder Abschnitt muss in der Datei liegen, bevor etwas daraus gelesen wird (count ist danach <= size):
+        const uint64_t elem{(h.flags & DbDouble) ? sizeof(double) : sizeof(float)};
+        if (!fits(h.phiOffset, h.count, elem) || !fits(h.lambdaOffset, h.count, elem) ||
+            ((h.flags & DbTrig) && !fits(h.trigOffset, 5 * h.count, elem)) ||
+            !fits(h.nameIndexOffset, h.count + 1, sizeof(uint32_t)) || !fits(h.nameDataOffset, h.nameDataSize, 1))
+            throw std::runtime_error("Datenbank ist abgeschnitten!");
+
+        const auto n{static_cast<size_t>(h.count)};
+
+        coords.count = n;
+        coords.nameOffsets = reinterpret_cast<const uint32_t *>(at(h.nameIndexOffset));
+        coords.names = at(h.nameDataOffset);
+
+        if (!monotonic(coords.nameOffsets, n, h.nameDataSize))
+            throw std::runtime_error("Namensverzeichnis der Datenbank ist fehlerhaft!");
+
+        if (h.version >= 2) // Version 1 hat keine Kennungen, die Header-Felder gehören dort schon zu den Spalten
+        {
+            if (!fits(h.codeIndexOffset, h.count + 1, sizeof(uint32_t)) || !fits(h.codeDataOffset, h.codeDataSize, 1))
+                throw std::runtime_error("Datenbank ist abgeschnitten!");
+
+            coords.codeOffsets = reinterpret_cast<const uint32_t *>(at(h.codeIndexOffset));
+            coords.codes = at(h.codeDataOffset);
+
+            if (!monotonic(coords.codeOffsets, n, h.codeDataSize))
+                throw std::runtime_error("Kennungsverzeichnis der Datenbank ist fehlerhaft!");
+        }
+
+        if (!(h.flags & DbDouble) && (h.flags & DbTrig))
+        {
+            const auto *trig{reinterpret_cast<const float *>(at(h.trigOffset))};
+            coords.phi = reinterpret_cast<const float *>(at(h.phiOffset));
+            coords.lambda = reinterpret_cast<const float *>(at(h.lambdaOffset));
+            coords.sinPhi = trig;
+            coords.cosPhi = trig + n;
+            coords.sinLambda = trig + 2 * n;
+            coords.cosLambda = trig + 3 * n;
+            coords.sigma = trig + 4 * n;
+            return;
+        }
+
+        // Rückfallebene: Spalten in float umwandeln, gespeicherte Winkelfunktionen übernehmen (sonst bei Bedarf berechnet)
+        if (h.flags & DbTrig)
+            converted.cacheTrig();
+        converted.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const auto value = [this, &h](uint64_t offset, size_t index) -> float {
+                if (h.flags & DbDouble)
+                    return static_cast<float>(reinterpret_cast<const double *>(at(offset))[index]);
+                return reinterpret_cast<const float *>(at(offset))[index];
+            };
+
+            if (h.flags & DbTrig)
+                converted.add(PreparedCoordinate{value(h.phiOffset, i), value(h.lambdaOffset, i),
+                                                 value(h.trigOffset, i), value(h.trigOffset, n + i),
+                                                 value(h.trigOffset, 2 * n + i), value(h.trigOffset, 3 * n + i),
+                                                 value(h.trigOffset, 4 * n + i), {}, 0});
+            else
+                converted.add(value(h.phiOffset, i), value(h.lambdaOffset, i));
+        }
+
+        const auto mapped{coords};
+        coords = converted.view();
+        coords.strings = nullptr;
+        coords.nameOffsets = mapped.nameOffsets; // Bezeichner und Kennungen bleiben in der eingeblendeten Datei
+        coords.names = mapped.names;
+        coords.codeOffsets = mapped.codeOffsets;
+        coords.codes = mapped.codes;
+    }
+};
@@ -0,0 +1,461 @@
+// Strecken auf dem WGS84-Ellipsoid (Vincenty, inverse und direkte Aufgabe) und loxodromische Länge auf dem Ellipsoid
+//
+// Die Kugelformeln (r_E = 6378.137 km) weichen um bis zu ca. 0.5 % von der Strecke auf dem Ellipsoid ab. Hier wird
+// die inverse Aufgabe nach Vincenty (1975) in double gelöst:
+//   - Reduzierte Breite U (sin/cos) und Länge (sin/cos) werden je Koordinate einmal berechnet (WGS84Table).
+//   - Die Fixpunktiteration auf der Hilfskugel-Länge lambda = L + delta kommt ohne sin/cos aus: delta ist klein
+//     (|delta| <= pi f), sin/cos(L + delta) ergeben sich aus sin/cos(L) über das Additionstheorem und eine kurze
+//     Taylorreihe für delta. Je Iteration bleiben atan2 und sqrt.
+//   - Im Stapel laufen Width Paare im Gleichschritt (Struct-of-Arrays, Iterationen maskiert, bis alle Bahnen
+//     konvergiert sind). Die Rechenschleifen über die Bahnen sind verzweigungsfrei.
+//   - Fast gegenüberliegende Punkte, bei denen die Fixpunktiteration nicht konvergiert, werden über ein
+//     Einschlussverfahren (Regula falsi) für die Nullstelle g(lambda) = L + Korrektur(lambda) - lambda in [|L|; pi]
+//     gelöst (g(|L|) >= 0, g(pi) <= 0). Im sehr
+//     schmalen Bereich mehrerer Lösungen ist das eine gültige, nicht zwingend die kürzeste Geodäte.
+// Die direkte Aufgabe (Start, Kurs, Strecke -> Ziel) dient der Gegenprobe.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm> // std::min
+#include <atomic>    // std::atomic
+#include <cmath>     // std::atan2, std::sqrt, std::sin, std::cos
+#include <cstddef>   // size_t
+#include <cstdint>   // int-Typen
+#include <stdexcept> // std::out_of_range, std::invalid_argument
+#include <string>    // std::string
+#include <vector>    // std::vector
+
+/// Eigene Header
+#include "sphere.hpp"   // PreparedCoordinate
+#include "store.hpp"    // CoordinateView
+#include "executor.hpp" // ThreadPool
+
+inline const char *earthName(Earth earth) noexcept
+{
+    return (earth == Earth::WGS84) ? "wgs84" : "sphere";
+}
+
+inline Earth toEarth(const std::string &name)
+{
+    if (name == "sphere")
+        return Earth::Sphere;
+    if (name == "wgs84")
+        return Earth::WGS84;
+    throw std::invalid_argument("Unbekanntes Erdmodell " + name);
+}
+
+namespace wgs84
+{
+    constexpr double a{6378.137};              // große Halbachse in km
+    constexpr double f{1.0 / 298.257223563};   // Abplattung
+    constexpr double b{a * (1.0 - f)};         // kleine Halbachse in km
+    constexpr double e2{f * (2.0 - f)};        // erste Exzentrizität zum Quadrat
+    constexpr double ep2{e2 / (1.0 - e2)};     // zweite Exzentrizität zum Quadrat
+    constexpr double n{f / (2.0 - f)};         // dritte Abplattung
+
+    constexpr int MaxIterations{20};           // Fixpunktiteration, danach Einschlussverfahren
+    constexpr double Tolerance{1e-12};         // rad auf der Hilfskugel (ca. 0.006 mm)
+
+    // Koordinate auf der Hilfskugel (reduzierte Breite) und Länge:
+    struct Point
+    {
+        double sinU, cosU;
+        double sinLon, cosLon, lon;
+    };
+
+    inline Point toPoint(double phi, double lon) noexcept
+    {
+        const auto U{std::atan2((1.0 - f) * std::sin(phi), std::cos(phi))};
+        return Point{std::sin(U), std::cos(U), std::sin(lon), std::cos(lon), lon};
+    }
+
+    // Ergebnis der inversen Aufgabe:
+    struct Geodesic
+    {
+        double km;         // Strecke
+        double azimuth1;   // Kurs in Start (rad, Norden = 0, Osten positiv)
+        double azimuth2;   // Kurs im Ziel
+        int iterations;    // Fixpunktiterationen (MaxIterations + 1: Einschlussverfahren)
+    };
+
+    // sin/cos(L + delta) aus sin/cos(L), delta klein (Taylorreihe bis delta^9 bzw. delta^8, Fehler < 1e-20):
+    inline void rotate(double sinL, double cosL, double delta, double &sinLambda, double &cosLambda) noexcept
+    {
+        const auto d2{delta * delta};
+        const auto sd{delta * (1.0 - d2 / 6.0 * (1.0 - d2 / 20.0 * (1.0 - d2 / 42.0 * (1.0 - d2 / 72.0))))};
+        const auto cd{1.0 - d2 / 2.0 * (1.0 - d2 / 12.0 * (1.0 - d2 / 30.0 * (1.0 - d2 / 56.0)))};
+        sinLambda = sinL * cd + cosL * sd;
+        cosLambda = cosL * cd - sinL * sd;
+    }
+
+    // Größen auf der Hilfskugel für gegebenes lambda (sin/cos):
+    struct Sphere
+    {
+        double sinSigma, cosSigma, sigma, sinAlpha, cos2Alpha, cos2SigmaM;
+    };
+
+    inline Sphere auxiliary(const Point &P, const Point &Q, double sinLambda, double cosLambda) noexcept
+    {
+        Sphere s;
+        const auto x{Q.cosU * sinLambda}, y{P.cosU * Q.sinU - P.sinU * Q.cosU * cosLambda};
+        s.sinSigma = std::sqrt(x * x + y * y);
+        s.cosSigma = P.sinU * Q.sinU + P.cosU * Q.cosU * cosLambda;
+        s.sigma = std::atan2(s.sinSigma, s.cosSigma);
+        s.sinAlpha = (s.sinSigma > 0.0) ? P.cosU * Q.cosU * sinLambda / s.sinSigma : 0.0;
+        s.cos2Alpha = 1.0 - s.sinAlpha * s.sinAlpha;
+        s.cos2SigmaM = (s.cos2Alpha > 0.0) ? s.cosSigma - 2.0 * P.sinU * Q.sinU / s.cos2Alpha : 0.0; // Äquatorlinie: 0
+        return s;
+    }
+
+    // Neue Abweichung delta = lambda - L:
+    inline double correction(const Sphere &s) noexcept
+    {
+        const auto C{f / 16.0 * s.cos2Alpha * (4.0 + f * (4.0 - 3.0 * s.cos2Alpha))};
+        return (1.0 - C) * f * s.sinAlpha * (s.sigma + C * s.sinSigma * (s.cos2SigmaM + C * s.cosSigma * (-1.0 + 2.0 * s.cos2SigmaM * s.cos2SigmaM)));
+    }
+
+    // Strecke aus den Größen auf der Hilfskugel:
+    inline double distance(const Sphere &s) noexcept
+    {
+        const auto u2{s.cos2Alpha * ep2};
+        const auto A{1.0 + u2 / 16384.0 * (4096.0 + u2 * (-768.0 + u2 * (320.0 - 175.0 * u2)))};
+        const auto B{u2 / 1024.0 * (256.0 + u2 * (-128.0 + u2 * (74.0 - 47.0 * u2)))};
+        const auto c2{s.cos2SigmaM * s.cos2SigmaM};
+        const auto dSigma{B * s.sinSigma * (s.cos2SigmaM + B / 4.0 * (s.cosSigma * (-1.0 + 2.0 * c2) - B / 6.0 * s.cos2SigmaM * (-3.0 + 4.0 * s.sinSigma * s.sinSigma) * (-3.0 + 4.0 * c2)))};
+        return b * A * (s.sigma - dSigma);
+    }
+
+    // Längendifferenz Q - P in (-pi; pi]:
+    inline double lonDifference(const Point &P, const Point &Q) noexcept
+    {
+        auto L{Q.lon - P.lon};
+        if (L > M_PI)
+            L -= 2.0 * M_PI;
+        else if (L <= -M_PI)
+            L += 2.0 * M_PI;
+        return L;
+    }
+
+    // Nullstellensuche für fast gegenüberliegende Punkte (lambda in [|L|; pi], Ergebnis für L < 0 gespiegelt). Regula
+    // falsi (Illinois) mit Einschluss, braucht meist unter 10 statt ca. 40 Schritte der reinen Bisektion:
+    inline Geodesic solveBracketed(const Point &P, const Point &Q, double L) noexcept
+    {
+        const auto sign{(L < 0.0) ? -1.0 : 1.0};
+        const auto absL{std::fabs(L)};
+        const auto g = [&P, &Q, absL](double lambda, Sphere &s) {
+            s = auxiliary(P, Q, std::sin(lambda), std::cos(lambda));
+            return absL + correction(s) - lambda;
+        };
+
+        Sphere s{};
+        double lo{absL}, hi{M_PI};
+        double gLo{g(lo, s)}, gHi{g(hi, s)};
+        double lambda{hi};
+        int side{0}; // Seite, die zuletzt verschoben wurde (Illinois: Funktionswert der anderen halbieren)
+        for (int i = 0; i < 64; i++)
+        {
+            lambda = (gLo - gHi > 0.0) ? lo + gLo * (hi - lo) / (gLo - gHi) : 0.5 * (lo + hi);
+            if (!(lambda > lo && lambda < hi))
+                lambda = 0.5 * (lo + hi);
+
+            const auto gLambda{g(lambda, s)};
+            if (gLambda >= 0.0)
+            {
+                lo = lambda, gLo = gLambda;
+                if (side == -1)
+                    gHi *= 0.5;
+                side = -1;
+            }
+            else
+            {
+                hi = lambda, gHi = gLambda;
+                if (side == 1)
+                    gLo *= 0.5;
+                side = 1;
+            }
+            if ((hi - lo < Tolerance) || (std::fabs(gLambda) < Tolerance))
+                break;
+        }
+
+        const auto sinLambda{std::sin(lambda)}, cosLambda{std::cos(lambda)};
+        const auto azimuth1{std::atan2(Q.cosU * sinLambda, P.cosU * Q.sinU - P.sinU * Q.cosU * cosLambda)};
+        const auto azimuth2{std::atan2(P.cosU * sinLambda, -P.sinU * Q.cosU + P.cosU * Q.sinU * cosLambda)};
+        return Geodesic{distance(s), sign * azimuth1, sign * azimuth2, MaxIterations + 1};
+    }
+
+    // Inverse Aufgabe für ein Paar:
+    inline Geodesic inverse(const Point &P, const Point &Q) noexcept
+    {
+        const auto L{lonDifference(P, Q)};
+        const auto sinL{Q.sinLon * P.cosLon - Q.cosLon * P.sinLon};
+        const auto cosL{Q.cosLon * P.cosLon + Q.sinLon * P.sinLon};
+
+        double delta{0}, sinLambda{sinL}, cosLambda{cosL};
+        Sphere s{};
+        for (int i = 1; i <= MaxIterations; i++)
+        {
+            s = auxiliary(P, Q, sinLambda, cosLambda);
+            if (s.sinSigma == 0.0) // gleiche Punkte
+                return Geodesic{0.0, 0.0, 0.0, i};
+
+            const auto next{correction(s)};
+            if (std::fabs(L + next) > M_PI)
+                break;
+            rotate(sinL, cosL, next, sinLambda, cosLambda);
+
+            if (std::fabs(next - delta) < Tolerance)
+            {
+                s = auxiliary(P, Q, sinLambda, cosLambda);
+                return Geodesic{distance(s), std::atan2(Q.cosU * sinLambda, P.cosU * Q.sinU - P.sinU * Q.cosU * cosLambda),
+                                std::atan2(P.cosU * sinLambda, -P.sinU * Q.cosU + P.cosU * Q.sinU * cosLambda), i};
+            }
+            delta = next;
+        }
+        return solveBracketed(P, Q, L);
+    }
+
+    inline Geodesic inverse(double phi1, double lon1, double phi2, double lon2) noexcept
+    {
+        return inverse(toPoint(phi1, lon1), toPoint(phi2, lon2));
+    }
+
+    // Direkte Aufgabe: Ziel (Breite, Länge in rad) und Kurs im Ziel aus Start, Kurs und Strecke (km):
+    struct Destination
+    {
+        double phi, lon, azimuth;
+    };
+
+    inline Destination direct(double phi1, double lon1, double azimuth1, double km) noexcept
+    {
+        const auto U1{std::atan2((1.0 - f) * std::sin(phi1), std::cos(phi1))};
+        const auto sinU1{std::sin(U1)}, cosU1{std::cos(U1)};
+        const auto sinA1{std::sin(azimuth1)}, cosA1{std::cos(azimuth1)};
+
+        const auto sigma1{std::atan2(sinU1, cosU1 * cosA1)};
+        const auto sinAlpha{cosU1 * sinA1};
+        const auto cos2Alpha{1.0 - sinAlpha * sinAlpha};
+        const auto u2{cos2Alpha * ep2};
+        const auto A{1.0 + u2 / 16384.0 * (4096.0 + u2 * (-768.0 + u2 * (320.0 - 175.0 * u2)))};
+        const auto B{u2 / 1024.0 * (256.0 + u2 * (-128.0 + u2 * (74.0 - 47.0 * u2)))};
+
+        auto sigma{km / (b * A)};
+        double sinSigma{0}, cosSigma{0}, cos2SigmaM{0};
+        for (int i = 0; i < 100; i++)
+        {
+            cos2SigmaM = std::cos(2.0 * sigma1 + sigma);
+            sinSigma = std::sin(sigma);
+            cosSigma = std::cos(sigma);
+            const auto c2{cos2SigmaM * cos2SigmaM};
+            const auto dSigma{B * sinSigma * (cos2SigmaM + B / 4.0 * (cosSigma * (-1.0 + 2.0 * c2) - B / 6.0 * cos2SigmaM * (-3.0 + 4.0 * sinSigma * sinSigma) * (-3.0 + 4.0 * c2)))};
+            const auto next{km / (b * A) + dSigma};
+            const auto done{std::fabs(next - sigma) < Tolerance};
+            sigma = next;
+            if (done)
+                break;
+        }
+        cos2SigmaM = std::cos(2.0 * sigma1 + sigma);
+        sinSigma = std::sin(sigma);
+        cosSigma = std::cos(sigma);
+
+        const auto tmp{sinU1 * sinSigma - cosU1 * cosSigma * cosA1};
+        const auto phi2{std::atan2(sinU1 * cosSigma + cosU1 * sinSigma * cosA1, (1.0 - f) * std::sqrt(sinAlpha * sinAlpha + tmp * tmp))};
+        const auto lambda{std::atan2(sinSigma * sinA1, cosU1 * cosSigma - sinU1 * sinSigma * cosA1)};
+        const auto C{f / 16.0 * cos2Alpha * (4.0 + f * (4.0 - 3.0 * cos2Alpha))};
+        const auto L{lambda - (1.0 - C) * f * sinAlpha * (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)))};
+
+        auto lon2{lon1 + L};
+        lon2 = std::remainder(lon2, 2.0 * M_PI);
+        return Destination{phi2, lon2, std::atan2(sinAlpha, -tmp)};
+    }
+
+    // Meridianbogenlänge vom Äquator bis phi (Reihe nach Helmert in n, Fehler < 0.1 mm):
+    inline double meridianArc(double phi) noexcept
+    {
+        const auto n2{n * n}, n3{n2 * n}, n4{n3 * n};
+        return a / (1.0 + n) *
+               ((1.0 + n2 / 4.0 + n4 / 64.0) * phi - 1.5 * (n - n3 / 8.0) * std::sin(2.0 * phi) + 15.0 / 16.0 * (n2 - n4 / 4.0) * std::sin(4.0 * phi) -
+                35.0 / 48.0 * n3 * std::sin(6.0 * phi) + 315.0 / 512.0 * n4 * std::sin(8.0 * phi));
+    }
+
+    // Isometrische Breite psi(phi) auf dem Ellipsoid:
+    inline double isometricLatitude(double phi) noexcept
+    {
+        const auto e{std::sqrt(e2)};
+        return std::atanh(std::sin(phi)) - e * std::atanh(e * std::sin(phi));
+    }
+
+    // Loxodromische Länge (km) auf dem Ellipsoid: hypot(dM, q dLon) mit q = dM / dpsi, für Kurse nahe Ost/West
+    // q = Radius des Breitenkreises nu cos(phi) in der mittleren Breite:
+    inline double rhumbLength(double phi1, double lon1, double phi2, double lon2) noexcept
+    {
+        auto dLon{lon2 - lon1};
+        if (std::fabs(dLon) > M_PI)
+            dLon -= std::copysign(2.0 * M_PI, dLon);
+
+        const auto dM{meridianArc(phi2) - meridianArc(phi1)};
+        const auto dPsi{isometricLatitude(phi2) - isometricLatitude(phi1)};
+
+        double q;
+        if (std::fabs(dPsi) > 1e-12)
+            q = dM / dPsi;
+        else
+        {
+            const auto phi{0.5 * (phi1 + phi2)};
+            q = a * std::cos(phi) / std::sqrt(1.0 - e2 * std::sin(phi) * std::sin(phi));
+        }
+        return std::hypot(dM, q * dLon);
+    }
+} // namespace wgs84
+
+// Strecke auf dem Ellipsoid in km (Kurs in A über wgs84::inverse):
+inline float calcGeodesicKm(const PreparedCoordinate &A, const PreparedCoordinate &B) noexcept
+{
+    return static_cast<float>(wgs84::inverse(A.phi, A.lambda, B.phi, B.lambda).km);
+}
+
+inline float calcLoxodromicLengthWGS84(const PreparedCoordinate &A, const PreparedCoordinate &B) noexcept
+{
+    return static_cast<float>(wgs84::rhumbLength(A.phi, A.lambda, B.phi, B.lambda));
+}
+
+// Auswahl des Erdmodells:
+inline float calcGCDkm(const PreparedCoordinate &A, const PreparedCoordinate &B, Earth earth) noexcept
+{
+    return (earth == Earth::WGS84) ? calcGeodesicKm(A, B) : calcGCDkm(A, B);
+}
+
+inline float calcLoxodromicLength(const PreparedCoordinate &A, const PreparedCoordinate &B, Earth earth) noexcept
+{
+    return (earth == Earth::WGS84) ? calcLoxodromicLengthWGS84(A, B) : calcLoxodromicLength(A, B);
+}
+
+// Hilfskugel-Koordinaten aller Koordinaten eines Speichers (einmal je Koordinate statt je Paar):
+class WGS84Table
+{
+public:
+    explicit WGS84Table(const CoordinateView &coords) : points(coords.size())
+    {
+        for (size_t i = 0; i < coords.size(); i++)
+            points[i] = wgs84::toPoint(coords.phi[i], coords.lambda[i]);
+    }
+
+    size_t size(void) const noexcept
+    {
+        return points.size();
+    }
+
+    const wgs84::Point &operator[](size_t i) const noexcept
+    {
+        return points[i];
+    }
+
+private:
+    std::vector<wgs84::Point> points;
+};
+
+// Strecken (km) und optional Kurs in Start (rad) der Paare from[i] -> to[i] auf dem Ellipsoid. Je Width Paare im
+// Gleichschritt, nicht konvergierte Bahnen über wgs84::solveBracketed. Liefert die Anzahl der Paare im Einschlussverfahren.
+inline size_t calcGeodesics(const WGS84Table &table, const uint32_t *from, const uint32_t *to, size_t count,
+                            float *km, float *azimuth = nullptr, ThreadPool *pool = nullptr)
+{
+    for (size_t i = 0; i < count; i++)
+        if ((from[i] >= table.size()) || (to[i] >= table.size()))
+            throw std::out_of_range("Ungültige ID in Streckenliste!");
+
+    constexpr size_t Width{8};
+    std::atomic<size_t> fallbacks{0};
+
+    const auto block = [&](size_t begin, size_t end) {
+        for (size_t first = begin; first < end; first += Width)
+        {
+            const auto lanes{std::min(Width, end - first)};
+
+            // Eingaben je Bahn (leere Bahnen rechnen ein gültiges Paar mit, Ergebnis wird verworfen):
+            double sinU1[Width], cosU1[Width], sinU2[Width], cosU2[Width], L[Width], sinL[Width], cosL[Width];
+            for (size_t k = 0; k < Width; k++)
+            {
+                const auto &P{table[from[first + std::min(k, lanes - 1)]]};
+                const auto &Q{table[to[first + std::min(k, lanes - 1)]]};
+                sinU1[k] = P.sinU, cosU1[k] = P.cosU, sinU2[k] = Q.sinU, cosU2[k] = Q.cosU;
+                L[k] = wgs84::lonDifference(P, Q);
+                sinL[k] = Q.sinLon * P.cosLon - Q.cosLon * P.sinLon;
+                cosL[k] = Q.cosLon * P.cosLon + Q.sinLon * P.sinLon;
+            }
+
+            double delta[Width]{}, sinLambda[Width], cosLambda[Width];
+            double sinSigma[Width], cosSigma[Width], sigma[Width], sinAlpha[Width], cos2Alpha[Width], cos2SigmaM[Width];
+            bool active[Width], failed[Width]{};
+            for (size_t k = 0; k < Width; k++)
+                sinLambda[k] = sinL[k], cosLambda[k] = cosL[k], active[k] = true;
+
+            for (int iteration = 0; iteration < wgs84::MaxIterations; iteration++)
+            {
+                // Hilfskugel für alle Bahnen (auch konvergierte, Ergebnis bleibt dort unverändert):
+                for (size_t k = 0; k < Width; k++)
+                {
+                    const auto x{cosU2[k] * sinLambda[k]}, y{cosU1[k] * sinU2[k] - sinU1[k] * cosU2[k] * cosLambda[k]};
+                    sinSigma[k] = std::sqrt(x * x + y * y);
+                    cosSigma[k] = sinU1[k] * sinU2[k] + cosU1[k] * cosU2[k] * cosLambda[k];
+                }
+                for (size_t k = 0; k < Width; k++)
+                    sigma[k] = std::atan2(sinSigma[k], cosSigma[k]);
+
+                bool any{false};
+                for (size_t k = 0; k < Width; k++)
+                {
+                    const auto valid{sinSigma[k] > 0.0};
+                    sinAlpha[k] = valid ? cosU1[k] * cosU2[k] * sinLambda[k] / sinSigma[k] : 0.0;
+                    cos2Alpha[k] = 1.0 - sinAlpha[k] * sinAlpha[k];
+                    cos2SigmaM[k] = (cos2Alpha[k] > 0.0) ? cosSigma[k] - 2.0 * sinU1[k] * sinU2[k] / cos2Alpha[k] : 0.0;
+
+                    const auto C{wgs84::f / 16.0 * cos2Alpha[k] * (4.0 + wgs84::f * (4.0 - 3.0 * cos2Alpha[k]))};
+                    const auto next{(1.0 - C) * wgs84::f * sinAlpha[k] *
+                                    (sigma[k] + C * sinSigma[k] * (cos2SigmaM[k] + C * cosSigma[k] * (-1.0 + 2.0 * cos2SigmaM[k] * cos2SigmaM[k])))};
+
+                    // Maskiert fortschreiben: konvergierte Bahnen bleiben stehen, |lambda| > pi führt zum Einschlussverfahren
+                    const auto beyond{std::fabs(L[k] + next) > M_PI};
+                    const auto step{active[k] && valid && !beyond};
+                    failed[k] = failed[k] || (active[k] && beyond);
+                    const auto moving{step && (std::fabs(next - delta[k]) >= wgs84::Tolerance)};
+                    delta[k] = step ? next : delta[k];
+                    active[k] = moving;
+                    any = any || moving;
+                }
+
+                for (size_t k = 0; k < Width; k++)
+                    wgs84::rotate(sinL[k], cosL[k], delta[k], sinLambda[k], cosLambda[k]);
+
+                if (!any)
+                    break;
+            }
+
+            // Endwerte mit konvergiertem lambda:
+            for (size_t k = 0; k < lanes; k++)
+            {
+                const auto &P{table[from[first + k]]};
+                const auto &Q{table[to[first + k]]};
+                if (active[k] || failed[k])
+                {
+                    const auto g{wgs84::solveBracketed(P, Q, L[k])};
+                    km[first + k] = static_cast<float>(g.km);
+                    if (azimuth)
+                        azimuth[first + k] = static_cast<float>(g.azimuth1);
+                    fallbacks++;
+                    continue;
+                }
+
+                const auto s{wgs84::auxiliary(P, Q, sinLambda[k], cosLambda[k])};
+                km[first + k] = static_cast<float>(wgs84::distance(s));
+                if (azimuth)
+                    azimuth[first + k] = static_cast<float>(std::atan2(Q.cosU * sinLambda[k], P.cosU * Q.sinU - P.sinU * Q.cosU * cosLambda[k]));
+            }
+        }
+    };
+
+    if (!pool || (pool->size() == 1))
+        block(0, count);
+    else
+        pool->parallelFor(count, 4096, block);
+
+    return fallbacks;
+}
@@ -0,0 +1,222 @@
+// Thread-Pool mit Work-Stealing für Stapelberechnungen (Distanzmatrix, Stapelmodus, ...)
+//
+// run(tasks, body) ruft body(i) für alle i in [0; tasks) auf. Die Aufgaben werden in zusammenhängenden Blöcken auf
+// die Warteschlangen der Threads verteilt; jeder Thread arbeitet seinen Block von vorne ab und stiehlt, wenn er
+// leer ist, von hinten aus fremden Warteschlangen. Der aufrufende Thread arbeitet mit. Die Ausgabereihenfolge
+// bleibt deterministisch, weil jede Aufgabe nur in ihren eigenen, vorab festgelegten Ausgabebereich schreibt.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>          // std::max
+#include <atomic>             // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstddef>            // size_t
+#include <cstdint>            // int-Typen
+#include <deque>              // std::deque
+#include <exception>          // std::exception_ptr
+#include <memory>             // std::unique_ptr
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <type_traits>        // std::remove_reference_t
+#include <vector>             // std::vector
+
+// Typische Cache-Line-Größe; Ausgabebereiche verschiedener Aufgaben sollen sich keine Zeile teilen:
+constexpr size_t CacheLine{64};
+
+class ThreadPool
+{
+public:
+    // threads = 0: Anzahl Hardware-Threads. threads = 1: alles läuft im aufrufenden Thread.
+    explicit ThreadPool(unsigned threads = 0)
+        : count(threads ? threads : std::max(1u, std::thread::hardware_concurrency())), queues(new Queue[count])
+    {
+        workers.reserve(count - 1);
+        for (unsigned w = 1; w < count; w++)
+            workers.emplace_back([this, w]() { workerLoop(w); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(state);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto &t : workers)
+            t.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Anzahl Threads inkl. des aufrufenden:
+    unsigned size(void) const noexcept
+    {
+        return count;
+    }
+
+    // Ruft body(i) für alle i in [0; tasks) auf und kehrt zurück, wenn alle Aufgaben erledigt sind.
+    // Die erste Ausnahme einer Aufgabe wird im aufrufenden Thread weitergeworfen. Verschachtelte Aufrufe
+    // aus einer Aufgabe heraus laufen seriell.
+    template <class F>
+    void run(size_t tasks, F &&body)
+    {
+        if ((count == 1) || (tasks <= 1) || insideTask())
+        {
+            for (size_t i = 0; i < tasks; i++)
+                body(i);
+            return;
+        }
+
+        const std::lock_guard<std::mutex> serial(running); // immer nur ein Auftrag gleichzeitig
+
+        Job job;
+        job.context = &body;
+        job.invoke = [](void *context, size_t i) { (*static_cast<std::remove_reference_t<F> *>(context))(i); };
+        job.remaining = tasks;
+
+        // Zusammenhängende Blöcke je Thread (Lokalität, deterministische Zuordnung ohne Stehlen):
+        for (unsigned w = 0; w < count; w++)
+        {
+            const std::lock_guard<std::mutex> lock(queues[w].mutex);
+            for (size_t i = tasks * w / count; i < tasks * (w + 1) / count; i++)
+                queues[w].tasks.push_back(i);
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(state);
+            current = &job;
+            generation++;
+            job.active = 1; // aufrufender Thread
+        }
+        wake.notify_all();
+
+        work(0, job);
+
+        std::unique_lock<std::mutex> lock(state);
+        job.active--;
+        done.wait(lock, [&job]() { return (job.remaining == 0) && (job.active == 0); });
+        current = nullptr;
+        lock.unlock();
+
+        if (job.error)
+            std::rethrow_exception(job.error);
+    }
+
+    // Teilt [0; total) in Blöcke von etwa grain Elementen und ruft body(begin, end) je Block auf:
+    template <class F>
+    void parallelFor(size_t total, size_t grain, F &&body)
+    {
+        grain = std::max<size_t>(grain, 1);
+        const auto chunks{(total + grain - 1) / grain};
+        run(chunks, [&body, total, grain](size_t c) { body(c * grain, std::min(total, (c + 1) * grain)); });
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    struct Job
+    {
+        void *context{nullptr};
+        void (*invoke)(void *, size_t){nullptr};
+        std::atomic<size_t> remaining{0};
+        unsigned active{0}; // Threads, die gerade an diesem Auftrag arbeiten (geschützt durch state)
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    const unsigned count;
+    const std::unique_ptr<Queue[]> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex running; // serialisiert run()
+    std::mutex state;   // schützt current, generation, quit, Job::active
+    std::condition_variable wake, done;
+    Job *current{nullptr};
+    uint64_t generation{0};
+    bool quit{false};
+
+    static bool &insideTask(void) noexcept
+    {
+        thread_local bool inside{false};
+        return inside;
+    }
+
+    // Eigene Warteschlange von vorne, sonst von hinten aus einer fremden stehlen:
+    bool pop(unsigned w, size_t &task)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(queues[w].mutex);
+            if (!queues[w].tasks.empty())
+            {
+                task = queues[w].tasks.front();
+                queues[w].tasks.pop_front();
+                return true;
+            }
+        }
+
+        for (unsigned k = 1; k < count; k++)
+        {
+            auto &victim{queues[(w + k) % count]};
+            const std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Arbeitet Aufgaben ab, bis alle Warteschlangen leer sind (neue Aufgaben kommen während eines Auftrags nicht hinzu):
+    void work(unsigned w, Job &job)
+    {
+        insideTask() = true;
+        size_t task;
+        while (pop(w, task))
+        {
+            try
+            {
+                job.invoke(job.context, task);
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock(job.errorMutex);
+                if (!job.error)
+                    job.error = std::current_exception();
+            }
+            job.remaining--;
+        }
+        insideTask() = false;
+    }
+
+    void workerLoop(unsigned w)
+    {
+        uint64_t seen{0};
+        std::unique_lock<std::mutex> lock(state);
+
+        while (true)
+        {
+            wake.wait(lock, [this, seen]() { return quit || (current && (generation != seen)); });
+            if (quit)
+                return;
+
+            seen = generation;
+            auto &job{*current};
+            job.active++;
+            lock.unlock();
+
+            work(w, job);
+
+            lock.lock();
+            job.active--;
+            if ((job.remaining == 0) && (job.active == 0))
+                done.notify_all();
+        }
+    }
+};
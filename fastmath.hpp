@@ -0,0 +1,140 @@
+// Schnelle Näherungen für arccos, atan2 und sin zum Vorsortieren großer Mengen (Screening) und für Parameterstudien
+//
+// Die Winkelfunktionen der Koordinaten (sin, cos, sigma) liegen im Koordinatenspeicher bereits vor, in den
+// Stapelschleifen bleiben nur arccos (Zentriwinkel, Kurswinkel) und atan2 (loxodromischer Kurs). Beide werden hier
+// über Polynome nach Abramowitz/Stegun ausgewertet, ohne libm-Aufruf und ohne Verzweigung (Auswahl über ?:, das der
+// Compiler in Blend-Befehle übersetzt).
+//
+// Maximaler Fehler gegen die exakten Funktionen bei gleichem Argument (float, einschließlich Rundung):
+//   fastAcos     7.0e-5 rad (0.0040 Grad), als Großkreisdistanz 0.45 km
+//   fastAtan2    1.2e-5 rad (0.00069 Grad)
+//   fastSin      2.5e-7 in [-pi; pi] (cos(x) als fastSin(pi/2 - x) für x in [-pi/2; pi])
+// Die Schranken werden in bench.cpp über dichte Stichproben aller float-Argumente nachgeprüft.
+//
+// Im Screening (screenWithin) werden Kandidaten, deren genäherte Distanz näher als FastMaxErrorKm an der Schwelle liegt,
+// mit calcGCDkm nachgerechnet. Die Entscheidung innerhalb/außerhalb ist damit identisch zur exakten Rechnung.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm> // std::min
+#include <cmath>     // std::sqrt, std::fabs
+#include <cstddef>   // size_t
+#include <cstdint>   // int-Typen
+#include <vector>    // std::vector
+
+/// Eigene Header
+#include "sphere.hpp" // PreparedCoordinate, calcCosGCD, calcCosAlpha, calcGCDkm, r_E
+#include "store.hpp"  // CoordinateView, withTrig
+
+constexpr float FastAcosMaxError{7.0e-5f};                            // rad
+constexpr float FastAtan2MaxError{1.2e-5f};                           // rad
+constexpr float FastSinMaxError{2.5e-7f};
+constexpr float FastMaxErrorKm{FastAcosMaxError * 6378.137f + 0.01f}; // inkl. Rundung der Multiplikation mit r_E
+
+// Genauigkeit der Screening-Funktionen:
+enum class Accuracy
+{
+    Exact, // libm
+    Fast   // Näherungen, Grenzfälle exakt nachgerechnet
+};
+
+// arccos(x) = sqrt(1 - x) (a0 + a1 x + a2 x^2 + a3 x^3) für 0 <= x <= 1 (A&S 4.4.45), x < 0 über pi - arccos(-x):
+inline float fastAcos(float x) noexcept
+{
+    x = clampUnit(x);
+    const auto a{std::fabs(x)};
+    const auto p{((-0.0187293f * a + 0.0742610f) * a - 0.2121144f) * a + 1.5707288f};
+    const auto r{std::sqrt(1.0f - a) * p};
+    return (x < 0.0f) ? static_cast<float>(M_PI) - r : r;
+}
+
+// atan(z) = z (c1 + c3 z^2 + ... + c9 z^8) für |z| <= 1 (A&S 4.4.49), Rest über Oktanten:
+inline float fastAtan2(float y, float x) noexcept
+{
+    const auto ax{std::fabs(x)}, ay{std::fabs(y)};
+    const auto tausch{ay > ax};
+    const auto z{(tausch ? ax / ay : ay / ax)};
+    const auto z2{z * z};
+    const auto p{z * ((((0.0208351f * z2 - 0.0851330f) * z2 + 0.1801410f) * z2 - 0.3302995f) * z2 + 0.9998660f)};
+
+    auto r{tausch ? static_cast<float>(M_PI / 2) - p : p};
+    r = (x < 0.0f) ? static_cast<float>(M_PI) - r : r;
+    r = (ax == 0.0f && ay == 0.0f) ? 0.0f : r; // atan2(0, 0) = 0 wie libm für +0
+    return std::copysign(r, y);
+}
+
+// sin(x) für |x| <= pi: Spiegelung auf [-pi/2; pi/2] (sin(pi - x) = sin(x)), dort Taylorreihe bis x^11:
+inline float fastSin(float x) noexcept
+{
+    constexpr auto pi{static_cast<float>(M_PI)};
+    x = (x > pi / 2) ? pi - x : (x < -pi / 2) ? -pi - x : x;
+    const auto x2{x * x};
+    return x * (1.0f + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880 - x2 / 39916800.0f)))));
+}
+
+namespace fast
+{
+    inline float calcGCDrad(const PreparedCoordinate &A, const PreparedCoordinate &B) noexcept
+    {
+        return fastAcos(calcCosGCD(A, B));
+    }
+
+    inline float calcGCDkm(const PreparedCoordinate &A, const PreparedCoordinate &B) noexcept
+    {
+        return fast::calcGCDrad(A, B) * r_E;
+    }
+
+    inline float calcAlphaRad(const PreparedCoordinate &A, const PreparedCoordinate &B)
+    {
+        return fastAcos(calcCosAlpha(A, B, calcCosGCD(A, B)));
+    }
+
+    inline float calcLoxodromicCourse(const PreparedCoordinate &A, const PreparedCoordinate &B) noexcept
+    {
+        return fastAtan2(B.lambda - A.lambda, B.sigma - A.sigma);
+    }
+} // namespace fast
+
+// Alle Koordinaten mit calcGCDkm(q, p) <= km in aufsteigender ID-Reihenfolge, ohne räumlichen Index (z.B. für viele
+// verschiedene Suchpunkte ohne Aufbau eines Index). Mit Accuracy::Fast identisches Ergebnis, weniger exakte Aufrufe.
+inline std::vector<uint32_t> screenWithin(const CoordinateView &points, const PreparedCoordinate &q, float km, Accuracy accuracy = Accuracy::Fast)
+{
+    TrigColumns derived;
+    const auto coords{withTrig(points, derived)};
+    constexpr size_t Block{256};
+    std::vector<uint32_t> hits;
+    float cosZeta[Block], distance[Block];
+
+    const auto point = [&coords](size_t i) {
+        return PreparedCoordinate{0.0f, 0.0f, coords.sinPhi[i], coords.cosPhi[i], coords.sinLambda[i], coords.cosLambda[i], 0.0f, {}, 0};
+    };
+
+    for (size_t first = 0; first < coords.size(); first += Block)
+    {
+        const auto n{std::min(Block, coords.size() - first)};
+
+        // cos(zeta) wie in calcGCDkm, damit Näherung und Nachrechnung vom selben Argument ausgehen:
+        for (size_t i = 0; i < n; i++)
+            cosZeta[i] = calcCosGCD(q, point(first + i));
+
+        if (accuracy == Accuracy::Exact)
+        {
+            for (size_t i = 0; i < n; i++)
+                if (std::acos(cosZeta[i]) * r_E <= km)
+                    hits.push_back(static_cast<uint32_t>(first + i));
+            continue;
+        }
+
+        // Genäherte Distanzen (verzweigungsfrei, vektorisierbar), danach Entscheidung mit exakter Rechnung nur für Grenzfälle:
+        for (size_t i = 0; i < n; i++)
+            distance[i] = fastAcos(cosZeta[i]) * r_E;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            const auto d{distance[i]};
+            if ((d < km - FastMaxErrorKm) || ((d <= km + FastMaxErrorKm) && (std::acos(cosZeta[i]) * r_E <= km)))
+                hits.push_back(static_cast<uint32_t>(first + i));
+        }
+    }
+    return hits;
+}
@@ -0,0 +1,203 @@
+// Korridorprüfung (Geofencing): Abstand vieler Positionen zu vielen Strecken A->B auf dem Großkreis
+//
+// Je Strecke werden einmal die Einheitsvektoren a und b, die Normale n = a x b / |a x b|, die Tangente t = n x a in A
+// und die Mitte m des Bogens berechnet. Für eine Position p (Einheitsvektor) gilt dann
+//   Querabstand (cross-track)   asin(p . n)            (positiv: links der Flugrichtung)
+//   Abstand entlang (along)     atan2(p . t, p . a)    (Fußpunkt des Lots, ab A)
+// Liegt der Fußpunkt zwischen A und B, ist der Querabstand der kürzeste Abstand zur Strecke, sonst der Abstand zum
+// näheren Endpunkt (Lage wie classifyPeak: vor A, innerhalb, hinter B).
+//
+// Vorauswahl ohne Winkelfunktionen: Eine Position mit Abstand <= d zur Strecke liegt in der Kugelkappe um m mit Radius
+// zeta/2 + d und im Band |p . n| <= sin(d) um den Großkreis. Beides sind Skalarprodukte, die blockweise für viele
+// Positionen je Strecke vektorisiert ausgewertet werden; nur die verbleibenden Kandidaten werden genau gerechnet.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm> // std::min, std::sort
+#include <cmath>     // std::asin, std::atan2, std::sqrt
+#include <cstddef>   // size_t
+#include <cstdint>   // int-Typen
+#include <stdexcept> // std::overflow_error
+#include <vector>    // std::vector
+
+/// Eigene Header
+#include "sphere.hpp"   // PreparedCoordinate, Point, PeakPosition, clampUnit, r_E
+#include "store.hpp"    // CoordinateView, withTrig
+#include "executor.hpp" // ThreadPool
+
+// Strecke A->B mit vorberechneter Geometrie:
+struct FenceLeg
+{
+    float a[3], b[3]; // Einheitsvektoren von A und B
+    float n[3];       // Normale des Großkreises
+    float t[3];       // Tangente in A Richtung B
+    float m[3];       // Mitte des Bogens
+    float zeta;       // Zentriwinkel A-B (rad)
+    uint32_t from, to;
+
+    // Wirft bei gleichen oder gegenüberliegenden Punkten (Großkreis nicht eindeutig):
+    FenceLeg(const PreparedCoordinate &A, const PreparedCoordinate &B) : from(A.id), to(B.id)
+    {
+        const double va[3]{double{A.cosPhi} * A.cosLambda, double{A.cosPhi} * A.sinLambda, double{A.sinPhi}};
+        const double vb[3]{double{B.cosPhi} * B.cosLambda, double{B.cosPhi} * B.sinLambda, double{B.sinPhi}};
+        const double c[3]{va[1] * vb[2] - va[2] * vb[1], va[2] * vb[0] - va[0] * vb[2], va[0] * vb[1] - va[1] * vb[0]};
+        const auto norm{std::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2])};
+
+        if (norm < 1e-9)
+            throw std::overflow_error("Großkreis durch A und B ist nicht eindeutig!");
+
+        double mid[3]{va[0] + vb[0], va[1] + vb[1], va[2] + vb[2]};
+        const auto midNorm{std::sqrt(mid[0] * mid[0] + mid[1] * mid[1] + mid[2] * mid[2])};
+
+        for (int k = 0; k < 3; k++)
+        {
+            a[k] = static_cast<float>(va[k]);
+            b[k] = static_cast<float>(vb[k]);
+            n[k] = static_cast<float>(c[k] / norm);
+            m[k] = static_cast<float>(mid[k] / midNorm);
+        }
+        for (int k = 0; k < 3; k++)
+            t[k] = static_cast<float>((c[(k + 1) % 3] * va[(k + 2) % 3] - c[(k + 2) % 3] * va[(k + 1) % 3]) / norm);
+
+        zeta = static_cast<float>(std::atan2(norm, va[0] * vb[0] + va[1] * vb[1] + va[2] * vb[2]));
+    }
+
+    // Punkt auf dem Großkreis im Abstand along (km) von A:
+    Point at(float along) const noexcept
+    {
+        const auto s{along / r_E};
+        const auto cs{std::cos(s)}, sn{std::sin(s)};
+        const auto x{a[0] * cs + t[0] * sn}, y{a[1] * cs + t[1] * sn}, z{a[2] * cs + t[2] * sn};
+        return Point{std::atan2(z, std::sqrt(x * x + y * y)), std::atan2(y, x)};
+    }
+};
+
+// Lage einer Position zu einer Strecke (alle Abstände in km):
+struct CrossTrack
+{
+    float cross;           // Querabstand zum Großkreis, positiv links der Flugrichtung
+    float along;           // Abstand des Lotfußpunkts von A entlang des Großkreises, in (-pi; pi] * r_E
+    float distance;        // kürzester Abstand zur Strecke
+    PeakPosition position; // Zwischen: Lotfußpunkt auf der Strecke, sonst näherer Endpunkt VorA bzw. HinterB
+
+    // Punkt der größten Annäherung auf der Strecke:
+    Point closest(const FenceLeg &leg) const noexcept
+    {
+        return leg.at((position == PeakPosition::Zwischen) ? along : (position == PeakPosition::VorA) ? 0.0f : leg.zeta * r_E);
+    }
+};
+
+namespace geofence
+{
+    // Winkelabstand zweier Einheitsvektoren über die Sehne (gut konditioniert auch für kleine Winkel):
+    inline float chordAngle(float x, float y, float z, const float *v) noexcept
+    {
+        const auto dx{x - v[0]}, dy{y - v[1]}, dz{z - v[2]};
+        return 2.0f * std::asin(std::min(1.0f, 0.5f * std::sqrt(dx * dx + dy * dy + dz * dz)));
+    }
+
+    inline CrossTrack calcCrossTrack(const FenceLeg &leg, float x, float y, float z) noexcept
+    {
+        const auto s{clampUnit(x * leg.n[0] + y * leg.n[1] + z * leg.n[2])};
+        const auto along{std::atan2(x * leg.t[0] + y * leg.t[1] + z * leg.t[2], x * leg.a[0] + y * leg.a[1] + z * leg.a[2])};
+        const auto cross{std::asin(s)};
+
+        if ((along >= 0.0f) && (along <= leg.zeta))
+            return CrossTrack{cross * r_E, along * r_E, std::fabs(cross) * r_E, PeakPosition::Zwischen};
+
+        const auto dA{chordAngle(x, y, z, leg.a)}, dB{chordAngle(x, y, z, leg.b)};
+        return CrossTrack{cross * r_E, along * r_E, std::min(dA, dB) * r_E, (dA <= dB) ? PeakPosition::VorA : PeakPosition::HinterB};
+    }
+} // namespace geofence
+
+inline CrossTrack calcCrossTrack(const FenceLeg &leg, const PreparedCoordinate &P) noexcept
+{
+    return geofence::calcCrossTrack(leg, P.cosPhi * P.cosLambda, P.cosPhi * P.sinLambda, P.sinPhi);
+}
+
+// Treffer einer Korridorprüfung:
+struct FenceHit
+{
+    uint32_t point; // ID der Position
+    uint32_t leg;   // Index der Strecke
+    CrossTrack track;
+};
+
+// Alle Paare (Position, Strecke) mit kürzestem Abstand <= km, sortiert nach Position und Strecke. Mit pool werden
+// Blöcke von Positionen parallel geprüft, das Ergebnis bleibt gleich.
+inline std::vector<FenceHit> checkGeofence(const CoordinateView &coords, const FenceLeg *legs, size_t legCount, float km, ThreadPool *pool = nullptr)
+{
+    TrigColumns derived;
+    const auto points{withTrig(coords, derived)};
+    constexpr size_t Block{256};
+    constexpr float Slack{1e-6f}; // Rundung der float-Skalarprodukte, Vorauswahl bleibt konservativ
+
+    // Schwellen der Vorauswahl je Strecke:
+    const auto d{km / r_E};
+    std::vector<float> capCos(legCount), bandSin(legCount);
+    for (size_t l = 0; l < legCount; l++)
+    {
+        const auto cap{0.5f * legs[l].zeta + d};
+        capCos[l] = ((cap >= static_cast<float>(M_PI)) ? -1.0f : std::cos(cap)) - Slack;
+        bandSin[l] = ((d >= static_cast<float>(M_PI / 2)) ? 1.0f : std::sin(d)) + Slack;
+    }
+
+    const auto scan = [&](size_t begin, size_t end, std::vector<FenceHit> &hits) {
+        float x[Block], y[Block], z[Block];
+        uint32_t candidates[Block];
+
+        for (size_t first = begin; first < end; first += Block)
+        {
+            const auto count{std::min(Block, end - first)};
+            for (size_t i = 0; i < count; i++)
+            {
+                const auto p{first + i};
+                x[i] = points.cosPhi[p] * points.cosLambda[p];
+                y[i] = points.cosPhi[p] * points.sinLambda[p];
+                z[i] = points.sinPhi[p];
+            }
+
+            const auto blockStart{hits.size()};
+            for (size_t l = 0; l < legCount; l++)
+            {
+                const auto &leg{legs[l]};
+
+                // Vorauswahl verzweigungsfrei (Kandidaten werden kompaktiert):
+                size_t n{0};
+                for (size_t i = 0; i < count; i++)
+                {
+                    const auto inCap{x[i] * leg.m[0] + y[i] * leg.m[1] + z[i] * leg.m[2] >= capCos[l]};
+                    const auto inBand{std::fabs(x[i] * leg.n[0] + y[i] * leg.n[1] + z[i] * leg.n[2]) <= bandSin[l]};
+                    candidates[n] = static_cast<uint32_t>(i);
+                    n += (inCap && inBand);
+                }
+
+                for (size_t c = 0; c < n; c++)
+                {
+                    const auto i{candidates[c]};
+                    const auto track{geofence::calcCrossTrack(leg, x[i], y[i], z[i])};
+                    if (track.distance <= km)
+                        hits.push_back(FenceHit{static_cast<uint32_t>(first + i), static_cast<uint32_t>(l), track});
+                }
+            }
+
+            // Innerhalb des Blocks nach Position ordnen (Strecken sind je Position bereits aufsteigend):
+            std::stable_sort(hits.begin() + static_cast<std::ptrdiff_t>(blockStart), hits.end(),
+                             [](const FenceHit &l, const FenceHit &r) { return l.point < r.point; });
+        }
+    };
+
+    std::vector<FenceHit> hits;
+    if (!pool || (pool->size() == 1))
+    {
+        scan(0, points.size(), hits);
+        return hits;
+    }
+
+    constexpr size_t Grain{16 * Block};
+    std::vector<std::vector<FenceHit>> parts((points.size() + Grain - 1) / Grain);
+    pool->parallelFor(points.size(), Grain, [&](size_t begin, size_t end) { scan(begin, end, parts[begin / Grain]); });
+    for (const auto &part : parts)
+        hits.insert(hits.end(), part.begin(), part.end());
+    return hits;
+}
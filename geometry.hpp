@@ -0,0 +1,351 @@
+// Rechenkern auf der Kugel ohne Ein-/Ausgabe: Konstanten, vorbereitete Koordinaten und alle Funktionen im Bogenmaß
+//
+// Dieser Header ist Teil der einbettbaren Bibliothek (libtrig.hpp) und bindet deshalb weder output.hpp noch die
+// Strukturen im Grad/Minuten/Sekunden-Format ein; Anzeige und Coordinate liegen in sphere.hpp.
+// Winkel werden standardmäßig im Bogenmaß übergeben!
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>   // std::min, std::max
+#include <cmath>       // PI
+#include <cstdint>     // int-Typen
+#include <string_view> // std::string_view
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::common_type
+#include <stdexcept>   // Exceptions
+
+/// Globale Variablen
+const auto r_E{6378.137f};         // Erdradius in [km]
+template <class T>
+constexpr T earthRadius{6378.137}; // Erdradius in [km] im jeweiligen Skalartyp
+template <>
+constexpr float earthRadius<float>{6378.137f};
+constexpr auto rad{M_PI / 180.0f}; // Radiant (1 Grad = 180 Grad / pi)
+
+template <class T>
+inline T deg2rad(T angle) noexcept
+{
+    return (angle * M_PI / T{180});
+}
+
+template <class T>
+inline T rad2deg(T angle) noexcept
+{
+    return (angle * T{180} / M_PI);
+}
+
+// Rechenweise der Kernfunktionen, zur Laufzeit wählbar (--backend, Auswahl in nvector.hpp):
+enum class Backend
+{
+    Trig,   // Kugeltrigonometrie (sphere.hpp)
+    NVector // Einheitsvektoren (nvector.hpp)
+};
+
+// Erdmodell für Strecken (Befehle 4 und 6), zur Laufzeit wählbar (--earth, Strecken in ellipsoid.hpp):
+enum class Earth
+{
+    Sphere, // Kugel mit r_E
+    WGS84   // Ellipsoid
+};
+
+/// Vorbereitete Koordinaten
+// Alle Winkelfunktionen einer Koordinate werden einmalig beim Laden berechnet, sodass eine paarweise Abfrage
+// nur noch die unvermeidbaren Umkehrfunktionen (arccos, atan2) auswerten muss.
+// Der Skalartyp T (float bzw. double) wird zur Übersetzungszeit gewählt, siehe PreparedCoordinate/PreparedCoordinateD.
+template <class T>
+struct BasicPreparedCoordinate
+{
+    T phi;       // Breitengrad im Bogenmaß
+    T lambda;    // Längengrad im Bogenmaß
+    T sinPhi;    // sin(phi)
+    T cosPhi;    // cos(phi)
+    T sinLambda; // sin(lambda)
+    T cosLambda; // cos(lambda)
+    T sigma;     // Mercator-Ordinate sigma(phi) = ln(tan(pi/4 + phi/2))
+
+    std::string_view name; // verweist auf den Bezeichner der Quelle, diese muss die vorbereitete Koordinate überleben!
+    uint32_t id;           // fortlaufende Nummer (Index im Koordinatenspeicher)
+
+    BasicPreparedCoordinate(T _phi, T _lambda, std::string_view _name = {}, uint32_t _id = 0) noexcept
+        : phi(_phi), lambda(_lambda), sinPhi(std::sin(_phi)), cosPhi(std::cos(_phi)), sinLambda(std::sin(_lambda)), cosLambda(std::cos(_lambda)),
+          sigma(std::log(std::tan(static_cast<T>(M_PI / 4 + _phi / 2)))), name(_name), id(_id) {}
+
+    // Übernimmt bereits vorberechnete Werte (z.B. aus einem Koordinatenspeicher):
+    BasicPreparedCoordinate(T _phi, T _lambda, T _sinPhi, T _cosPhi, T _sinLambda, T _cosLambda, T _sigma, std::string_view _name, uint32_t _id) noexcept
+        : phi(_phi), lambda(_lambda), sinPhi(_sinPhi), cosPhi(_cosPhi), sinLambda(_sinLambda), cosLambda(_cosLambda), sigma(_sigma), name(_name), id(_id) {}
+};
+
+using PreparedCoordinate = BasicPreparedCoordinate<float>;   // Durchsatz, z.B. für Massenabfragen
+using PreparedCoordinateD = BasicPreparedCoordinate<double>; // Genauigkeit im Meterbereich, z.B. für Endergebnisse
+
+// Skalare Parameter neben Koordinaten sollen den Typ nicht mitbestimmen (z.B. calcCrashPoint(A, B, 800.0, ...)):
+template <class T>
+using Scalar = typename std::common_type<T>::type;
+
+// Begrenzt x auf [-1; 1], um Rundungsfehler vor arccos abzufangen. Ergebnis wie fmin/fmax (auch für NaN -> -1),
+// aber ohne libm-Aufruf:
+template <class T>
+inline T clampUnit(T x) noexcept
+{
+    return std::min(T{1}, std::max(T{-1}, x));
+}
+
+// Kosinus des Zentriwinkels (Skalarprodukt der Ortsvektoren), ohne Winkelfunktion:
+template <class T>
+inline T calcCosGCD(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+{
+    // cos(lambda_b - lambda_a) = cos(lambda_a)cos(lambda_b) + sin(lambda_a)sin(lambda_b)
+    const auto cosDeltaLambda{A.cosLambda * B.cosLambda + A.sinLambda * B.sinLambda};
+    return clampUnit(A.sinPhi * B.sinPhi + A.cosPhi * B.cosPhi * cosDeltaLambda); // Rundungsfehler abfangen
+}
+
+// Zentriwinkel (1 x arccos):
+template <class T>
+inline T calcGCDrad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+{
+    return std::acos(calcCosGCD(A, B));
+}
+
+// Strecke auf Großkreis in [km] (1 x arccos):
+template <class T>
+inline T calcGCDkm(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+{
+    return calcGCDrad(A, B) * earthRadius<T>;
+}
+
+// Kosinus des Kurswinkels von A nach B bei bekanntem Kosinus des Zentriwinkels, ohne Winkelfunktion. Liefert false
+// (ohne Exception), wenn der Kurswinkel unbestimmt ist (A und B gleich bzw. gegenüberliegend):
+template <class T>
+inline bool calcCosAlpha(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> cosZeta, T &cosAlpha) noexcept
+{
+    const auto sinZeta{std::sqrt(T{1} - cosZeta * cosZeta)}; // Zentriwinkel liegt in [0; pi], sin >= 0
+
+    if (sinZeta == 0)
+        return false; // Division durch Null
+
+    cosAlpha = clampUnit((B.sinPhi - A.sinPhi * cosZeta) / (A.cosPhi * sinZeta));
+    return true;
+}
+
+// Wie oben, wirft bei unbestimmtem Kurswinkel:
+template <class T>
+inline T calcCosAlpha(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> cosZeta)
+{
+    T cosAlpha;
+    if (!calcCosAlpha(A, B, cosZeta, cosAlpha))
+        throw std::overflow_error("Division durch Null!"); // Division durch Null abfangen
+    return cosAlpha;
+}
+
+// Kurswinkel (1 x arccos), liefert false bei unbestimmtem Kurswinkel:
+template <class T>
+inline bool calcAlphaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, T &alpha) noexcept
+{
+    T cosAlpha;
+    if (!calcCosAlpha(A, B, calcCosGCD(A, B), cosAlpha))
+        return false;
+    alpha = std::acos(cosAlpha);
+    return true;
+}
+
+// Kurswinkel (1 x arccos):
+template <class T>
+inline T calcAlphaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B)
+{
+    return std::acos(calcCosAlpha(A, B, calcCosGCD(A, B)));
+}
+
+// Kurswinkel im Ziel (1 x arccos):
+template <class T>
+inline T calcBetaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B)
+{
+    return calcAlphaRad(B, A);
+}
+
+// Loxodromischer Kurs (1 x atan2, sigma liegt bereits vor):
+template <class T>
+inline T calcLoxodromicCourse(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+{
+    return std::atan2(B.lambda - A.lambda, B.sigma - A.sigma);
+}
+
+// Kurs und Länge einer Loxodrome:
+template <class T>
+struct BasicLoxodrome
+{
+    T course; // rad
+    T length; // km
+};
+
+// Kurs und Länge in einem Aufruf (1 x atan2, 1 x hypot). Länge = R * sqrt(dphi^2 + (q * dlambda)^2) mit q = dphi / dsigma;
+// auf (nahezu) gleicher Breite geht q gegen cos(phi), der Quotient wird dort durch den Grenzwert ersetzt:
+template <class T>
+inline BasicLoxodrome<T> calcLoxodrome(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+{
+    const auto dPhi{B.phi - A.phi};
+    const auto dLambda{B.lambda - A.lambda};
+    const auto dSigma{B.sigma - A.sigma};
+
+    const auto parallel{std::fabs(dSigma) < std::sqrt(std::numeric_limits<T>::epsilon())};
+    const auto q{parallel ? (A.cosPhi + B.cosPhi) / 2 : dPhi / dSigma};
+
+    return BasicLoxodrome<T>{std::atan2(dLambda, dSigma), earthRadius<T> * std::hypot(dPhi, q * dLambda)};
+}
+
+// Loxodromische Länge (keine Winkelfunktion außer hypot, auch entlang eines Breitenkreises):
+template <class T>
+inline T calcLoxodromicLength(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+{
+    return calcLoxodrome(A, B).length;
+}
+
+// Punkt auf der Kugel im Bogenmaß (Ergebnis ohne Bezeichner, z.B. für Stapelberechnungen):
+template <class T>
+struct BasicPoint
+{
+    T phi;
+    T lambda;
+};
+
+using Point = BasicPoint<float>;
+
+// Nördlichster Punkt auf Großkreis bei bekanntem Kurswinkel alpha in A:
+template <class T>
+inline BasicPoint<T> calcNorthPeakPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> alpha) noexcept
+{
+    // Sonderfall: Orthodrom == Meridian, Scheitelpunkt ist der Nordpol
+    if (A.lambda == B.lambda)
+        return BasicPoint<T>{static_cast<T>(M_PI / 2), T{0}};
+
+    // Umgeht Singularität von Wechsel -180 - +180 Grad
+    auto deltaLambda{A.lambda - B.lambda};
+    if (deltaLambda > M_PI)
+        deltaLambda -= 2 * M_PI;
+    else if (deltaLambda < -M_PI)
+        deltaLambda += 2 * M_PI;
+
+    // Scheitelpunkt s: cos(phi_s) = sin(alpha) * cos(phi_a)
+    const auto cosPhi_s{std::sin(alpha) * A.cosPhi};
+    const auto phi_s{std::acos(cosPhi_s)};
+    const auto tanPhi_s{std::sqrt(T{1} - cosPhi_s * cosPhi_s) / cosPhi_s};
+    const auto offset{std::acos(clampUnit((A.sinPhi / A.cosPhi) / tanPhi_s))};
+
+    // Der Scheitelpunkt liegt in Flugrichtung voraus, wenn A nach Norden verlassen wird (alpha < 90 Grad), sonst vor A:
+    const bool voraus{alpha < M_PI / 2};
+    const bool osten{(deltaLambda < 0) == voraus}; // Längengrad des Scheitelpunkts liegt östlich von A
+
+    const auto lambda_s{osten ? A.lambda + offset : A.lambda - offset};
+
+    return BasicPoint<T>{phi_s, lambda_s};
+}
+
+// Grobe Lage des Scheitelpunkts relativ zum Bogen AB:
+enum class PeakPosition
+{
+    Zwischen,  // innerhalb des Bogens
+    VorA,      // vor A
+    HinterB,   // hinter B
+    Unbestimmt // Meridian bzw. beide Kurswinkel stumpf
+};
+
+// Bestimmt die Lage aus Abflugswinkel alpha und Anflugswinkel beta (im Bogenmaß):
+template <class T>
+inline PeakPosition classifyPeak(T alpha, Scalar<T> beta) noexcept
+{
+    const auto spitz = [](T w) { return (w > T{0}) && (w < M_PI / 2); };
+    const auto stumpf = [](T w) { return (w > M_PI / 2) && (w < M_PI); };
+
+    if (spitz(alpha) && spitz(beta))
+        return PeakPosition::Zwischen;
+    else if (stumpf(alpha) && spitz(beta))
+        return PeakPosition::VorA;
+    else if (spitz(alpha) && stumpf(beta))
+        return PeakPosition::HinterB;
+    return PeakPosition::Unbestimmt;
+}
+
+// Abstand des Zwischenpunkts von A in rad auf einem Bogen mit Zentriwinkel zeta. Verhältnis der Flugstrecke zur
+// Strecke A-B, bei > 1 wird ab B zurückgeflogen (Pendeln zwischen A und B). Gerade/ungerade über fmod statt Umwandlung
+// in eine ganze Zahl, die bei sehr großem, negativem oder nicht endlichem Verhältnis undefiniert wäre:
+template <class T>
+inline T calcFlightDistanceRad(T zeta, Scalar<T> v, Scalar<T> fuel, Scalar<T> k) noexcept
+{
+    const auto eAB{zeta * earthRadius<T>}; // Strecke in km
+    const auto prop{(v * fuel) / (eAB * k)};
+    T integral;
+    const auto frac{std::modf(prop, &integral)};
+    return ((std::fmod(integral, T{2}) != 0) ? 1 - frac : frac) * zeta;
+}
+
+// Zwischenpunkt auf Großkreis (v == Speed, k == Verbrauch), Zentriwinkel und Kurswinkel werden nur einmal berechnet.
+// Liefert false (ohne Exception), wenn der Kurswinkel unbestimmt ist (gegenüberliegende Punkte abseits eines Meridians):
+template <class T>
+inline bool calcCrashPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> v, Scalar<T> fuel, Scalar<T> k,
+                              BasicPoint<T> &p) noexcept
+{
+    const auto cosZeta{calcCosGCD(A, B)};
+    const auto zeta{std::acos(cosZeta)};                        // Zentriwinkel in rad
+    const auto distance{calcFlightDistanceRad(zeta, v, fuel, k)}; // Strecke von A in rad
+
+    const auto sinD{std::sin(distance)};
+    const auto cosD{std::cos(distance)};
+
+    if (A.lambda == B.lambda) // Sonderfall: Flug entlang eines Meridians
+    {
+        // Der Breitengrad wird auf das Intervall (-pi; pi] gemappt (Westhälfte des Meridiankreises jenseits der Pole):
+        const auto transformPhi = [](T phi_x, T lambda_x) -> T {
+            if (lambda_x >= 0)
+                return phi_x;
+            return (phi_x >= 0) ? M_PI - phi_x : -M_PI - phi_x;
+        };
+
+        const auto phi_a_dach{transformPhi(A.phi, A.lambda)};
+        auto deltaPhi_dach{phi_a_dach - transformPhi(B.phi, B.lambda)};
+        if (deltaPhi_dach > M_PI)
+            deltaPhi_dach -= 2 * M_PI;
+        else if (deltaPhi_dach < -M_PI)
+            deltaPhi_dach += 2 * M_PI;
+
+        auto phi_p{(deltaPhi_dach >= 0) ? phi_a_dach - distance : phi_a_dach + distance}; // Süden bzw. Norden
+        if (phi_p > M_PI / 2)
+            phi_p = M_PI - phi_p;
+        else if (phi_p < -M_PI / 2)
+            phi_p = -M_PI - phi_p;
+
+        // A und B liegen auf demselben Halbmeridian, der Bogen A-B (distance <= zeta) führt nicht über einen Pol:
+        p = BasicPoint<T>{static_cast<T>(phi_p), A.lambda};
+        return true;
+    }
+
+    T cosAlpha;
+    if (!calcCosAlpha(A, B, cosZeta, cosAlpha))
+        return false;
+
+    const auto sinPhi_p{cosD * A.sinPhi + sinD * A.cosPhi * cosAlpha};
+    const auto phi_p{std::asin(sinPhi_p)};
+    const auto cosPhi_p{std::sqrt(T{1} - sinPhi_p * sinPhi_p)};
+
+    // arccos() bildet nur auf [0; pi] ab, daher Flugrichtung zusätzlich in Abhängigkeit von der Strecke behandeln.
+    // Wechsel -180 - +180 Grad: kürzerer Weg, sonst würde bei Strecken über die Datumsgrenze die falsche Richtung gewählt
+    auto deltaLambda{A.lambda - B.lambda};
+    if (deltaLambda > M_PI)
+        deltaLambda -= 2 * M_PI;
+    else if (deltaLambda < -M_PI)
+        deltaLambda += 2 * M_PI;
+    const auto offset{std::acos(clampUnit((cosD - A.sinPhi * sinPhi_p) / (A.cosPhi * cosPhi_p)))};
+    const bool osten{((deltaLambda < 0) && (distance <= M_PI)) || ((deltaLambda > 0) && (distance > M_PI))};
+    const auto lambda_p{osten ? A.lambda + offset : A.lambda - offset};
+
+    p = BasicPoint<T>{phi_p, lambda_p};
+    return true;
+}
+
+// Wie oben, wirft bei unbestimmtem Kurswinkel:
+template <class T>
+inline BasicPoint<T> calcCrashPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> v, Scalar<T> fuel, Scalar<T> k)
+{
+    BasicPoint<T> p;
+    if (!calcCrashPointRad(A, B, v, fuel, k, p))
+        throw std::overflow_error("Division durch Null!");
+    return p;
+}
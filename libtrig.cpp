@@ -0,0 +1,288 @@
+// Stapelfunktionen der Bibliothek (siehe libtrig.hpp). Wird als libtrig.a bzw. libtrig.so übersetzt.
+
+/// Standardbibliotheken
+#include <algorithm> // std::min
+#include <cmath>     // std::sin, std::cos, std::log, std::tan
+#include <limits>    // std::numeric_limits
+
+/// Eigene Header
+#include "libtrig.hpp"
+#include "store.hpp"     // CoordinateView
+#include "batch.hpp"     // calcGCDRows, Vektorkerne
+#include "nvector.hpp"   // Auswahl der Rechenweise
+#include "ellipsoid.hpp" // Strecken auf dem Ellipsoid
+
+namespace trig
+{
+    namespace
+    {
+        constexpr auto NaN{std::numeric_limits<float>::quiet_NaN()};
+        constexpr size_t Block{256}; // Punkte je Block der paarweisen Funktionen (2 x 7 KiB Spalten auf dem Stack)
+
+        // Prüft die Längen (a: eins oder wie b, alle Ausgaben wie b):
+        template <class... Out>
+        bool fits(Span<const Point> a, Span<const Point> b, const Out &...out) noexcept
+        {
+            return ((a.size() == 1) || (a.size() == b.size())) && ((out.size() == b.size()) && ...);
+        }
+
+        // Spalten eines Blocks, Aufbau wie bei prepareColumns (je Spalte n Werte hintereinander):
+        struct Columns
+        {
+            const float *phi, *lambda, *sinPhi, *cosPhi, *sinLambda, *cosLambda, *sigma;
+
+            PreparedCoordinate at(size_t i) const noexcept
+            {
+                return PreparedCoordinate{phi[i], lambda[i], sinPhi[i], cosPhi[i], sinLambda[i], cosLambda[i], sigma[i], {}, 0};
+            }
+        };
+
+        // Wertet die Winkelfunktionen zu points einmal aus und legt sie in col (7 * points.size() Werte) ab. Ohne Sigma
+        // bleibt die Mercator-Ordinate (log/tan) 0, sie wird nur für die Loxodrome benötigt:
+        template <bool Sigma>
+        Columns fill(Span<const Point> points, float *col) noexcept
+        {
+            const auto n{points.size()};
+            for (size_t i = 0; i < n; i++)
+            {
+                const auto &p{points[i]};
+                col[i] = p.phi;
+                col[n + i] = p.lambda;
+                col[2 * n + i] = std::sin(p.phi);
+                col[3 * n + i] = std::cos(p.phi);
+                col[4 * n + i] = std::sin(p.lambda);
+                col[5 * n + i] = std::cos(p.lambda);
+                col[6 * n + i] = Sigma ? std::log(std::tan(static_cast<float>(M_PI / 4 + p.phi / 2))) : 0.0f;
+            }
+            return Columns{col, col + n, col + 2 * n, col + 3 * n, col + 4 * n, col + 5 * n, col + 6 * n};
+        }
+
+        // Ruft body(first, count, A, B, single) je Block von b auf. Ein einzelner Startpunkt wird nur einmal vorbereitet
+        // (single == true, dann gilt A.at(0) für alle Paare). body liefert false für unbestimmte Ergebnisse:
+        template <bool Sigma = false, class Body>
+        Status forEachBlock(Span<const Point> a, Span<const Point> b, Body &&body) noexcept
+        {
+            float colA[7 * Block], colB[7 * Block];
+            const auto single{a.size() == 1};
+            const auto first{single ? fill<Sigma>(a, colA) : Columns{}};
+            auto status{Status::Ok};
+
+            for (size_t j = 0; j < b.size(); j += Block)
+            {
+                const auto count{std::min(Block, b.size() - j)};
+                const auto B{fill<Sigma>(Span<const Point>(b.data() + j, count), colB)};
+                const auto A{single ? first : fill<Sigma>(Span<const Point>(a.data() + j, count), colA)};
+                if (!body(j, count, A, B, single))
+                    status = Status::Undefined;
+            }
+            return status;
+        }
+
+        // Wie forEachBlock, ruft pair(i, A, B) für jedes Paar auf:
+        template <bool Sigma = false, class Pair>
+        Status forEachPair(Span<const Point> a, Span<const Point> b, Pair &&pair) noexcept
+        {
+            return forEachBlock<Sigma>(a, b, [&pair](size_t first, size_t count, const Columns &A, const Columns &B, bool single) {
+                bool defined{true};
+                for (size_t i = 0; i < count; i++)
+                    if (!pair(first + i, A.at(single ? 0 : i), B.at(i)))
+                        defined = false;
+                return defined;
+            });
+        }
+
+        // Einmalig ermittelter Befehlssatz der Kerne:
+        Isa isa(void) noexcept
+        {
+            static const Isa best{detectIsa()};
+            return best;
+        }
+
+        // Zentriwinkel mal radius über die Vektorkerne (Zeilenkern für einen Startpunkt, sonst paarweise):
+        Status arcs(Span<const Point> a, Span<const Point> b, float radius, Span<float> out) noexcept
+        {
+            const auto row{batch::kernelFor(isa())};
+            const auto pairs{batch::pairKernelFor(isa())};
+
+            return forEachBlock(a, b, [=](size_t first, size_t count, const Columns &A, const Columns &B, bool single) {
+                if (single)
+                    row(A.sinPhi[0], A.cosPhi[0], A.sinLambda[0], A.cosLambda[0], B.sinPhi, B.cosPhi, B.sinLambda, B.cosLambda, count, radius,
+                        out.data() + first);
+                else
+                    pairs(A.sinPhi, A.cosPhi, A.sinLambda, A.cosLambda, B.sinPhi, B.cosPhi, B.sinLambda, B.cosLambda, count, radius,
+                          out.data() + first);
+                return true;
+            });
+        }
+    } // namespace
+
+    Status evaluate(int cmd, const PreparedCoordinate &A, const PreparedCoordinate &B, const float *params, Result &res, Backend backend,
+                    Earth earth) noexcept
+    {
+        res = Result{};
+        switch (cmd)
+        {
+        case 1:
+            res.value = rad2deg(calcGCDrad(A, B, backend));
+            res.unit = "Grad";
+            return Status::Ok;
+        case 2:
+        {
+            float alpha;
+            if (!calcAlphaRad(A, B, backend, alpha))
+                return Status::Undefined;
+            res.value = rad2deg(alpha);
+            res.unit = "Grad";
+            return Status::Ok;
+        }
+        case 3:
+        {
+            // Meridian: Scheitelpunkt ist der Nordpol, Kurswinkel werden nicht benötigt
+            const auto meridian{A.lambda == B.lambda};
+            float alpha{0.0f}, beta{0.0f};
+            Point peak;
+            if (!meridian && !(calcAlphaRad(A, B, backend, alpha) && calcAlphaRad(B, A, backend, beta)))
+                return Status::Undefined;
+            if (!calcNorthPeakPointRad(A, B, alpha, backend, peak))
+                return Status::Undefined;
+            res.point = true;
+            res.phi = peak.phi;
+            res.lambda = peak.lambda;
+            res.position = meridian ? PeakPosition::Unbestimmt : classifyPeak(alpha, beta);
+            return Status::Ok;
+        }
+        case 4:
+            res.value = (earth == Earth::WGS84) ? calcGeodesicKm(A, B) : calcGCDkm(A, B, backend);
+            res.unit = "km";
+            return Status::Ok;
+        case 5:
+            res.value = rad2deg(calcLoxodromicCourse(A, B));
+            res.unit = "Grad";
+            return Status::Ok;
+        case 6:
+            res.value = calcLoxodromicLength(A, B, earth);
+            res.unit = "km";
+            return Status::Ok;
+        case 7:
+        {
+            Point p;
+            if (!calcCrashPointRad(A, B, params[0], params[1], params[2], backend, p))
+                return Status::Undefined;
+            res.point = true;
+            res.phi = p.phi;
+            res.lambda = p.lambda;
+            return Status::Ok;
+        }
+        default:
+            return Status::UnknownCommand;
+        }
+    }
+
+    Status centralAngles(Span<const Point> a, Span<const Point> b, Span<float> rad) noexcept
+    {
+        if (!fits(a, b, rad))
+            return Status::SizeMismatch;
+
+        return arcs(a, b, 1.0f, rad);
+    }
+
+    Status courses(Span<const Point> a, Span<const Point> b, Span<float> rad) noexcept
+    {
+        if (!fits(a, b, rad))
+            return Status::SizeMismatch;
+
+        return forEachPair(a, b, [rad](size_t i, const PreparedCoordinate &A, const PreparedCoordinate &B) {
+            float alpha;
+            const auto defined{calcAlphaRad(A, B, alpha)};
+            rad[i] = defined ? alpha : NaN;
+            return defined;
+        });
+    }
+
+    Status northPeaks(Span<const Point> a, Span<const Point> b, Span<Point> peaks) noexcept
+    {
+        if (!fits(a, b, peaks))
+            return Status::SizeMismatch;
+
+        return forEachPair(a, b, [peaks](size_t i, const PreparedCoordinate &A, const PreparedCoordinate &B) {
+            float alpha{0.0f}; // Meridian: Scheitelpunkt ist der Nordpol, Kurswinkel wird nicht benötigt
+            const auto defined{(A.lambda == B.lambda) || calcAlphaRad(A, B, alpha)};
+            peaks[i] = defined ? calcNorthPeakPointRad(A, B, alpha) : Point{NaN, NaN};
+            return defined;
+        });
+    }
+
+    Status distances(Span<const Point> a, Span<const Point> b, Span<float> km) noexcept
+    {
+        if (!fits(a, b, km))
+            return Status::SizeMismatch;
+
+        return arcs(a, b, r_E, km);
+    }
+
+    Status loxodromes(Span<const Point> a, Span<const Point> b, Span<float> course, Span<float> km) noexcept
+    {
+        if (!fits(a, b, course, km))
+            return Status::SizeMismatch;
+
+        return forEachPair<true>(a, b, [course, km](size_t i, const PreparedCoordinate &A, const PreparedCoordinate &B) {
+            const auto lox{calcLoxodrome(A, B)};
+            course[i] = lox.course;
+            km[i] = lox.length;
+            return true;
+        });
+    }
+
+    Status crashPoints(Span<const Point> a, Span<const Point> b, float v, float fuel, float k, Span<Point> points) noexcept
+    {
+        if (!fits(a, b, points))
+            return Status::SizeMismatch;
+
+        return forEachPair(a, b, [=](size_t i, const PreparedCoordinate &A, const PreparedCoordinate &B) {
+            const auto defined{calcCrashPointRad(A, B, v, fuel, k, points[i])};
+            if (!defined)
+                points[i] = Point{NaN, NaN};
+            return defined;
+        });
+    }
+
+    Status prepareColumns(Span<const Point> points, Span<float> columns, CoordinateView &view) noexcept
+    {
+        const auto n{points.size()};
+        if (columns.size() < 7 * n)
+            return Status::SizeMismatch;
+
+        const auto col{fill<true>(points, columns.data())};
+        view = CoordinateView{};
+        view.count = n;
+        view.phi = col.phi;
+        view.lambda = col.lambda;
+        view.sinPhi = col.sinPhi;
+        view.cosPhi = col.cosPhi;
+        view.sinLambda = col.sinLambda;
+        view.cosLambda = col.cosLambda;
+        view.sigma = col.sigma;
+        return Status::Ok;
+    }
+
+    Status distanceMatrix(const CoordinateView &coords, Span<float> out, MatrixLayout layout) noexcept
+    {
+        return distanceMatrixRows(coords, 0, coords.size(), out, layout);
+    }
+
+    Status distanceMatrix(Span<const Point> points, Span<float> columns, Span<float> out, MatrixLayout layout) noexcept
+    {
+        CoordinateView view;
+        const auto status{prepareColumns(points, columns, view)};
+        return (status == Status::Ok) ? distanceMatrix(view, out, layout) : status;
+    }
+
+    Status distanceMatrixRows(const CoordinateView &coords, size_t rowBegin, size_t rowEnd, Span<float> out, MatrixLayout layout) noexcept
+    {
+        if (out.size() < matrixSize(coords.size(), layout))
+            return Status::SizeMismatch;
+
+        calcGCDRows(coords, rowBegin, rowEnd, out.data(), layout, isa());
+        return Status::Ok;
+    }
+} // namespace trig
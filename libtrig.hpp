@@ -0,0 +1,110 @@
+// Einbettbare Bibliothek (libtrig.a / libtrig.so): Rechenfunktionen auf der Kugel ohne Ein-/Ausgabe
+//
+// Skalare Funktionen stehen inline in geometry.hpp (PreparedCoordinate, calcGCDkm, calcAlphaRad, ...), die
+// Stapelfunktionen hier werden in libtrig.cpp übersetzt. Sie arbeiten auf Spans aus Eingabekoordinaten (Point, Winkel
+// im Bogenmaß) und Ausgabepuffern des Aufrufers, werfen keine Exceptions, fordern keinen Speicher an und geben nichts
+// aus. Unbestimmte Ergebnisse (z.B. Kurswinkel zwischen gleichen Punkten) werden je Element als NaN und insgesamt als
+// Status::Undefined gemeldet.
+//
+// Die paarweisen Funktionen rechnen a[i] nach b[i]; hat a genau ein Element, gilt es für alle b (einer nach vielen).
+// Die Ausgaben müssen so lang wie b sein, sonst wird nichts berechnet (Status::SizeMismatch). Die Punkte werden
+// blockweise auf dem Stack in Spalten vorbereitet (wie prepareColumns), ein einzelner Startpunkt nur einmal; Zentriwinkel
+// und Strecken laufen über die Vektorkerne der Distanzmatrix (Toleranz gegenüber calcGCDkm siehe batch.hpp).
+//
+// Der Header bindet nur geometry.hpp und matrix.hpp ein. Für die Distanzmatrix über einen Koordinatenspeicher wird die
+// Sicht aus store.hpp bzw. database.hpp benötigt, Punkte ohne Speicher gehen über die Überladung mit Spaltenpuffer.
+#pragma once
+
+/// Standardbibliotheken
+#include <cstddef>     // size_t
+#include <cstdint>     // int-Typen
+#include <type_traits> // std::enable_if_t
+#include <utility>     // std::declval
+
+/// Eigene Header
+#include "geometry.hpp" // Point, PreparedCoordinate, PeakPosition, Backend, Earth, calc*-Funktionen
+#include "matrix.hpp"   // MatrixLayout, matrixSize
+
+struct CoordinateView; // store.hpp
+
+namespace trig
+{
+    // Nicht besitzende Sicht auf zusammenhängende Elemente (wie std::span, das erst mit C++20 verfügbar ist):
+    template <class T>
+    class Span
+    {
+    public:
+        constexpr Span(void) noexcept = default;
+        constexpr Span(T *data, size_t size) noexcept : ptr(data), count(size) {}
+
+        template <size_t N>
+        constexpr Span(T (&array)[N]) noexcept : ptr(array), count(N) {}
+
+        // Zusammenhängende Container (std::vector, std::array, Span<U> mit U* -> T*):
+        template <class C, class = std::enable_if_t<std::is_convertible<decltype(std::declval<C &>().data()), T *>::value>>
+        constexpr Span(C &&container) noexcept : ptr(container.data()), count(container.size()) {}
+
+        constexpr T *data(void) const noexcept { return ptr; }
+        constexpr size_t size(void) const noexcept { return count; }
+        constexpr bool empty(void) const noexcept { return count == 0; }
+        constexpr T &operator[](size_t i) const noexcept { return ptr[i]; }
+        constexpr T *begin(void) const noexcept { return ptr; }
+        constexpr T *end(void) const noexcept { return ptr + count; }
+
+    private:
+        T *ptr{nullptr};
+        size_t count{0};
+    };
+
+    enum class Status : uint8_t
+    {
+        Ok,
+        Undefined,     // mindestens ein Ergebnis ist unbestimmt (NaN)
+        SizeMismatch,  // Längen der Spans passen nicht zusammen, es wurde nichts berechnet
+        UnknownCommand // evaluate: Befehl außerhalb 1 bis 7
+    };
+
+    // Vorbereitete Koordinate zu einem Punkt (Winkelfunktionen werden hier ausgewertet):
+    inline PreparedCoordinate prepare(const Point &p) noexcept
+    {
+        return PreparedCoordinate{p.phi, p.lambda};
+    }
+
+    /// Einzelabfrage (Befehle 1 bis 7 der Konsole, des Stapel- und des Servermodus)
+    // Ergebnis eines Befehls:
+    struct Result
+    {
+        float value{0};           // Befehle 1, 2, 4, 5, 6
+        const char *unit{""};     // Grad bzw. km
+        bool point{false};        // Befehle 3, 7 liefern einen Punkt
+        float phi{0}, lambda{0};  // Punkt im Bogenmaß
+        PeakPosition position{PeakPosition::Unbestimmt};
+    };
+
+    // Berechnet Befehl cmd von A nach B mit der gewählten Rechenweise (params: v, fuel, k für Befehl 7). Das Erdmodell
+    // gilt für die Strecken (Befehle 4 und 6). Status::Undefined bei unbestimmtem Kurswinkel bzw. Großkreis:
+    Status evaluate(int cmd, const PreparedCoordinate &A, const PreparedCoordinate &B, const float *params, Result &res,
+                    Backend backend = Backend::Trig, Earth earth = Earth::Sphere) noexcept;
+
+    /// Paarweise Berechnungen (Befehle 1 bis 7 als Stapel)
+    Status centralAngles(Span<const Point> a, Span<const Point> b, Span<float> rad) noexcept;          // Zentriwinkel
+    Status courses(Span<const Point> a, Span<const Point> b, Span<float> rad) noexcept;                // Kurswinkel in A
+    Status northPeaks(Span<const Point> a, Span<const Point> b, Span<Point> peaks) noexcept;          // Scheitelpunkte
+    Status distances(Span<const Point> a, Span<const Point> b, Span<float> km) noexcept;              // Großkreisstrecken
+    Status loxodromes(Span<const Point> a, Span<const Point> b, Span<float> course, Span<float> km) noexcept;
+    Status crashPoints(Span<const Point> a, Span<const Point> b, float v, float fuel, float k, Span<Point> points) noexcept;
+
+    /// Distanzmatrix über einen Koordinatenspeicher (z.B. CoordinateStore::view() oder Database)
+    // Legt die Spalten zu points in columns (7 * points.size() Werte) an und setzt view darauf (ohne Bezeichner, view aus
+    // store.hpp):
+    Status prepareColumns(Span<const Point> points, Span<float> columns, CoordinateView &view) noexcept;
+
+    // Gesamte Matrix in [km], out muss matrixSize(coords.size(), layout) Werte fassen:
+    Status distanceMatrix(const CoordinateView &coords, Span<float> out, MatrixLayout layout) noexcept;
+
+    // Wie oben über Punkte ohne Koordinatenspeicher, die Spalten werden in columns (7 * points.size() Werte) angelegt:
+    Status distanceMatrix(Span<const Point> points, Span<float> columns, Span<float> out, MatrixLayout layout) noexcept;
+
+    // Nur die Zeilen [rowBegin; rowEnd), out zeigt auf die gesamte Matrix (zum Verteilen auf eigene Threads):
+    Status distanceMatrixRows(const CoordinateView &coords, size_t rowBegin, size_t rowEnd, Span<float> out, MatrixLayout layout) noexcept;
+} // namespace trig
@@ -0,0 +1,51 @@
+// Loxodromen im Stapel: Kurs und Länge vieler Strecken über einen Koordinatenspeicher
+//
+// Die Mercator-Ordinate sigma jeder Koordinate steht in der CoordinateView bereit (einmal beim Einlesen bzw. in der
+// Datenbank berechnet). Je Strecke fallen damit nur atan2 und hypot an, Kurs und Länge entstehen in einem Durchgang
+// über calcLoxodrome. Strecken werden als Paare von IDs übergeben; für einen Streckenzug ids[0..n) genügt
+// from = ids, to = ids + 1, count = n - 1.
+#pragma once
+
+/// Standardbibliotheken
+#include <cstddef>   // size_t
+#include <cstdint>   // int-Typen
+#include <stdexcept> // std::out_of_range
+
+/// Eigene Header
+#include "sphere.hpp"   // calcLoxodrome
+#include "store.hpp"    // CoordinateView, withTrig
+#include "executor.hpp" // ThreadPool
+
+// Berechnet Kurs (rad) und Länge (km) der Strecken from[i] -> to[i], i in [0; count). course bzw. km dürfen nullptr
+// sein, wenn der Wert nicht benötigt wird. Mit pool werden Blöcke parallel berechnet, das Ergebnis bleibt gleich.
+inline void calcLoxodromes(const CoordinateView &coords, const uint32_t *from, const uint32_t *to, size_t count,
+                           float *course, float *km, ThreadPool *pool = nullptr)
+{
+    for (size_t i = 0; i < count; i++)
+        if ((from[i] >= coords.size()) || (to[i] >= coords.size()))
+            throw std::out_of_range("Ungültige ID in Streckenliste!");
+
+    TrigColumns derived;
+    const auto columns{withTrig(coords, derived)};
+
+    const auto leg = [&columns](uint32_t i) {
+        return PreparedCoordinate{columns.phi[i], columns.lambda[i], 0.0f, columns.cosPhi[i], 0.0f, 0.0f, columns.sigma[i], {}, i};
+    };
+
+    const auto block = [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++)
+        {
+            const auto l{calcLoxodrome(leg(from[i]), leg(to[i]))};
+            if (course)
+                course[i] = l.course;
+            if (km)
+                km[i] = l.length;
+        }
+    };
+
+    if (!pool || (pool->size() == 1))
+        return block(0, count);
+
+    pool->parallelFor(count, 4096, block);
+}
+
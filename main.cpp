@@ -3,636 +3,682 @@
 /// Standardbibliotheken
 #include <cmath>    // PI
 #include <iostream> // Dateneingabe Konsole
-#include <fstream>  // std::ifstream
 #include <cstdint>  // int-Typen
 #include <vector>   // std::vector
 #include <memory>   // SmartPointer
 #include <string>   // std::string
-#include <regex>    // string splitting
+#include <algorithm> // std::min
 #include <iomanip>  // Ausrichtung Zahlen Konsole
 
+/// Eigene Header
+#include "sphere.hpp"   // Strukturen und Berechnungen auf der Kugel
+#include "store.hpp"    // Koordinatenspeicher
+#include "batch.hpp"    // Distanzmatrix (SIMD)
+#include "parser.hpp"   // Einlesen der Koordinatendatei
+#include "database.hpp" // Binärdatenbank (mmap)
+#include "query.hpp"    // Stapelmodus
+#include "registry.hpp" // CoordinateRegistry
+#include "spatial.hpp"  // SpatialIndex
+#include "executor.hpp" // ThreadPool
+#include "nvector.hpp"  // Backend
+#include "geofence.hpp" // FenceLeg, checkGeofence
+#include "sweep.hpp"    // CrashSweep, SweepAxis
+#include "tour.hpp"     // optimizeTour
+#include "stats.hpp"    // Laufzeitstatistik (--stats)
+#include "catalog.hpp"  // Catalog (Neuladen, --watch)
+#include "libtrig.hpp"  // Stapelfunktionen der Bibliothek
+#ifdef __linux__
+#include "server.hpp"   // QueryServer (--serve, epoll)
+#endif
+
 /// Makros
 #define trennung "*******************" // Trennungszeichen für Konsolenausgabe
 #define InputFile "in.txt"
 
-#define BOLD "\x1B[1m"
-#define KMAG "\x1B[35m"
-#define KGRN "\x1B[32m"
-#define KRED "\x1B[31m"
-#define KBLU "\x1B[34m"
-#define RESET "\x1B[0m"
-
-#define color // entkommentieren wenn ohne farbliche Ausgabe kompiliert werden soll
-
-/// Globale Variablen
-const auto r_E{6378.137f};         // Erdradius in [km]
-constexpr auto rad{M_PI / 180.0f}; // Radiant (1 Grad = 180 Grad / pi)
-
-/// Strukturen
-// Richtung Elevation-Winkel (Nord/Süd):
-enum class directionEl // Definition: Nord: 90 Grad bis 0 Grad, Süd: 0 Grad bis -90 Grad
+// Gibt die Koordinate aus der Sammlung zurück, die den entsprechenden Buchstaben, die ID, Kennung oder Bezeichnung trägt:
+PreparedCoordinate getCoordinate(const CoordinateRegistry &registry, std::string_view token)
 {
-    N,
-    S
-};
+    const auto id{registry.resolve(token)};
 
-// Richtung Azimut-Winkel (West/Ost):
-enum class directionAz // Definition: West: -180 Grad bis 0 Grad; Ost: 0 Grad bis 180 Grad
-{
-    W,
-    O
-};
+    // Kein passendes Element vorhanden, dann eine Exception werfen:
+    if (id == InvalidId)
+        throw std::logic_error("Kein zugehöriges Koordinatenobjekt gefunden!");
 
-// Winkel-Basisklasse:
-struct Angle // nicht instanziieren, sondern abgeleitete Klassen AngleEl/AngleAz verwenden!
-{
-    const uint16_t angle; // Winkel
-    const uint8_t min;    // Winkelminuten
-    const uint8_t sec;    // Winkelsekunden
+    return registry.view().prepared(id);
+}
 
-    Angle(uint16_t _angle, uint8_t _min, uint8_t _sec) : angle(_angle), min(_min), sec(_sec) {} // Konstruktor
-    Angle(float _angle) : angle(static_cast<uint16_t>(truncf(fabsf(_angle)))),
-                          min(static_cast<uint8_t>(truncf((fabsf(_angle) - static_cast<float>(angle)) * 60.0))),
-                          sec(static_cast<uint8_t>(truncf((((_angle - static_cast<float>(fabsf(angle))) * 60) - static_cast<float>(min)) * 60.0))) {} // Konstruktor der Winkel (in Grad!) als Gleitkommazahl übernimmt
+// Die Ausgaben der Befehle 1 bis 7 erhalten das Ergebnis von query::evaluate (trig::evaluate der Bibliothek, ggf. aus dem
+// Cache) und schreiben in out:
 
-    void print(void) const noexcept
-    {
-        std::cout << std::setw(3) << angle << "° " << std::setw(2) << static_cast<uint16_t>(min) << "' " << std::setw(2) << static_cast<uint16_t>(sec) << "'' ";
-    }
-};
-
-// Elevation-Winkel:
-struct AngleEl : Angle
+// Gibt den loxodromischen Kurs von A nach B auf Konsole aus:
+inline void printLoxodromicCourse(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const query::Result &res)
 {
-    const directionEl dir;
-
-    AngleEl(uint16_t _angle, uint8_t _min, uint8_t _sec, directionEl _dir) : Angle(_angle, _min, _sec), dir(_dir) {} // Konstruktor für Grad, Min., Sek.-Format
-    AngleEl(float _angle) : dir((_angle < 0) ? (directionEl::S) : (directionEl::N)), Angle(fabsf(_angle)) {}         // Konstruktor für Gleitkommazahl-Format (in Grad!)
-
-    void print(void) const noexcept
-    {
-        Angle::print();
-        if (dir == directionEl::N)
-            std::cout << 'N';
-        else if (dir == directionEl::S)
-            std::cout << 'S';
-    }
-};
+    out << "Loxodromischer Kurs von " << A.name << " nach " << B.name << " beträgt:\t";
+    out.number(res.value, 4) << " Grad\n";
+}
 
-// Azimut-Winkel:
-struct AngleAz : Angle
+inline void printLoxodromicLength(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const query::Result &res)
 {
-    const directionAz dir;
-
-    AngleAz(uint16_t _angle, uint8_t _min, uint8_t _sec, directionAz _dir) : Angle(_angle, _min, _sec), dir(_dir) {} // Konstruktor für Grad, Min., Sek.-Format
-    AngleAz(float _angle) : dir((_angle < 0) ? (directionAz::W) : (directionAz::O)), Angle(fabsf(_angle)) {}         // Konstruktor für Gleitkommazahl-Format (in Grad!)
-
-    void print(void) const noexcept
-    {
-        Angle::print();
-        if (dir == directionAz::W)
-            std::cout << 'W';
-        else if (dir == directionAz::O)
-            std::cout << 'O';
-    }
-};
+    out << "Loxodromische Länge von " << A.name << " nach " << B.name << " beträgt:\t";
+    out.number(res.value, 5) << " km\n";
+}
 
-struct Coordinate
+// Gibt den Zentriwinkel zwischen A und B auf Konsole aus:
+inline void printCentricAngle(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const query::Result &res) // Zentriwinkel
 {
-    const AngleEl phi;      // Breitengrad
-    const AngleAz lambda;   // Längengrad
-    const int8_t no;        // fortlaufende Nummer/Buchstabe (wird als Referenz für Programmparameter genutzt)
-    const std::string name; // Bezeichner aus .txt-Datei
+    out << "Zentriwinkel zwischen " << A.name << " und " << B.name << " beträgt:\t";
+    out.number(res.value, 4) << " Grad\n";
+}
 
-    Coordinate(uint16_t phi_angle, uint8_t phi_min, uint8_t phi_sec, directionEl phi_dir, uint16_t lambda_angle, uint8_t lambda_min, uint8_t lambda_sec, directionAz lambda_dir, const std::string &bez, int8_t _no) : phi(phi_angle, phi_min, phi_sec, phi_dir), lambda(lambda_angle, lambda_min, lambda_sec, lambda_dir), name(bez), no(_no) // Konstruktor
-    {
-    }
+// Gibt den Scheitelpunkt auf einem Großkreis aus (Kurswinkel und Lage wurden in query::evaluate einmal berechnet):
+void printNorthernmostPoint(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const query::Result &res)
+{
+    out << "Nördlichster Punkt auf Großkreis von " << A.name << " nach " << B.name << ":\n";
 
-    Coordinate(float angle_el, float angle_az, const std::string &bez, int8_t _no) : phi(angle_el), lambda(angle_az), name(bez), no(_no) {}
+    if (A.lambda == B.lambda)
+        calcNorthPeakPoint(A, B, 0.0f).print(out); // Meridian: Nordpol
+    else
+        Coordinate(static_cast<float>(rad2deg(res.phi)), static_cast<float>(rad2deg(res.lambda)), "Nördlichster Punkt", 0).print(out);
 
-    void print(void) const noexcept
+    // Ausgeben, wo sich der Scheitelpunkt grob befindet:
+    out << "Lage des Scheitelpunkts: ";
+    switch (res.position)
     {
-#ifdef color
-        std::cout << BOLD << KGRN;
-#endif
-        std::cout << no << ".) ";
-#ifdef color
-        std::cout << RESET << BOLD;
-#endif
-        std::cout << name << '\n';
-#ifdef color
-        std::cout << RESET;
-#endif
-        std::cout << "\t\u03A6: "; // phi
-        phi.print();
-        std::cout << "\t\u03BB: "; // lambda
-        lambda.print();
-        std::cout << '\n'
-                  << std::endl;
+    case PeakPosition::Zwischen:
+        out << "innerhalb des Bogens " << coordinateLabel(A.id) << coordinateLabel(B.id) << ".\n";
+        break;
+    case PeakPosition::VorA:
+        out << "vor " << coordinateLabel(A.id) << " (" << A.name << ").\n";
+        break;
+    case PeakPosition::HinterB:
+        out << "hinter " << coordinateLabel(B.id) << " (" << B.name << ").\n";
+        break;
+    default:
+        break;
     }
-};
 
-inline float deg2rad(float angle) noexcept
-{
-    return (angle * M_PI / 180.0f);
+    out << '\n';
 }
 
-inline float rad2deg(float angle) noexcept
+inline void printHeadingAngle(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const query::Result &res) // Kurswinkel
 {
-    return (angle * 180.0f / M_PI);
+    out << "Kurswinkel auf Großkreis von " << A.name << " nach " << B.name << ":\t";
+    out.number(res.value, 4) << " Grad\n";
 }
 
-// Liefert Winkel als Dezimalzahl im Bogenmaß
-inline float getAngle(const AngleAz &angle) noexcept
+inline void printRouteLength(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const query::Result &res)
 {
-    const auto calc{deg2rad(angle.angle + (angle.min / 60.0f) + (angle.sec / 3600.0f))};
-    return (angle.dir == directionAz::W) ? (-1 * calc) : calc;
+    out << "Strecke auf Großkreis von " << A.name << " nach " << B.name << ":\t";
+    out.number(res.value, 5) << " km\n";
 }
 
-// Liefert Winkel als Dezimalzahl im Bogenmaß
-inline float getAngle(const AngleEl &angle) noexcept
+void printCrashPoint(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const query::Result &res)
 {
-    const auto calc{deg2rad(angle.angle + (angle.min / 60.0f) + (angle.sec / 3600.0f))}; // Winkel in Grad
-    return (angle.dir == directionEl::S) ? (-1 * calc) : calc;
+    out << "Zwischenpunkt auf Großkreis von " << A.name << " nach " << B.name << ":\n";
+    Coordinate(static_cast<float>(rad2deg(res.phi)), static_cast<float>(rad2deg(res.lambda)), "Zwischenpunkt", 0).print(out);
+    out << '\n';
 }
 
-// Berechnet den loxodromischen Kurs von A nach B
-inline float calcLoxodromicCourse(const Coordinate &A, const Coordinate &B)
+// Gibt die Distanzmatrix aller Koordinaten auf Konsole oder (falls Dateiname angegeben) als CSV-Datei aus:
+void printDistanceMatrix(OutputBuffer &out, const CoordinateView &coords, MatrixLayout layout, const std::string &filename, ThreadPool &pool)
 {
-    // sigma von phi: [sigma](phi) = [ln(tan(pi/4 + phi/2))] oben: phi, unten: 0 (gilt nur für e = 0 (Kugel!))
-    const auto sigma = [](float phi) {
-        return logf(tanf(M_PI / 4 + phi / 2));
-    };
+    const auto isa{detectIsa()};
+    const auto n{coords.size()};
 
-    return atan2f((getAngle(B.lambda) - getAngle(A.lambda)), (sigma(getAngle(B.phi)) - sigma(getAngle(A.phi))));
-}
-
-// Berechnet loxodromische Länge von A nach B
-inline float calcLoxodromicLength(const Coordinate &A, const Coordinate &B)
-{
-    return r_E * fabsf((getAngle(B.phi) - getAngle(A.phi)) / cosf(calcLoxodromicCourse(A, B)));
-}
-
-// Gibt Winkel zwischen zwei Punkten auf der Kugel zurück (Zentriwinkel)
-float calcGCDrad(const Coordinate &A, const Coordinate &B) noexcept
-{
-    const auto phi_a{getAngle(A.phi)};
-    const auto phi_b{getAngle(B.phi)};
-
-    const auto lambda_a{getAngle(A.lambda)};
-    const auto lambda_b{getAngle(B.lambda)};
-
-    // Zentriwinkel:
-    return acosf(sinf(phi_a) * sinf(phi_b) + cosf(phi_a) * cosf(phi_b) * cosf(lambda_b - lambda_a));
-    /* Trigon. Fkt. in C++ verwenden ihren Parameter in Bogenmaß, deshalb hier noch umrechnen (* rad). Für acosf nicht nötig, da Wert bereits im Bogenmaß! */
-}
+    // Zeilenblöcke über die Bibliothek, verteilt auf den Pool:
+    std::vector<float> matrix(matrixSize(n, layout));
+    const auto bounds{matrixRowChunks(n, layout, matrix.data())};
+    pool.run(bounds.size() - 1, [&](size_t c) { trig::distanceMatrixRows(coords, bounds[c], bounds[c + 1], matrix, layout); });
 
-// Gibt Kurswinkel zurück: Winkel zwischen Nordrichtung und Südrichtung, zeta im Bogenmaß!
-float calcAlphaRad(const struct Coordinate &A, const struct Coordinate &B)
-{
-    const auto zeta{calcGCDrad(A, B)}; // Zentriwinkel
+    // Wert (i, j) aus der Matrix holen, j > i bei Dreiecksmatrix:
+    const auto at = [&matrix, n, layout](size_t i, size_t j) -> float {
+        return matrix[matrixRowOffset(n, i, layout) + ((layout == MatrixLayout::Dense) ? j : j - i - 1)];
+    };
 
-    if (zeta == 0)
-        throw std::overflow_error("Division durch Null!"); // Division durch Null abfangen
+    if (!filename.empty())
+    {
+        const std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::fopen(filename.c_str(), "wb"), std::fclose};
+        if (!file)
+            throw std::runtime_error("Ausgabedatei kann nicht geöffnet werden!");
 
-    const auto phi_a{getAngle(A.phi)};
-    const auto lambda_a{getAngle(A.lambda)};
+        {
+            OutputBuffer csv(file.get());
+            for (size_t i = 0; i < n; i++)
+            {
+                const auto first{(layout == MatrixLayout::Dense) ? 0 : i + 1};
+                for (size_t j = first; j < n; j++)
+                    ((j > first) ? csv << ',' : csv).number(at(i, j), 6);
+                csv << '\n';
+            }
+        }
 
-    const auto phi_b{getAngle(B.phi)};
-    const auto lambda_b{getAngle(B.lambda)};
+        out << "Distanzmatrix (" << n << " Koordinaten, " << isaName(isa) << ") nach '" << filename << "' geschrieben.\n";
+        return;
+    }
 
-    const auto c{calcGCDrad(A, B)};
+    out << "Distanzmatrix in km (" << isaName(isa) << "):\n";
+    out.padded(" ", 4);
+    for (size_t i = 0; i < n; i++)
+        out.padded(coordinateLabel(static_cast<uint32_t>(i)), 9);
+    out << '\n';
 
-    return acosf((sinf(phi_b) - sinf(phi_a) * cosf(c)) / (cosf(phi_a) * sinf(c)));
+    for (size_t i = 0; i < n; i++)
+    {
+        out.padded(coordinateLabel(static_cast<uint32_t>(i)), 4);
+        for (size_t j = 0; j < n; j++)
+        {
+            if ((layout == MatrixLayout::UpperTriangle) && (j <= i))
+                out.padded(" ", 9);
+            else
+                out.padded(at(i, j), 1, 9);
+        }
+        out << '\n';
+    }
+    out << '\n';
 }
 
-// Gibt Strecke des Winkels zurück (Orthodrom!)
-inline float calcBetaRad(const Coordinate &A, const Coordinate &B) noexcept
+// Gibt die k nächsten Koordinaten zu A auf Konsole aus:
+void printNearest(OutputBuffer &out, const SpatialIndex &index, const CoordinateView &coords, const PreparedCoordinate &A, size_t k)
 {
-    return calcAlphaRad(B, A);
+    out << "Nächste Nachbarn von " << A.name << ":\n";
+    for (const auto &hit : index.nearest(A, k, A.id))
+    {
+        out.padded(coordinateLabel(hit.id), 6) << ' ' << coords.name(hit.id) << ":\t";
+        out.number(hit.km, 5) << " km\n";
+    }
+    out << '\n';
 }
 
-// Gibt Strecke des Winkels zurück (Orthodrom!)
-inline float calcGCDkm(const Coordinate &A, const Coordinate &B) noexcept
+// Gibt alle Koordinaten im Umkreis von km um A auf Konsole aus:
+void printWithin(OutputBuffer &out, const SpatialIndex &index, const CoordinateView &coords, const PreparedCoordinate &A, float km)
 {
-    return (calcGCDrad(A, B) * r_E);
+    const auto hits{index.within(A, km, A.id)};
+    out << hits.size() << " Koordinaten im Umkreis von ";
+    out.number(km, 5) << " km um " << A.name << ":\n";
+    for (const auto &hit : hits)
+    {
+        out.padded(coordinateLabel(hit.id), 6) << ' ' << coords.name(hit.id) << ":\t";
+        out.number(hit.km, 5) << " km\n";
+    }
+    out << '\n';
 }
 
-// Gibt den nördlichsten Punkt auf einem Großkreis zurück
-Coordinate calcNorthPeakPoint(const Coordinate &A, const Coordinate &B)
+// Gibt alle Koordinaten mit Abstand <= km zur Strecke A->B aus (Querabstand, Abstand entlang ab A, Lage):
+void printCorridor(OutputBuffer &out, const CoordinateView &coords, const PreparedCoordinate &A, const PreparedCoordinate &B, float km, ThreadPool &pool)
 {
-    // Gegeben: A und alpha
-    // A
-    const auto phi_a{getAngle(A.phi)};
-    const auto lambda_a{getAngle(A.lambda)};
-    // B
-    const auto lambda_b{getAngle(B.lambda)};
-
-    // Auf Sonderfall prüfen:
+    const FenceLeg leg(A, B);
+    auto hits{checkGeofence(coords, &leg, 1, km, &pool)};
+    hits.erase(std::remove_if(hits.begin(), hits.end(), [&A, &B](const FenceHit &h) { return (h.point == A.id) || (h.point == B.id); }), hits.end());
+
+    out << hits.size() << " Koordinaten im Korridor von ";
+    out.number(km, 5) << " km um " << A.name << " - " << B.name << ":\n";
+    for (const auto &hit : hits)
     {
-        if (lambda_a == getAngle(B.lambda)) // Sonderfall: Orthodrom == Meridian: Alle Punkte auf Großkreis haben gleichen Längengrad & Großkr. geht durch Nordpol, damit ist der nördlichste Scheitelpunkt der Nordpol selbst.
-            return Coordinate{90, 0, 0, directionEl::N, 0, 0, 0, directionAz::O, "Nordpol", 0};
+        out.padded(coordinateLabel(hit.point), 6) << ' ' << coords.name(hit.point) << ":\tquer ";
+        out.number(hit.track.cross, 5) << " km, entlang ";
+        out.number(hit.track.along, 5) << " km, ";
+        out << ((hit.track.position == PeakPosition::Zwischen) ? "innerhalb" : query::positionName(hit.track.position)) << '\n';
     }
+    out << '\n';
+}
 
-    const auto alpha{calcAlphaRad(A, B)}; // Innenwinkel sp. Dreieck
-    const auto beta{calcBetaRad(A, B)};   // Innenwinkel sp. Dreieck
+// Gibt die Zwischenpunkte für alle Kombinationen aus Geschwindigkeit, Treibstoff und Verbrauch als Tabelle bzw. (line)
+// als Linie der erreichbaren Punkte entlang der Strecke aus:
+void printSweep(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const std::vector<std::string> &args, bool line, ThreadPool &pool)
+{
+    const auto v{SweepAxis::parse(args.at(3))}, fuel{SweepAxis::parse(args.at(4))}, k{SweepAxis::parse(args.at(5))};
+    const CrashSweep sweep(A, B);
 
-    enum Lage
+    std::vector<SweepPoint> points;
+    if (line)
+        points = sweep.reachable(v, fuel, k, &pool);
+    else
     {
-        zwischen,
-        vor_A,
-        hinter_B
-    } lage;
-
-    if (((alpha > 0) && (alpha < M_PI / 2)) && ((beta > 0) && (beta < M_PI / 2)))
-        lage = Lage::zwischen; // Zwischen A und B
-    else if (((alpha > M_PI / 2) && (alpha < M_PI)) && ((beta > 0) && (beta < M_PI / 2)))
-        lage = Lage::vor_A; // Vor A
-    else if (((alpha > 0) && (alpha < M_PI / 2)) && ((beta > M_PI / 2) && (beta < M_PI)))
-        lage = Lage::hinter_B; // hinter B
-
-    // Umgeht Singularität von Wechsel -180 - +180 Grad
-    const auto calcDeltaLambda = [lambda_a, lambda_b]() -> float {
-        const auto dL{lambda_a - lambda_b};
-
-        if (dL > M_PI)
-            return dL - 2 * M_PI;
-        else if (dL < -M_PI)
-            return dL + 2 * M_PI;
-        else
-            return dL;
-    };
-    const auto deltaLambda{calcDeltaLambda()};
-
-    // Berechnung Längengrad des Scheitelpunkts abhängig von dessen Lage
-    const auto calcLambda_S = [lage, lambda_a, phi_a, deltaLambda](float phi_s) -> float {
-        if (lage == Lage::zwischen || lage == Lage::hinter_B)
-        {
-            if (deltaLambda < 0)
-                return lambda_a + acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Oste
-            else if (deltaLambda > 0)
-                return lambda_a - acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Westen
-        }
-        else if (lage == Lage::vor_A) // umgedrehte Fälle:
-        {
-            if (deltaLambda < 0)
-                return lambda_a - acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Westen
-            else if (deltaLambda > 0)
-                return lambda_a + acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Osten
-        }
-    };
-
-    // Scheitelpunkt s
-    const auto phi_s{acosf(sinf(alpha) * cosf(phi_a))};
-    const auto lambda_s{calcLambda_S(phi_s)};
+        points.resize(v.size() * fuel.size() * k.size());
+        sweep.sweep(v, fuel, k, [&points](const SweepPoint *block, size_t count, size_t first) { std::copy(block, block + count, points.begin() + first); }, &pool);
+    }
 
-    return Coordinate(rad2deg(phi_s), rad2deg(lambda_s), "Nördlichster Punkt", 0);
+    out << (line ? "Erreichbare Punkte" : "Zwischenpunkte") << " auf Großkreis von " << A.name << " nach " << B.name << " (";
+    out << points.size() << (line ? " Punkte):\n" : " Kombinationen):\n");
+    out.padded("km/h", 10) << ' ';
+    out.padded("L", 10) << ' ';
+    out.padded("L/h", 10) << ' ';
+    out.padded("ab A km", 10) << '\n';
+    for (const auto &p : points)
+    {
+        out.padded(p.v, 1, 10) << ' ';
+        out.padded(p.fuel, 1, 10) << ' ';
+        out.padded(p.k, 1, 10) << ' ';
+        out.padded(p.along, 1, 10) << '\t';
+        query::writeDMS(out, p.phi, 'N', 'S');
+        out << '\t';
+        query::writeDMS(out, p.lambda, 'O', 'W');
+        out << '\n';
+    }
+    out << '\n';
 }
 
-// Berechnet Zwischenpunkt auf Großkreis (v == Speed, k == Verbrach)
-Coordinate calcCrashPoint(const Coordinate &A, const Coordinate &B, float v, float fuel, float k)
+// Optimiert die Reihenfolge der Stopps im Zeitbudget und gibt Zwischenstände laufend aus. Mit Dateinamen wird die beste
+// Tour bei jedem Zwischenstand als CSV (Bezeichner, Breite, Länge in Grad, Strecke ab erstem Stopp) neu geschrieben,
+// sonst am Ende auf Konsole ausgegeben:
+void printTour(OutputBuffer &out, const CoordinateRegistry &registry, float seconds, std::string_view stops, const std::string &filename, ThreadPool &pool)
 {
-    // A
-    const auto phi_a{getAngle(A.phi)};
-    const auto lambda_a{getAngle(A.lambda)};
-
-    // B
-    const auto phi_b{getAngle(B.phi)};
-    const auto lambda_b{getAngle(B.lambda)};
-
-    const auto eAB{calcGCDkm(A, B)};
-
-    // alpha
-    const auto alpha{calcAlphaRad(A, B)};
-
-    // deltaLambda
-    const auto deltaLambda{lambda_a - lambda_b};
-
-    // Attribute für Streckenberechnung des Zwischenpunkts:
-    //const auto time{calcFlightTime(fuel,k)}; // So lange reicht der Treibstoff [h]
-
-    const auto calcDistanceRatio = [v, fuel, eAB, k]() {
-        const auto prop{(v * fuel) / (eAB * k)}; // > 1: Bewegung über Punkt B hinaus (also wieder zurück), < 1: B wird nicht erreicht, Zwischenpunkt dazwischen
-        float integral;
-        const auto frac{std::modf(prop, &integral)}; // Nachkommastellen des Verhältnisses
-
-        if (static_cast<uint32_t>(integral) % 2)
-            return 1 - frac; // von B ausgehend
-        else
-            return frac; // von A ausgehend
-    };
-
-    const auto distance{calcDistanceRatio() * calcGCDrad(A, B)}; // Strecke von A nach B in rad
-
-    // Längengrad muss abhängig von Vorzeichen berechnet werden:
-    const auto calcLambda_p = [deltaLambda, distance, lambda_a, phi_a](float phi_p) {
-        if (((deltaLambda < 0) && (distance <= M_PI)) || ((deltaLambda > 0) && (distance > M_PI)))               // arccos() bildet nur auf Interval [0; M_PI) ab, daher dessen Argument zusätzlich in Abhängigkeit von d behandeln!
-            return lambda_a + acosf((cosf(distance) - sinf(phi_a) * sinf(phi_p)) / (cosf(phi_a) * cosf(phi_p))); // Flugrichtung: Osten
-        else
-            return lambda_a - acosf((cosf(distance) - sinf(phi_a) * sinf(phi_p)) / (cosf(phi_a) * cosf(phi_p))); // Flugrichtung: Westen
-    };
-
-    // ***************************** SONDERFALL *****************************
-    // Sonderfall: beide Koordinaten liegen auf gleichem Großkreis: Flugrichtung ist dann direkt nach Norden bzw. Süden entlang eines Meridians
-    // nachfolgend ausschließlich diverse Lambdas, die erforderliche Funktionen definieren
-    // endgültige Berechnung erfolgt zum Funktionsende
-
-    // Der Breitegrad wird auf das Intervall (-pi; pi] gemappt:
-    const auto transformPhi = [](float phi_x, float lambda_x) {
-        if ((phi_x >= 0) && (lambda_x < 0))
-            return M_PI - phi_x;
-        else if ((phi_x < 0) & (lambda_x < 0))
-            return -M_PI - phi_x;
-    };
-
-    // mathematisch kürzeste Flugstrecke ist dann dPhi = phi_a - phi_b, dazu noch auf entsprechendes Interval mappen:
-    const auto calcDeltaPhiDach = [](float deltaPhi_dach) -> float {
-        if (deltaPhi_dach > M_PI)
-            return deltaPhi_dach - 2 * M_PI;
-        else if (deltaPhi_dach < -M_PI)
-            return deltaPhi_dach + 2 * M_PI;
-        else
-            return deltaPhi_dach;
-    };
-
-    // transformierter Breitengrad des Zielpunktes:
-    const auto calcTransformPhi = [distance](float deltaPhi_dach, float phi_a_dach) {
-        if (deltaPhi_dach >= 0)
-            return phi_a_dach - distance; // Flugrichtung: Süden (distance ist in rad)
-        else
-            return phi_a_dach + distance; // Flugrichtung: Norden
-    };
-
-    // Breitengrad wird auf Interval (-pi; pi] reduziert und auf Ausgangsinterval zurück transformiert:
-    const auto calcInterval = [](float phi_p_dach) -> float {
-        if (phi_p_dach > (M_PI / 2))
-            return M_PI - phi_p_dach;
-        else if (phi_p_dach < -(M_PI / 2))
-            return -M_PI - phi_p_dach;
-        else
-            return phi_p_dach;
-    };
-
-    // Längengrad des Zielpunktes ergibt sich aus Flugdistanz zu:
-    const auto calcLambda_p_special = [lambda_a, phi_a, distance]() -> float {
-        if ((distance < ((M_PI / 2) - phi_a)) || (distance > ((1.5 * M_PI) - phi_a)))
-            return lambda_a;
-        else
-            return lambda_a + M_PI;
-    };
-
-    // Berechnet den Breitengrad des Zwischenpunktes abhängig davon ob Sonderfall (auf Meridian) oder kein Sonderfall (nicht auf Meridian) vorliegt:
-    const auto resPhi_p = [lambda_a, phi_a, lambda_b, phi_b, calcInterval, calcTransformPhi, calcDeltaPhiDach, transformPhi, distance, alpha]() {
-        if (lambda_a == lambda_b)
-            return calcInterval(calcTransformPhi(calcDeltaPhiDach(transformPhi(phi_a, lambda_a) - transformPhi(phi_b, lambda_b)), transformPhi(phi_a, lambda_a))); // Zwischenpunkt liegt auf Meridian
-        else
-            return asinf(cosf(distance) * sinf(phi_a) + sinf(distance) * cos(phi_a) * cosf(alpha)); // Zwischenpunkt nicht auf Meridian
-    };
-
-    // Berechnet den Längengrad des Zwischenpunktes abhängig davon ob Sonderfall (auf Meridian) oder kein Sonderfall (nicht auf Meridian) vorliegt:
-    const auto resLambda_p = [lambda_a, lambda_b, calcLambda_p_special, calcLambda_p](float phi_p) {
-        if (lambda_a == lambda_b)
-            return calcLambda_p_special();
-        else
-            return calcLambda_p(phi_p);
+    const auto &coords{registry.view()};
+    std::vector<uint32_t> ids;
+    if (!query::toStops(registry, stops, ids))
+        throw std::logic_error("Kein zugehöriges Koordinatenobjekt gefunden!");
+    if (!(seconds >= 0.0f))
+        throw std::invalid_argument("Ungültiges Zeitbudget!");
+
+    // Stopps in Reihenfolge mit Strecke ab dem ersten Stopp:
+    const auto writeStops = [&coords](OutputBuffer &buf, const std::vector<uint32_t> &order, bool csv) {
+        double km{0.0};
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const auto stop{coords.prepared(order[i])};
+            if (csv)
+            {
+                buf.csv(stop.name) << ',';
+                buf.number(rad2deg(stop.phi), 9) << ',';
+                buf.number(rad2deg(stop.lambda), 9) << ',';
+                buf.number(km, 9) << '\n';
+            }
+            else
+            {
+                buf.padded(coordinateLabel(order[i]), 6) << ' ' << stop.name << ":\t";
+                buf.number(km, 5) << " km\n";
+            }
+            km += calcGCDkm(stop, coords.prepared(order[(i + 1) % order.size()]));
+        }
     };
-    // ****************************************************
 
-    const auto phi_p{resPhi_p()};
-    const auto lambda_p{resLambda_p(phi_p)};
+    TourOptions options;
+    options.seconds = seconds;
+    out << "Rundreise über " << ids.size() << " Stopps, " << pool.size() << " Threads:\n";
 
-    return Coordinate(rad2deg(phi_p), rad2deg(lambda_p), "Zwischenpunkt", 0);
-}
+    const auto order{optimizeTour(coords, ids, options, [&](const TourProgress &p) {
+        out.padded(p.seconds, 2, 8) << " s\t";
+        out.number(p.km, 6) << " km\t" << p.kicks << " Störungen" << (p.final ? " (Endstand)" : "") << '\n';
+        out.flush();
+        std::fflush(stdout); // Zwischenstände sofort anzeigen
 
-// Gibt eine Koordinate aus der Sammlung zurück, die das entsprechende Index trägt:
-const Coordinate &getCoordinate(const std::vector<Coordinate> &coords, uint8_t i)
-{
-    uint8_t counter{0};
-    for (const auto &ele : coords)
-        if (ele.no == i)
-            return coords.at(counter);
-        else
-            counter++;
+        if (!filename.empty())
+        {
+            const std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::fopen(filename.c_str(), "wb"), std::fclose};
+            if (!file)
+                throw std::runtime_error("Ausgabedatei kann nicht geöffnet werden!");
+            OutputBuffer csv(file.get());
+            writeStops(csv, p.order, true);
+        }
+    }, &pool)};
 
-    // Am Ende der Schleife wurde kein passendes Element gefunden, dann eine Exception werfen:
-    throw std::logic_error("Kein zugehöriges Koordinatenobjekt gefunden!");
+    if (!filename.empty())
+        out << "Rundreise nach '" << filename << "' geschrieben.\n";
+    else
+        writeStops(out, order, false);
+    out << '\n';
 }
 
-// Gibt den loxodromischen Kurs von A nach B auf Konsole aus:
-inline void printLoxodromicCourse(const Coordinate &A, const Coordinate &B) noexcept
+// Gibt die Wegpunkte von A nach B auf Konsole oder (falls Dateiname angegeben) als CSV-, JSON- bzw. Binärdatei aus:
+void printRoute(OutputBuffer &out, const PreparedCoordinate &A, const PreparedCoordinate &B, const std::string &spacing, const std::string &filename)
 {
-    std::cout << "Loxodromischer Kurs von " << A.name << " nach " << B.name << " beträgt:\t" << std::setprecision(4) << rad2deg(calcLoxodromicCourse(A, B)) << " Grad" << std::endl;
-}
+    RouteSpec spec;
+    if (!spacing.empty() && !query::toRouteSpec(spacing, spec))
+        throw std::invalid_argument("Ungültige Anzahl bzw. ungültiger Abstand!");
 
-inline void printLoxodromicLength(const Coordinate &A, const Coordinate &B) noexcept
-{
-    std::cout << "Loxodromische Länge von " << A.name << " nach " << B.name << " beträgt:\t" << std::setprecision(5) << calcLoxodromicLength(A, B) << " km" << std::endl;
-}
+    const GreatCircleLeg leg(A, B);
 
-// Gibt den Zentriwinkel zwischen A und B auf Konsole aus:
-inline void printCentricAngle(const Coordinate &A, const Coordinate &B) noexcept // Zentriwinkel
-{
-    std::cout << "Zentriwinkel zwischen " << A.name << " und " << B.name << " beträgt:\t" << std::setprecision(4) << rad2deg(calcGCDrad(A, B)) << " Grad" << std::endl;
-}
+    if (filename.empty())
+    {
+        out << "Wegpunkte auf Großkreis von " << A.name << " nach " << B.name << ":\n";
+        out.flush(); // writeRoute schreibt mit eigenem Puffer direkt nach stdout
+        writeRoute(leg, spec, stdout, OutputFormat::Text);
+        out << '\n';
+        return;
+    }
 
-// Gibt den Scheitelpunkt auf einem Großkreis aus:
-void printNorthernmostPoint(const Coordinate &A, const Coordinate &B) noexcept
-{
-    std::cout << "Nördlichster Punkt auf Großkreis von " << A.name << " nach " << B.name << ":\n";
-    calcNorthPeakPoint(A, B).print();
-
-    const auto abflugswinkel{rad2deg(calcAlphaRad(A, B))};
-    const auto anflugswinkel{rad2deg(calcAlphaRad(B, A))};
-
-    const auto fallunterscheidung = [&abflugswinkel, &anflugswinkel, &A, &B]() -> void {
-        std::cout << "Lage des Scheitelpunkts: ";
-        if (((abflugswinkel > 0.0f) && (abflugswinkel < 90.0f)) && ((anflugswinkel > 0.0f) && (anflugswinkel < 90.0f)))
-            std::cout << "innerhalb des Bogens " << A.no << B.no << "." << std::endl;
-        else if (((abflugswinkel > 90.0f) && (abflugswinkel < 180.0f)) && ((anflugswinkel > 0.0f) && (anflugswinkel < 90.0f)))
-            std::cout << "vor " << A.no << " (" << A.name << ")." << std::endl;
-        else if (((abflugswinkel > 0.0f) && (abflugswinkel < 90.0f)) && ((anflugswinkel > 90.0f) && (anflugswinkel < 180.0f)))
-            std::cout << "hinter " << B.no << " (" << B.name << ")." << std::endl;
+    const auto endsWith = [&filename](std::string_view suffix) {
+        return (filename.size() >= suffix.size()) && (filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0);
     };
+    const auto format{endsWith(".json") ? OutputFormat::JSON : endsWith(".bin") ? OutputFormat::Binary : OutputFormat::CSV};
 
-    // Ausgeben, wo sich der Scheitelpunkt grob befindet:
-    fallunterscheidung();
+    const std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::fopen(filename.c_str(), "wb"), std::fclose};
+    if (!file)
+        throw std::runtime_error("Ausgabedatei kann nicht geöffnet werden!");
 
-    std::cout << std::endl;
+    const auto points{writeRoute(leg, spec, file.get(), format)};
+    out << points << " Wegpunkte von " << A.name << " nach " << B.name << " nach '" << filename << "' geschrieben.\n";
 }
 
-inline void printHeadingAngle(const Coordinate &A, const Coordinate &B) noexcept // Kurswinkel
+template <class... Args> // fold-expression
+void printOption(const std::string &name, uint8_t number, const std::string &c, Args... zusatz)
 {
-    std::cout << "Kurswinkel auf Großkreis von " << A.name << " nach " << B.name << ":\t" << std::setprecision(4) << rad2deg(calcAlphaRad(A, B)) << " Grad" << std::endl;
+    auto &out{console()};
+    out << ansi(BOLD KBLU) << name << ansi(RESET);
+    out << ":\t" << uint32_t{number} << " [A-" << c << "] [A-" << c << "]";
+    ((out << ' ' << std::string_view(zusatz)), ...);
+    out << '\n' << ansi(RESET);
 }
 
-inline void printRouteLength(const Coordinate &A, const Coordinate &B) noexcept
+// Wie printOption, aber für Operationen über alle Koordinaten (ohne Start/Ziel):
+template <class... Args> // fold-expression
+void printBatchOption(const std::string &name, uint8_t number, Args... zusatz)
 {
-    std::cout << "Strecke auf Großkreis von " << A.name << " nach " << B.name << ":\t" << std::setprecision(5) << calcGCDkm(A, B) << " km" << std::endl;
+    auto &out{console()};
+    out << ansi(BOLD KBLU) << name << ansi(RESET);
+    out << ":\t" << uint32_t{number};
+    ((out << ' ' << std::string_view(zusatz)), ...);
+    out << '\n';
 }
 
-void printCrashPoint(const Coordinate &A, const Coordinate &B, float speed, float fuel, float consumption)
+// Gibt die Programmparameter aus:
+void printUsage(const char *program)
 {
-    std::cout << "Zwischenpunkt auf Großkreis von " << A.name << " nach " << B.name << ":\n";
-    calcCrashPoint(A, B, speed, fuel, consumption).print();
-    std::cout << std::endl;
+    std::cout << "Aufruf: " << program << " [Optionen]\n"
+              << "  -i, --input <Datei>    Koordinaten im Textformat einlesen (Standard: " << InputFile << ")\n"
+              << "  -b, --binary <Datei>   Koordinaten aus Binärdatenbank einblenden\n"
+              << "  --watch                Textdatei überwachen und Änderungen im laufenden Betrieb nachladen (interaktiv, Server)\n"
+              << "  --convert <Text> <Bin> Textdatei in Binärdatenbank umwandeln und beenden\n"
+              << "      --double           Winkel als double speichern\n"
+              << "  --no-trig              Winkelfunktionen nicht vorberechnen (20 Byte je Koordinate weniger, Abfragen langsamer)\n"
+              << "  --batch <Datei|->      Befehle aus Datei bzw. stdin ohne Menü ausführen\n"
+              << "      --format <f>       Ausgabeformat im Stapel-/Servermodus: text, csv, json (JSON-Zeilen), binary\n"
+              << "      -o, --output <D>   Ausgabe im Stapelmodus in Datei statt stdout\n"
+              << "  --serve <Pfad|Port>    Abfrageserver: Befehle über Unix-Socket bzw. TCP auf 127.0.0.1 annehmen (Ende mit Strg+C)\n"
+              << "  --threads <N>          Anzahl Threads für Stapelberechnungen (Standard: alle Kerne)\n"
+              << "  --backend <b>          Rechenweise: trig (Kugeltrigonometrie, Standard), nvector (Einheitsvektoren)\n"
+              << "  --earth <m>            Erdmodell der Strecken (Befehle 4, 6): sphere (Kugel, Standard), wgs84 (Ellipsoid)\n"
+              << "  --cache <N>            Ergebnisse der Befehle 1-7 für N Abfragen zwischenspeichern (Standard: 4096, 0 = aus)\n"
+              << "      --cache-stats      Trefferquote des Caches am Ende auf stderr ausgeben\n"
+              << "  --stats                Aufrufe und Latenzen (p50/p95/p99) der Messstellen am Ende auf stderr ausgeben\n"
+              << "  --color <m>            Farbige Konsolenausgabe: auto (nur Terminal, Standard), always, never\n"
+              << "  -h, --help             diese Hilfe" << std::endl;
 }
 
-template <class... Args> // fold-expression
-void printOption(const std::string &name, uint8_t number, char c, Args... zusatz)
+int main(int argc, char *argv[])
 {
-#ifdef color
-    std::cout << BOLD << KBLU;
-#endif
+    // Programmparameter auswerten:
+    std::string inputFile{InputFile}; // Textdatei
+    std::string binaryFile;           // Binärdatenbank (hat Vorrang vor Textdatei)
+    bool watch{false};                // Textdatei überwachen und neu laden
+    std::string convertFrom, convertTo;
+    bool convertDouble{false};
+    bool storeTrig{true}; // Winkelfunktionen im Speicher bzw. in der Datenbank vorberechnen
+    std::string batchFile, outputFile; // Stapelmodus
+    std::string serveAddress;          // Servermodus
+    OutputFormat format{OutputFormat::Text};
+    unsigned threads{0}; // 0 = alle Hardware-Threads
+    Backend backend{Backend::Trig};
+    Earth earth{Earth::Sphere};
+    size_t cacheSize{4096}; // Einträge im Ergebnis-Cache, 0 = aus
+    bool cacheStats{false};
+    bool printStats{false}; // Laufzeitstatistik am Ende
+    ColorMode colorMode{ColorMode::Auto};
+
+    for (int a = 1; a < argc; a++)
+    {
+        const std::string arg{argv[a]};
+        const auto next = [&a, argc, argv, &arg]() -> std::string {
+            if (a + 1 >= argc)
+                throw std::invalid_argument("Parameter fehlt für " + arg);
+            return argv[++a];
+        };
 
-    std::cout << name;
+        try
+        {
+            if ((arg == "-i") || (arg == "--input"))
+                inputFile = next();
+            else if ((arg == "-b") || (arg == "--binary"))
+                binaryFile = next();
+            else if (arg == "--watch")
+                watch = true;
+            else if (arg == "--convert")
+            {
+                convertFrom = next();
+                convertTo = next();
+            }
+            else if (arg == "--double")
+                convertDouble = true;
+            else if (arg == "--no-trig")
+                storeTrig = false;
+            else if (arg == "--batch")
+                batchFile = next();
+            else if (arg == "--serve")
+                serveAddress = next();
+            else if (arg == "--format")
+                format = toOutputFormat(next());
+            else if ((arg == "-o") || (arg == "--output"))
+                outputFile = next();
+            else if (arg == "--threads")
+            {
+                threads = static_cast<unsigned>(std::stoul(next()));
+                if (threads == 0)
+                    throw std::invalid_argument("Mindestens ein Thread erforderlich");
+            }
+            else if (arg == "--backend")
+                backend = toBackend(next());
+            else if (arg == "--earth")
+                earth = toEarth(next());
+            else if (arg == "--cache")
+                cacheSize = toCacheSize(next());
+            else if (arg == "--cache-stats")
+                cacheStats = true;
+            else if (arg == "--stats")
+                printStats = true;
+            else if (arg == "--color")
+                colorMode = toColorMode(next());
+            else if ((arg == "-h") || (arg == "--help"))
+            {
+                printUsage(argv[0]);
+                return 0;
+            }
+            else
+                throw std::invalid_argument("Unbekannter Parameter " + arg);
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << ex.what() << '\n';
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
 
-#ifdef color
-    std::cout << RESET;
-#endif
+    term::setColorMode(colorMode);
 
-    std::cout << ":\t" << (uint16_t)number << " [A-" << c << "] [A-" << c << "]";
-    ((std::cout << ' ' << std::forward<Args>(zusatz)), ...);
-    std::cout << std::endl;
+    if (printStats)
+        stats::enable(); // vor dem Einlesen und vor dem Start des Thread-Pools
 
-#ifdef color
-    std::cout << RESET;
-#endif
-}
+    // Koordinaten einlesen, Text wird in store gehalten, Binärdatenbank in db:
+    CoordinateStore store;
+    std::unique_ptr<Database> db;
 
-int main(void)
-{
-    // Einleitung:
+    const auto tryLoad = [](auto &&load) -> bool {
+        try
+        {
+            load();
+        }
+        catch (const ParseError &ex)
+        {
+            std::cout << ansi(KRED);
+            std::cerr << "Einlesefehler in Zeile " << ex.line << "! (" << ex.what() << ')' << std::endl;
+            std::cout << ansi(RESET);
+            return false;
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return false;
+        }
+        return true;
+    };
+    const auto loadText = [&store, &tryLoad](const std::string &filename) -> bool {
+        return tryLoad([&]() { loadCoordinateFile(filename.c_str(), store); });
+    };
 
-#ifdef color
-    std::cout << BOLD;
-#endif
+    // Umwandlung Text -> Binärdatenbank:
+    if (!convertFrom.empty())
+    {
+        if (!loadText(convertFrom))
+            return 1;
 
-    std::cout << trennung << "\n\n\tSPHÄRISCHE TRIGONOMETRIE\n\n\t\t" << trennung << "\n\n";
+        try
+        {
+            writeDatabase(store, convertTo.c_str(), storeTrig, convertDouble);
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
 
-#ifdef color
-    std::cout << RESET;
-#endif
-    std::cout << "  Daten werden aus '" << InputFile << "' eingelesen...\n"
-              << std::endl;
+        std::cout << store.size() << " Koordinaten aus '" << convertFrom << "' nach '" << convertTo << "' geschrieben." << std::endl;
+        return 0;
+    }
 
-    // Koordinaten aus Datei einlesen:
-    std::ifstream file;
-    file.open(InputFile);
-    if (!file)
+    const bool batch{!batchFile.empty()};
+    const bool serve{!serveAddress.empty()};
+    if (batch && serve)
     {
-        throw std::runtime_error("Input-Datei ist fehlerhaft bzw. existiert nicht.");
+        std::cerr << "--batch und --serve schließen sich aus" << std::endl;
+        printUsage(argv[0]);
         return 1;
     }
 
-    std::vector<Coordinate> coords; // Enthält später alle Koordinaten, die eingelesen wurden
+    // Einleitung (nicht im Stapel- und Servermodus):
+    if (!batch && !serve)
+    {
+        auto &out{console()};
+        out << ansi(BOLD) << trennung << "\n\n\tSPHÄRISCHE TRIGONOMETRIE\n\n\t\t" << trennung << "\n\n" << ansi(RESET);
+        out << "  Daten werden aus '" << (binaryFile.empty() ? inputFile : binaryFile) << "' eingelesen...\n\n";
+        out.flush();
+        std::fflush(stdout); // Meldung vor dem (evtl. langen) Einlesen anzeigen
+    }
 
-    std::string input; // temporer String, der jeweils eine Zeile der Input.txt-Datei enthält
+    // Alle weiteren Abfragen laufen über einen Stand des Katalogs (Sicht, Verzeichnis, Cache, räumlicher Index). Mit
+    // --watch wird die Textdatei vom Katalog selbst eingelesen und bei Änderungen nachgeladen.
+    std::unique_ptr<Catalog> catalog;
+    if (!binaryFile.empty())
+    {
+        try
+        {
+            db = std::make_unique<Database>(binaryFile.c_str());
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+        catalog = std::make_unique<Catalog>(db->view(), cacheSize);
+    }
+    else if (watch && !batch)
+    {
+        if (!tryLoad([&]() { catalog = std::make_unique<Catalog>(inputFile, cacheSize, storeTrig); }))
+            return 1;
+    }
+    else
+    {
+        store.cacheTrig(storeTrig);
+        if (!loadText(inputFile))
+            return 1;
+        catalog = std::make_unique<Catalog>(store.view(), cacheSize);
+    }
 
-    // Extra Scope um deklarierte Variablen schnell wieder zu zerstören:
-    // Schreibt in die Konsole:
-    const auto write = [](std::string str) -> void {
-        std::cout << str;
-    };
+    const auto initial{catalog->current()};
 
-    const auto writeBez = [](int8_t c) {
-        std::cout << "[A-" << (char)c << "]";
+    // Trefferquote des Caches und Laufzeitstatistik auf stderr:
+    const auto printReport = [&catalog, cacheStats, printStats]() {
+        const auto &cache{catalog->current()->cache};
+        if (printStats)
+            stats::report(std::cerr);
+        if (cacheStats)
+            std::cerr << "Cache: " << cache.hitCount() << " Treffer, " << cache.missCount() << " Fehlzugriffe, Trefferquote "
+                      << std::fixed << std::setprecision(1) << cache.hitRate() * 100.0 << " % (" << cache.capacity() << " Einträge)" << std::endl;
     };
 
-    // Wandelt einen char in entsprechende Richtung um (Azimut):
-    const auto retDirAz = [](const char *c) -> directionAz {
-        if (*c == 'W')
-            return directionAz::W;
-        else if (*c == 'O')
-            return directionAz::O;
-        else
-            throw std::logic_error("Ungültige Richtung (Azimut)!");
-    };
+    // Stapelmodus: Befehle ohne Menü und Koordinatenliste abarbeiten
+    if (batch)
+    {
+        const std::unique_ptr<std::FILE, int (*)(std::FILE *)> in{(batchFile == "-") ? stdin : std::fopen(batchFile.c_str(), "rb"),
+                                                                  [](std::FILE *f) { return (f == stdin) ? 0 : std::fclose(f); }};
+        const std::unique_ptr<std::FILE, int (*)(std::FILE *)> out{outputFile.empty() ? stdout : std::fopen(outputFile.c_str(), "wb"),
+                                                                   [](std::FILE *f) { return (f == stdout) ? std::fflush(f) : std::fclose(f); }};
+        if (!in || !out)
+        {
+            std::cerr << "Befehls- bzw. Ausgabedatei kann nicht geöffnet werden!" << std::endl;
+            return 1;
+        }
 
-    // Wandelt einen char in entsprechende Richtung um (Elevation):
-    const auto retDirEl = [](const char *c) -> directionEl {
-        if (*c == 'N')
-            return directionEl::N;
-        else if (*c == 'S')
-            return directionEl::S;
+        try
+        {
+            ThreadPool pool(threads);
+            runBatch(initial->registry, in.get(), out.get(), format, &pool, backend, cacheSize ? &initial->cache : nullptr, earth);
+        }
+        catch (const std::exception &ex) // fehlerhafte Zeilen werden schon als Fehlereintrag gemeldet, hier z.B. Speichermangel
+        {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+        printReport();
+        return 0;
+    }
+
+    // Änderungen der Textdatei im Hintergrund nachladen, Meldung auf stderr:
+    const auto onReload = [](const ReloadReport &r) {
+        if (r.error)
+            std::cerr << "Neuladen fehlgeschlagen" << (r.line ? " in Zeile " + std::to_string(r.line) : std::string{}) << " (" << r.error
+                      << "), bisheriger Stand bleibt." << std::endl;
         else
-            throw std::logic_error("Ungültige Richtung (Elevation)!");
+            std::cerr << "Koordinaten neu geladen: " << r.count << " Koordinaten (+" << r.added << " -" << r.removed << ", " << r.parsed
+                      << " Zeilen zerlegt, " << std::fixed << std::setprecision(1) << r.ms << " ms)" << std::endl;
     };
 
-    const std::regex split("\\s"); // wird mehrmals zum aufsplitten von Eingaben verwendet
-
-    char number{65 /* A */}; // Koordinaten "durchnummerieren" und mit 'A' beginnen (wird später für Zuweisung verwendet)
-
-    uint8_t counter{1}; // Zähler für Zeilen
-
-    try
+    // Servermodus: Anfragen über den Socket beantworten, bis SIGINT/SIGTERM eintrifft
+    if (serve)
     {
-        while (std::getline(file, input))
+#ifdef __linux__
+        try
         {
-
-            if (input.at(0) == '#')
-            {              // Kommentare (beginnen mit #) überspringen, nur am Zeilenanfang möglich!
-                counter++; // Auch bei Kommentaren Zeilen mitzählen, damit bei Fehlerausgabe exakte Zeilennummer ausgegeben wird
-                continue;
-            }
-
-            // Hier Zeile aufsplitten:
-            const auto n1{input.find(',')};
-            const auto n2{input.find(',', n1 + 1)};
-
-            const std::string Breitengrad{input.substr(0, n1)};
-            const std::string Laengengrad{input.substr(n1 + 2, n2 - n1 - 1)};
-            const std::string Bezeichnung{input.substr(n2 + 2, input.length())};
-
-            // Breitengrad untersuchen:
-            const std::vector<std::string> resultB{
-                std::sregex_token_iterator(Breitengrad.begin(), Breitengrad.end(), split, -1), {}};
-
-            // Längengrad untersuchen:
-            const std::vector<std::string> resultL{
-                std::sregex_token_iterator(Laengengrad.begin(), Laengengrad.end(), split, -1), {}};
-
-            coords.push_back(Coordinate{static_cast<uint16_t>(std::atoi(resultB[0].c_str())),
-                                        static_cast<uint8_t>(std::atoi(resultB[1].c_str())),
-                                        static_cast<uint8_t>(std::atoi(resultB[2].c_str())),
-                                        retDirEl(resultB[3].c_str()),
-                                        static_cast<uint16_t>(std::atoi(resultL[0].c_str())),
-                                        static_cast<uint8_t>(std::atoi(resultL[1].c_str())),
-                                        static_cast<uint8_t>(std::atoi(resultL[2].c_str())),
-                                        retDirAz(resultL[3].c_str()),
-                                        Bezeichnung,
-                                        number++});
-
-            counter++;
+            QueryServer server(serveAddress); // vor Thread-Pool und Überwachung (Signalmaske wird vererbt)
+            ThreadPool pool(threads);
+            if (watch)
+                catalog->watch(onReload);
+
+            std::cerr << "Server bereit auf " << server.name() << " (" << initial->view.size() << " Koordinaten, " << pool.size() << " Threads)"
+                      << std::endl;
+            server.run(*catalog, pool, QueryServer::Options{format, backend, earth, cacheSize != 0});
+            catalog->unwatch();
+            server.report(std::cerr);
         }
-    }
-    catch (const std::exception &ex)
-    {
-#ifdef color
-        std::cout << KRED;
-#endif
-        std::cerr << "Einlesefehler in Zeile " << static_cast<uint32_t>(counter) << '!' << std::endl;
-#ifdef color
-        std::cout << RESET;
-#endif
-
+        catch (const std::exception &ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+        printReport();
+        return 0;
+#else
+        std::cerr << "Servermodus nur unter Linux verfügbar (epoll)" << std::endl;
         return 1;
+#endif
     }
 
+    // Schreibt in die Konsole:
+    auto &out{console()};
+    const auto write = [&out](std::string_view str) -> void {
+        out << str;
+    };
+
     // Alle eingelesenen Koordinaten anzeigen:
-    for (const auto elem : coords)
-        elem.print();
+    for (size_t c = 0; c < initial->view.size(); c++)
+        printCoordinate(out, initial->view.prepared(c));
 
-#ifdef color
-    std::cout << BOLD;
-#endif
+    write(ansi(BOLD));
     write("\nBitte Funktionscode mit Parametern eingeben: (z.B. 1 A B)\n");
-#ifdef color
-    std::cout << RESET;
-#endif
+    write(ansi(RESET));
     write("********************************************\n");
 
     // Mögliche Operationen posten
-    const char i{number - 1};
+    const std::string i{initial->view.size() ? coordinateLabel(static_cast<uint32_t>(std::min<size_t>(initial->view.size(), 26) - 1)) : "A"};
 
     printOption("Zentriwinkel", 1, i);
     printOption("Kurswinkel", 2, i);
@@ -641,73 +687,147 @@ int main(void)
     printOption("Loxodromischer Kurs", 5, i);
     printOption("Loxodromische Länge", 6, i);
     printOption("Zwischenpunkt", 7, i, "[vel in km/h]", "[fuel in L]", "[cons in L/h]");
-
-#ifdef color
-    std::cout << BOLD << KRED;
-#endif
+    printBatchOption("Distanzmatrix", 8, "[v(oll)|d(reieck)]", "[Datei.csv]");
+    printBatchOption("Nächste Nachbarn", 9, "[A-" + i + "]", "[Anzahl]");
+    printBatchOption("Umkreissuche", 10, "[A-" + i + "]", "[Radius in km]");
+    printOption("Wegpunkte", 11, i, "[Anzahl|Abstand km, z.B. 50km]", "[Datei.csv|.json|.bin]");
+    printOption("Korridor", 12, i, "[Abstand in km]");
+    printOption("Reichweitenstudie", 13, i, "[vel]", "[fuel]", "[cons] (je Wert, Liste a,b,c oder Start:Ende:Schritt)", "[l(inie)]");
+    printBatchOption("Rundreise", 14, "[Sekunden]", "[*|A,B,C]", "[Datei.csv]");
+
+    write(ansi(BOLD KRED));
     write("\n 0 == exit\n\n");
-#ifdef color
-    std::cout << RESET;
-#endif
+    write(ansi(RESET));
+
+    std::string cinput;       // Enthält Benutzereingabe auf Konsole
+    ThreadPool pool(threads); // für Befehle 8, 12, 13 und 14
 
-    std::string cinput; // Enthält Benutzereingabe auf Konsole
+    if (watch)
+        catalog->watch(onReload);
 
     do
     {
-        // Benutzereingabe einlesen:
-        std::getline(std::cin, cinput);
-
-        // aufsplitten und in vector einlesen:
-        const std::vector<std::string> userEingabe{
-            std::sregex_token_iterator(cinput.begin(), cinput.end(), split, -1), {}};
+        // Ausgaben des letzten Befehls anzeigen, dann Benutzereingabe einlesen (Ende der Eingabe beendet ebenfalls):
+        out.flush();
+        std::fflush(stdout);
+        if (!std::getline(std::cin, cinput))
+            break;
+
+        // aufsplitten (Bezeichner mit Leerzeichen in Anführungszeichen):
+        std::string_view tok[7];
+        const auto n{query::tokenize(cinput.data(), cinput.data() + cinput.size(), tok, 7)};
+        const std::vector<std::string> userEingabe(tok, tok + n);
+
+        if (userEingabe.empty())
+            continue;
 
         try
         {
+            // Stand für die Dauer des Befehls festhalten (Neuladen tauscht nur den Zeiger im Katalog):
+            const auto snapshot{catalog->current()};
+            const auto &coords{snapshot->view};
+            const auto &registry{snapshot->registry};
+            auto *const cache{cacheSize ? &snapshot->cache : nullptr};
+
             const auto cmd{std::atoi(userEingabe[0].c_str())};
 
             if (cmd == 0)
                 break;
 
-            const auto &A{getCoordinate(coords, static_cast<uint8_t>(userEingabe[1].c_str()[0]))};
-            const auto &B{getCoordinate(coords, static_cast<uint8_t>(userEingabe[2].c_str()[0]))};
+            // Operationen über alle Koordinaten benötigen keinen Start/Ziel:
+            if (cmd == 8)
+            {
+                const auto layout{((userEingabe.size() > 1) && (userEingabe[1] == "d")) ? MatrixLayout::UpperTriangle : MatrixLayout::Dense};
+                printDistanceMatrix(out, coords, layout, (userEingabe.size() > 2) ? userEingabe[2] : "", pool);
+                continue;
+            }
+
+            // Rundreise über alle bzw. die angegebenen Stopps:
+            if (cmd == 14)
+            {
+                printTour(out, registry, std::stof(userEingabe.at(1)), (userEingabe.size() > 2) ? userEingabe[2] : "*",
+                          (userEingabe.size() > 3) ? userEingabe[3] : "", pool);
+                continue;
+            }
+
+            // Suchbefehle benötigen nur einen Startpunkt, der Index wird beim ersten Aufruf je Stand aufgebaut:
+            if ((cmd == 9) || (cmd == 10))
+            {
+                const auto A{getCoordinate(registry, userEingabe.at(1))};
+                if (cmd == 9)
+                    printNearest(out, snapshot->index(), coords, A, static_cast<size_t>(std::stoul(userEingabe.at(2))));
+                else
+                    printWithin(out, snapshot->index(), coords, A, std::stof(userEingabe.at(2)));
+                continue;
+            }
+
+            const auto A{getCoordinate(registry, userEingabe.at(1))};
+            const auto B{getCoordinate(registry, userEingabe.at(2))};
 
             // Fehlerhafte Benutzereingabe abfangen:
-            if (A.name == B.name)
+            if (A.id == B.id)
             {
                 throw std::logic_error("Start und Ziel ist gleiche Koordinate!");
                 break;
             }
 
+            // Wegpunkte auf Konsole bzw. in Datei:
+            if (cmd == 11)
+            {
+                printRoute(out, A, B, (userEingabe.size() > 3) ? userEingabe[3] : "", (userEingabe.size() > 4) ? userEingabe[4] : "");
+                continue;
+            }
+
+            // Korridorprüfung (Geofencing) über alle Koordinaten:
+            if (cmd == 12)
+            {
+                printCorridor(out, coords, A, B, std::stof(userEingabe.at(3)), pool);
+                continue;
+            }
+
+            // Parameterstudie zu Befehl 7 über Gitter aus Geschwindigkeit, Treibstoff und Verbrauch:
+            if (cmd == 13)
+            {
+                printSweep(out, A, B, userEingabe, (userEingabe.size() > 6) && (userEingabe[6] == "l"), pool);
+                continue;
+            }
+
+            // Parameter von Befehl 7: Geschwindigkeit in km/h, Treibstoff in t, Verbrauch in L/h
+            float params[3]{};
+            if (cmd == 7)
+                for (int i = 0; i < 3; i++)
+                    params[i] = static_cast<float>(std::atof(userEingabe.at(3 + i).c_str()));
+            if ((cmd == 7) && !query::validCrashParams(params))
+                throw std::invalid_argument("Parameter von Befehl 7 müssen endlich und positiv sein!");
+
+            if ((cmd < 1) || (cmd > 7))
+                continue;
+
+            const auto res{query::evaluate(cmd, coords, A.id, B.id, params, backend, cache, earth)};
+
+            STATS_SCOPE(stats::Probe::Format);
             switch (cmd)
             {
             case 1:
-                printCentricAngle(A, B);
+                printCentricAngle(out, A, B, res);
                 break;
             case 2:
-                printHeadingAngle(A, B);
+                printHeadingAngle(out, A, B, res);
                 break;
             case 3:
-                printNorthernmostPoint(A, B);
+                printNorthernmostPoint(out, A, B, res);
                 break;
             case 4:
-                printRouteLength(A, B);
+                printRouteLength(out, A, B, res);
                 break;
             case 5:
-                printLoxodromicCourse(A, B);
+                printLoxodromicCourse(out, A, B, res);
                 break;
             case 6:
-                printLoxodromicLength(A, B);
+                printLoxodromicLength(out, A, B, res);
                 break;
             case 7:
-                const auto speed{std::atof(userEingabe[3].c_str())};       // Geschwindigkeit in km/h
-                const auto fuel{std::atof(userEingabe[4].c_str())};        // Treibstoff in t
-                const auto consumption{std::atof(userEingabe[5].c_str())}; // Verbrauch in L/h
-                //const auto Interval{std::atoi(userEingabe[6].c_str())};  // darf sich nur im Intervall (true) oder auf ganzem Großkreis bewegen
-
-                //const auto distance{calcGCDkm(A, B)};
-
-                printCrashPoint(A, B, speed, fuel, consumption); //, static_cast<bool>(Interval));
-
+                printCrashPoint(out, A, B, res);
                 break;
             }
         }
@@ -717,5 +837,7 @@ int main(void)
             continue;
         }
     } while (1);
-    std::cout << std::endl;
+    out << '\n';
+    out.flush();
+    printReport();
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+// Speicherlayout der Distanzmatrix (gemeinsam für batch.hpp und die Bibliothek libtrig.hpp)
+#pragma once
+
+/// Standardbibliotheken
+#include <cstddef> // size_t
+
+// Speicherlayout der Distanzmatrix:
+enum class MatrixLayout
+{
+    Dense,        // n * n Werte, zeilenweise, Diagonale = 0
+    UpperTriangle // n * (n - 1) / 2 Werte, zeilenweise nur j > i (ohne Diagonale)
+};
+
+// Anzahl Matrixelemente für n Koordinaten:
+inline size_t matrixSize(size_t n, MatrixLayout layout) noexcept
+{
+    return (layout == MatrixLayout::Dense) ? n * n : n * (n - (n > 0)) / 2;
+}
+
+// Offset der Zeile i im Ausgabepuffer:
+inline size_t matrixRowOffset(size_t n, size_t i, MatrixLayout layout) noexcept
+{
+    return (layout == MatrixLayout::Dense) ? i * n : i * (2 * n - i - 1) / 2;
+}
@@ -0,0 +1,276 @@
+// Alternative Rechenweise über Einheitsvektoren (n-Vektoren) auf der Kugel
+//
+// Eine Koordinate entspricht dem Einheitsvektor a = (cos(phi) cos(lambda), cos(phi) sin(lambda), sin(phi)); die Werte
+// liegen in PreparedCoordinate bereits vor. Alle Größen ergeben sich aus Skalar- und Kreuzprodukten plus atan2:
+//   Zentriwinkel      atan2(|a x b|, a . b)                  (gut konditioniert auch für kleine und große Winkel)
+//   Kurs in A         atan2(b . Ost(a), b . Nord(a))          (mit Vorzeichen, Osten positiv)
+//   Scheitelpunkt     Pol-nächster Punkt des Großkreises mit Normale c = a x b
+//   Zwischenpunkt     p = a cos(d) + (c / |c| x a) sin(d)
+// Ohne Fallunterscheidungen nach Lage, Flugrichtung oder Meridian; einzige Verzweigung ist die Prüfung auf einen nicht
+// eindeutigen Großkreis (A == B bzw. gegenüberliegend), die wie bei den trigonometrischen Funktionen eine Ausnahme wirft
+// (bzw. in den noexcept-Varianten false liefert).
+// Längengrade der Ergebnisse liegen immer in [-pi; pi].
+#pragma once
+
+/// Standardbibliotheken
+#include <cmath>     // std::atan2, std::hypot, std::sqrt
+#include <stdexcept> // std::overflow_error, std::invalid_argument
+#include <string>    // std::string
+
+/// Eigene Header
+#include "sphere.hpp" // BasicPreparedCoordinate, BasicPoint, calcFlightDistanceRad
+
+inline const char *backendName(Backend backend) noexcept
+{
+    return (backend == Backend::NVector) ? "nvector" : "trig";
+}
+
+inline Backend toBackend(const std::string &name)
+{
+    if (name == "trig")
+        return Backend::Trig;
+    if (name == "nvector")
+        return Backend::NVector;
+    throw std::invalid_argument("Unbekannte Rechenweise " + name);
+}
+
+namespace nvector
+{
+    template <class T>
+    struct Vec3
+    {
+        T x, y, z;
+    };
+
+    template <class T>
+    inline Vec3<T> unit(const BasicPreparedCoordinate<T> &c) noexcept
+    {
+        return Vec3<T>{c.cosPhi * c.cosLambda, c.cosPhi * c.sinLambda, c.sinPhi};
+    }
+
+    template <class T>
+    inline T dot(const Vec3<T> &a, const Vec3<T> &b) noexcept
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    template <class T>
+    inline Vec3<T> cross(const Vec3<T> &a, const Vec3<T> &b) noexcept
+    {
+        return Vec3<T>{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    template <class T>
+    inline T norm(const Vec3<T> &a) noexcept
+    {
+        return std::sqrt(dot(a, a));
+    }
+
+    // Breite/Länge eines (nicht notwendig normierten) Vektors:
+    template <class T>
+    inline BasicPoint<T> toPoint(const Vec3<T> &v) noexcept
+    {
+        return BasicPoint<T>{std::atan2(v.z, std::hypot(v.x, v.y)), std::atan2(v.y, v.x)};
+    }
+
+    // Normale des Großkreises durch A und B, liefert false (ohne Exception), wenn dieser nicht eindeutig ist:
+    template <class T>
+    inline bool normal(const Vec3<T> &a, const Vec3<T> &b, Vec3<T> &c) noexcept
+    {
+        c = cross(a, b);
+        return dot(c, c) != T{0};
+    }
+
+    // Wie oben, wirft wenn der Großkreis nicht eindeutig ist:
+    template <class T>
+    inline Vec3<T> normal(const Vec3<T> &a, const Vec3<T> &b)
+    {
+        Vec3<T> c;
+        if (!normal(a, b, c))
+            throw std::overflow_error("Großkreis durch A und B ist nicht eindeutig!");
+        return c;
+    }
+
+    template <class T>
+    inline T calcGCDrad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+    {
+        const auto a{unit(A)}, b{unit(B)};
+        return std::atan2(norm(cross(a, b)), dot(a, b));
+    }
+
+    template <class T>
+    inline T calcGCDkm(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B) noexcept
+    {
+        return nvector::calcGCDrad(A, B) * earthRadius<T>;
+    }
+
+    // Kurs in A (rad, Norden = 0, Osten positiv, Bereich [-pi; pi]), liefert false bei nicht eindeutigem Großkreis:
+    template <class T>
+    inline bool calcCourseRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, T &course) noexcept
+    {
+        const auto a{unit(A)}, b{unit(B)};
+        Vec3<T> c;
+        if (!normal(a, b, c)) // nur Prüfung
+            return false;
+
+        // Ost- und Nordrichtung in A:
+        const Vec3<T> east{-A.sinLambda, A.cosLambda, T{0}};
+        const Vec3<T> north{-A.sinPhi * A.cosLambda, -A.sinPhi * A.sinLambda, A.cosPhi};
+        course = std::atan2(dot(b, east), dot(b, north));
+        return true;
+    }
+
+    // Wie oben, wirft bei nicht eindeutigem Großkreis:
+    template <class T>
+    inline T calcCourseRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B)
+    {
+        T course;
+        if (!nvector::calcCourseRad(A, B, course))
+            throw std::overflow_error("Großkreis durch A und B ist nicht eindeutig!");
+        return course;
+    }
+
+    // Kurswinkel wie calcAlphaRad (Winkel zur Nordrichtung ohne Vorzeichen, [0; pi]):
+    template <class T>
+    inline bool calcAlphaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, T &alpha) noexcept
+    {
+        if (!nvector::calcCourseRad(A, B, alpha))
+            return false;
+        alpha = std::fabs(alpha);
+        return true;
+    }
+
+    // Wie oben, wirft bei nicht eindeutigem Großkreis:
+    template <class T>
+    inline T calcAlphaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B)
+    {
+        return std::fabs(nvector::calcCourseRad(A, B));
+    }
+
+    // Nördlichster Punkt des Großkreises: Projektion des Nordpols N auf die Großkreisebene,
+    // N |c|^2 - (N . c) c = (-cz cx, -cz cy, cx^2 + cy^2). Auf einem Meridian (cz == 0) ist es der Nordpol.
+    template <class T>
+    inline bool calcNorthPeakPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, BasicPoint<T> &p) noexcept
+    {
+        Vec3<T> c;
+        if (!normal(unit(A), unit(B), c))
+            return false;
+        const auto horizontal{std::hypot(c.x, c.y)};
+        const auto s{-std::copysign(T{1}, c.z)};
+        p = BasicPoint<T>{std::atan2(horizontal, std::fabs(c.z)), std::atan2(s * c.y, s * c.x)};
+        return true;
+    }
+
+    // Wie oben, wirft bei nicht eindeutigem Großkreis:
+    template <class T>
+    inline BasicPoint<T> calcNorthPeakPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B)
+    {
+        BasicPoint<T> p;
+        if (!nvector::calcNorthPeakPointRad(A, B, p))
+            throw std::overflow_error("Großkreis durch A und B ist nicht eindeutig!");
+        return p;
+    }
+
+    // Zwischenpunkt (v == Speed, k == Verbrauch), Strecke wie calcCrashPointRad, liefert false bei nicht eindeutigem
+    // Großkreis:
+    template <class T>
+    inline bool calcCrashPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B,
+                                  Scalar<T> v, Scalar<T> fuel, Scalar<T> k, BasicPoint<T> &p) noexcept
+    {
+        const auto a{unit(A)}, b{unit(B)};
+        Vec3<T> c;
+        if (!normal(a, b, c))
+            return false;
+        const auto length{norm(c)};
+        const auto distance{calcFlightDistanceRad(std::atan2(length, dot(a, b)), v, fuel, k)};
+
+        // Einheitstangente in A Richtung B:
+        const auto t{cross(Vec3<T>{c.x / length, c.y / length, c.z / length}, a)};
+        const auto cosD{std::cos(distance)}, sinD{std::sin(distance)};
+        p = toPoint(Vec3<T>{a.x * cosD + t.x * sinD, a.y * cosD + t.y * sinD, a.z * cosD + t.z * sinD});
+        return true;
+    }
+
+    // Wie oben, wirft bei nicht eindeutigem Großkreis:
+    template <class T>
+    inline BasicPoint<T> calcCrashPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B,
+                                           Scalar<T> v, Scalar<T> fuel, Scalar<T> k)
+    {
+        BasicPoint<T> p;
+        if (!nvector::calcCrashPointRad(A, B, v, fuel, k, p))
+            throw std::overflow_error("Großkreis durch A und B ist nicht eindeutig!");
+        return p;
+    }
+} // namespace nvector
+
+// Auswahl der Rechenweise zur Laufzeit:
+template <class T>
+inline T calcGCDrad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Backend backend) noexcept
+{
+    return (backend == Backend::NVector) ? nvector::calcGCDrad(A, B) : calcGCDrad(A, B);
+}
+
+template <class T>
+inline T calcGCDkm(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Backend backend) noexcept
+{
+    return (backend == Backend::NVector) ? nvector::calcGCDkm(A, B) : calcGCDkm(A, B);
+}
+
+// Liefert false (ohne Exception) bei unbestimmtem Kurswinkel:
+template <class T>
+inline bool calcAlphaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Backend backend, T &alpha) noexcept
+{
+    return (backend == Backend::NVector) ? nvector::calcAlphaRad(A, B, alpha) : calcAlphaRad(A, B, alpha);
+}
+
+template <class T>
+inline T calcAlphaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Backend backend)
+{
+    return (backend == Backend::NVector) ? nvector::calcAlphaRad(A, B) : calcAlphaRad(A, B);
+}
+
+template <class T>
+inline T calcBetaRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Backend backend)
+{
+    return calcAlphaRad(B, A, backend);
+}
+
+// Scheitelpunkt bei bekanntem Kurswinkel alpha (nur Kugeltrigonometrie), liefert false bei nicht eindeutigem Großkreis:
+template <class T>
+inline bool calcNorthPeakPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> alpha, Backend backend,
+                                  BasicPoint<T> &p) noexcept
+{
+    if ((A.lambda == B.lambda) || (backend == Backend::Trig))
+    {
+        p = calcNorthPeakPointRad(A, B, (A.lambda == B.lambda) ? T{0} : alpha);
+        return true;
+    }
+    return nvector::calcNorthPeakPointRad(A, B, p);
+}
+
+// Scheitelpunkt inkl. Kurswinkel. Meridian: Nordpol bei Längengrad 0 für beide Rechenweisen (der n-Vektor liefert
+// dort einen beliebigen Längengrad):
+template <class T>
+inline BasicPoint<T> calcNorthPeakPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Backend backend)
+{
+    if (A.lambda == B.lambda)
+        return calcNorthPeakPointRad(A, B, T{0});
+    if (backend == Backend::NVector)
+        return nvector::calcNorthPeakPointRad(A, B);
+    return calcNorthPeakPointRad(A, B, calcAlphaRad(A, B));
+}
+
+// Liefert false (ohne Exception) bei unbestimmtem Kurswinkel bzw. nicht eindeutigem Großkreis:
+template <class T>
+inline bool calcCrashPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B,
+                              Scalar<T> v, Scalar<T> fuel, Scalar<T> k, Backend backend, BasicPoint<T> &p) noexcept
+{
+    return (backend == Backend::NVector) ? nvector::calcCrashPointRad(A, B, v, fuel, k, p) : calcCrashPointRad(A, B, v, fuel, k, p);
+}
+
+template <class T>
+inline BasicPoint<T> calcCrashPointRad(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B,
+                                       Scalar<T> v, Scalar<T> fuel, Scalar<T> k, Backend backend)
+{
+    return (backend == Backend::NVector) ? nvector::calcCrashPointRad(A, B, v, fuel, k) : calcCrashPointRad(A, B, v, fuel, k);
+}
@@ -0,0 +1,269 @@
+// Ausgabeschicht: Puffer mit std::to_chars statt iostream, Ausgabeformate und Farben der Konsole
+//
+// Alle Ausgaben (Konsole, Stapelmodus, Dateien) werden in einen wiederverwendbaren Puffer geschrieben und erst bei
+// Erreichen einer Schwelle bzw. mit flush() per fwrite weitergegeben. Zahlen werden mit std::to_chars formatiert
+// (Ausgabe wie printf "%.*g" bzw. "%.*f", also wie std::setprecision ohne bzw. mit std::fixed), Auffüllen wie
+// std::setw übernimmt padded(). Farben (ANSI) werden zur Laufzeit abgeschaltet, wenn stdout kein Terminal ist.
+#pragma once
+
+/// Standardbibliotheken
+#include <charconv>    // std::to_chars
+#include <cmath>       // std::isfinite
+#include <cstddef>     // size_t
+#include <cstdint>     // int-Typen
+#include <cstdio>      // std::FILE, std::fwrite, std::snprintf
+#include <cstdlib>     // std::getenv
+#include <cstring>     // std::strcmp
+#include <stdexcept>   // std::invalid_argument
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <unistd.h>    // isatty
+
+/// Makros
+#define BOLD "\x1B[1m"
+#define KMAG "\x1B[35m"
+#define KGRN "\x1B[32m"
+#define KRED "\x1B[31m"
+#define KBLU "\x1B[34m"
+#define RESET "\x1B[0m"
+
+// Ausgabeformat des Stapelmodus und der Wegpunkte:
+enum class OutputFormat
+{
+    Text,  // eine Zeile je Befehl, wie in der Konsole
+    CSV,   // cmd,from,to,value,unit,phi,lambda,position,error
+    JSON,  // JSON-Zeilen, ein Objekt je Befehl
+    Binary // Kopf und Datensätze fester Länge (siehe query::BinaryRecord bzw. RouteRecord)
+};
+
+inline OutputFormat toOutputFormat(const std::string &name)
+{
+    if (name == "text")
+        return OutputFormat::Text;
+    if (name == "csv")
+        return OutputFormat::CSV;
+    if ((name == "json") || (name == "jsonl"))
+        return OutputFormat::JSON;
+    if ((name == "binary") || (name == "bin"))
+        return OutputFormat::Binary;
+    throw std::invalid_argument("Unbekanntes Format " + name);
+}
+
+// Kopf einer Binärausgabe (8 Byte): Kennung und Länge eines Datensatzes
+struct BinaryHeader
+{
+    char magic[4];
+    uint32_t recordSize;
+};
+
+// Farbige Ausgabe der Konsole:
+enum class ColorMode
+{
+    Auto,   // nur wenn stdout ein Terminal ist und NO_COLOR nicht gesetzt ist
+    Always,
+    Never
+};
+
+inline ColorMode toColorMode(const std::string &name)
+{
+    if (name == "auto")
+        return ColorMode::Auto;
+    if (name == "always")
+        return ColorMode::Always;
+    if (name == "never")
+        return ColorMode::Never;
+    throw std::invalid_argument("Unbekannter Farbmodus " + name);
+}
+
+namespace term
+{
+    inline bool &colorFlag(void) noexcept
+    {
+        static bool enabled{false};
+        return enabled;
+    }
+
+    inline void setColorMode(ColorMode mode) noexcept
+    {
+        const auto *const termName{std::getenv("TERM")};
+        const auto terminal{isatty(fileno(stdout)) && !std::getenv("NO_COLOR") && !(termName && (std::strcmp(termName, "dumb") == 0))};
+        colorFlag() = (mode == ColorMode::Always) || ((mode == ColorMode::Auto) && terminal);
+    }
+} // namespace term
+
+// ANSI-Sequenz, wenn Farben eingeschaltet sind, sonst leer (z.B. out << ansi(BOLD KGRN)):
+inline const char *ansi(const char *sequence) noexcept
+{
+    return term::colorFlag() ? sequence : "";
+}
+
+// Ausgabepuffer, wird erst bei Erreichen der Schwelle bzw. am Ende geschrieben:
+class OutputBuffer
+{
+public:
+    // Ohne Datei (file == nullptr) wird nur im Speicher gesammelt, siehe take():
+    explicit OutputBuffer(std::FILE *_file, size_t _threshold = 1 << 20) : file(_file), threshold(_threshold)
+    {
+        buffer.reserve(threshold + 4096);
+    }
+
+    ~OutputBuffer()
+    {
+        flush();
+    }
+
+    OutputBuffer &operator<<(std::string_view str)
+    {
+        buffer.append(str);
+        if (file && (buffer.size() >= threshold))
+            flush();
+        return *this;
+    }
+
+    OutputBuffer &operator<<(char c)
+    {
+        buffer.push_back(c);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(uint32_t value)
+    {
+        char tmp[16];
+        const auto res{std::to_chars(tmp, tmp + sizeof(tmp), value)};
+        buffer.append(tmp, res.ptr);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(uint64_t value)
+    {
+        char tmp[24];
+        const auto res{std::to_chars(tmp, tmp + sizeof(tmp), value)};
+        buffer.append(tmp, res.ptr);
+        return *this;
+    }
+
+    // Gleitkommazahl mit precision signifikanten Stellen (entspricht std::setprecision):
+    OutputBuffer &number(float value, int precision)
+    {
+        char tmp[32];
+        const auto res{std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::general, precision)};
+        buffer.append(tmp, res.ptr);
+        return *this;
+    }
+
+    // Gleitkommazahl mit precision Nachkommastellen (entspricht std::fixed << std::setprecision):
+    OutputBuffer &fixed(float value, int precision)
+    {
+        char tmp[64];
+        const auto res{std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::fixed, precision)};
+        buffer.append(tmp, res.ptr);
+        return *this;
+    }
+
+    // Rechtsbündig auf width Zeichen (Bytes) aufgefüllt (entspricht std::setw):
+    OutputBuffer &padded(std::string_view str, size_t width)
+    {
+        if (str.size() < width)
+            buffer.append(width - str.size(), ' ');
+        return *this << str;
+    }
+
+    OutputBuffer &padded(uint32_t value, size_t width)
+    {
+        char tmp[16];
+        const auto res{std::to_chars(tmp, tmp + sizeof(tmp), value)};
+        return padded(std::string_view(tmp, static_cast<size_t>(res.ptr - tmp)), width);
+    }
+
+    OutputBuffer &padded(float value, int precision, size_t width)
+    {
+        char tmp[64];
+        const auto res{std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::fixed, precision)};
+        return padded(std::string_view(tmp, static_cast<size_t>(res.ptr - tmp)), width);
+    }
+
+    // Gleitkommazahl für JSON (NaN/Unendlich sind dort nicht erlaubt):
+    OutputBuffer &jsonNumber(float value, int precision)
+    {
+        if (!std::isfinite(value))
+            return *this << "null";
+        return number(value, precision);
+    }
+
+    // Zeichenkette mit JSON-Maskierung:
+    OutputBuffer &json(std::string_view str)
+    {
+        buffer.push_back('"');
+        for (const char c : str)
+        {
+            if ((c == '"') || (c == '\\'))
+                buffer.push_back('\\');
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char tmp[8];
+                buffer.append(tmp, static_cast<size_t>(std::snprintf(tmp, sizeof(tmp), "\\u%04x", c)));
+                continue;
+            }
+            buffer.push_back(c);
+        }
+        buffer.push_back('"');
+        return *this;
+    }
+
+    // Zeichenkette mit CSV-Maskierung (nur falls nötig in Anführungszeichen):
+    OutputBuffer &csv(std::string_view str)
+    {
+        if (str.find_first_of(",\"\n") == std::string_view::npos)
+            return *this << str;
+
+        buffer.push_back('"');
+        for (const char c : str)
+        {
+            if (c == '"')
+                buffer.push_back('"');
+            buffer.push_back(c);
+        }
+        buffer.push_back('"');
+        return *this;
+    }
+
+    // Datensatz im Binärformat (Speicherabbild, Bytefolge der Maschine):
+    template <class T>
+    OutputBuffer &binary(const T &record)
+    {
+        return *this << std::string_view(reinterpret_cast<const char *>(&record), sizeof(T));
+    }
+
+    void flush(void)
+    {
+        if (!file)
+            return;
+        if (!buffer.empty())
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+
+    // Gesammelte, noch nicht geschriebene Byte:
+    size_t size(void) const noexcept
+    {
+        return buffer.size();
+    }
+
+    // Übernimmt den gesammelten Inhalt:
+    std::string take(void)
+    {
+        return std::move(buffer);
+    }
+
+private:
+    std::FILE *file;
+    size_t threshold;
+    std::string buffer;
+};
+
+// Gemeinsamer Puffer für stdout (Konsole). Vor Ausgaben über std::cout bzw. beim Warten auf Eingaben flush() aufrufen:
+inline OutputBuffer &console(void)
+{
+    static OutputBuffer out(stdout, 1 << 16);
+    return out;
+}
@@ -0,0 +1,256 @@
+// Einlesen der Koordinatendatei (Format siehe in.txt) ohne Regex und ohne Allokation pro Zeile
+//
+// Die Datei wird blockweise in einen einmalig angelegten Puffer gelesen und in einem Durchgang zerlegt.
+// Zahlen werden mit std::from_chars gelesen. Für jede gültige Zeile wird ein Callback mit einem
+// ParsedCoordinate aufgerufen; der Bezeichner ist eine Sicht in den Puffer und nur während des Aufrufs gültig.
+#pragma once
+
+/// Standardbibliotheken
+#include <charconv>    // std::from_chars
+#include <cstdint>     // int-Typen
+#include <cstdio>      // std::fopen, std::fread
+#include <cstring>     // std::memchr, std::memmove
+#include <memory>      // std::unique_ptr
+#include <stdexcept>   // std::runtime_error
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <utility>     // std::forward
+
+/// Eigene Header
+#include "sphere.hpp" // directionEl, directionAz
+#include "store.hpp"  // CoordinateStore
+#include "stats.hpp"  // STATS_SCOPE
+
+// Fehler beim Einlesen, trägt die Zeilennummer (beginnend bei 1):
+struct ParseError : std::runtime_error
+{
+    const uint32_t line;
+
+    ParseError(uint32_t _line, const char *what) : std::runtime_error(what), line(_line) {}
+};
+
+// Eine eingelesene Zeile im Grad/Minuten/Sekunden-Format:
+struct ParsedCoordinate
+{
+    uint16_t phi_angle;
+    uint8_t phi_min;
+    uint8_t phi_sec;
+    directionEl phi_dir;
+
+    uint16_t lambda_angle;
+    uint8_t lambda_min;
+    uint8_t lambda_sec;
+    directionAz lambda_dir;
+
+    std::string_view name; // nur während des Callbacks gültig!
+    std::string_view code; // optionale Kennung (z.B. ICAO-Code), nur während des Callbacks gültig!
+    uint32_t line;         // Zeilennummer in der Datei
+};
+
+namespace parser
+{
+    // Überspringt Leerzeichen und Tabulatoren:
+    inline const char *skipBlank(const char *p, const char *end) noexcept
+    {
+        while ((p < end) && ((*p == ' ') || (*p == '\t')))
+            p++;
+        return p;
+    }
+
+    // Liest eine vorzeichenlose Ganzzahl <= max:
+    inline const char *readUInt(const char *p, const char *end, uint16_t max, uint16_t &out, uint32_t line)
+    {
+        p = skipBlank(p, end);
+        const auto res{std::from_chars(p, end, out)};
+
+        if ((res.ec != std::errc{}) || (out > max))
+            throw ParseError(line, "Ungültige Zahl!");
+
+        return res.ptr;
+    }
+
+    // Liest Grad, Minuten, Sekunden und Richtungsbuchstaben:
+    inline const char *readAngle(const char *p, const char *end, uint16_t maxAngle, uint16_t &angle, uint8_t &min, uint8_t &sec, char &dir, uint32_t line)
+    {
+        uint16_t m, s;
+        p = readUInt(p, end, maxAngle, angle, line);
+        p = readUInt(p, end, 59, m, line);
+        p = readUInt(p, end, 59, s, line);
+        min = static_cast<uint8_t>(m);
+        sec = static_cast<uint8_t>(s);
+
+        p = skipBlank(p, end);
+        if (p == end)
+            throw ParseError(line, "Richtung fehlt!");
+        dir = *p++;
+
+        return skipBlank(p, end);
+    }
+
+    // Zerlegt eine Zeile ohne Zeilenumbruch. Liefert false bei Leer- und Kommentarzeilen.
+    inline bool parseLine(const char *p, const char *end, uint32_t line, ParsedCoordinate &out)
+    {
+        if ((end > p) && (end[-1] == '\r')) // Windows-Zeilenenden
+            end--;
+
+        p = skipBlank(p, end);
+        if ((p == end) || (*p == '#')) // Leerzeilen und Kommentare überspringen
+            return false;
+
+        char dir;
+
+        // Breitengrad:
+        p = readAngle(p, end, 90, out.phi_angle, out.phi_min, out.phi_sec, dir, line);
+        if (dir == 'N')
+            out.phi_dir = directionEl::N;
+        else if (dir == 'S')
+            out.phi_dir = directionEl::S;
+        else
+            throw ParseError(line, "Ungültige Richtung (Elevation)!");
+
+        if ((p == end) || (*p++ != ','))
+            throw ParseError(line, "Komma nach Breitengrad fehlt!");
+
+        // Längengrad:
+        p = readAngle(p, end, 180, out.lambda_angle, out.lambda_min, out.lambda_sec, dir, line);
+        if (dir == 'W')
+            out.lambda_dir = directionAz::W;
+        else if (dir == 'O')
+            out.lambda_dir = directionAz::O;
+        else
+            throw ParseError(line, "Ungültige Richtung (Azimut)!");
+
+        // Bezeichnung (optional):
+        if ((p < end) && (*p == ','))
+            p = skipBlank(p + 1, end);
+        else if (p != end)
+            throw ParseError(line, "Komma nach Längengrad fehlt!");
+
+        // Kennung (optional), durch weiteres Komma von der Bezeichnung getrennt:
+        const auto *comma{(p < end) ? static_cast<const char *>(std::memchr(p, ',', static_cast<size_t>(end - p))) : nullptr};
+        const auto *nameEnd{comma ? comma : end};
+        while ((nameEnd > p) && ((nameEnd[-1] == ' ') || (nameEnd[-1] == '\t')))
+            nameEnd--;
+        out.name = std::string_view(p, static_cast<size_t>(nameEnd - p));
+
+        out.code = {};
+        if (comma)
+        {
+            const auto *codeBegin{skipBlank(comma + 1, end)};
+            const auto *codeEnd{end};
+            while ((codeEnd > codeBegin) && ((codeEnd[-1] == ' ') || (codeEnd[-1] == '\t')))
+                codeEnd--;
+            out.code = std::string_view(codeBegin, static_cast<size_t>(codeEnd - codeBegin));
+        }
+
+        out.line = line;
+
+        return true;
+    }
+} // namespace parser
+
+// Liest file blockweise ein und ruft onLine(const char *begin, const char *end, uint32_t line) für jede Zeile
+// (ohne Zeilenumbruch) auf. Zeilen, die nicht in einen Block passen, meldet onTooLong(uint32_t line), ihr Rest bis zum
+// nächsten Zeilenumbruch wird übersprungen. Liefert die Anzahl Zeilen. Der Puffer wird einmalig angelegt.
+template <class F, class G>
+uint32_t forEachLine(std::FILE *file, F &&onLine, G &&onTooLong, size_t chunkSize = 1 << 20)
+{
+    const std::unique_ptr<char[]> buffer{new char[chunkSize]};
+    size_t kept{0};       // unvollständige Zeile aus dem vorherigen Block
+    uint32_t line{0};     // Zeilenzähler
+    bool skipping{false}; // Rest einer zu langen Zeile
+
+    while (true)
+    {
+        const auto n{std::fread(buffer.get() + kept, 1, chunkSize - kept, file)};
+        const char *p{buffer.get()};
+        const char *const end{buffer.get() + kept + n};
+
+        if (skipping)
+        {
+            const auto nl{static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(end - p)))};
+            if (!nl)
+            {
+                if (n == 0)
+                    break;
+                continue; // ganzer Block gehört noch zur zu langen Zeile (kept ist 0)
+            }
+            p = nl + 1;
+            skipping = false;
+        }
+
+        // Alle vollständigen Zeilen des Blocks verarbeiten:
+        while (const auto nl{static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(end - p)))})
+        {
+            onLine(p, nl, ++line);
+            p = nl + 1;
+        }
+
+        kept = static_cast<size_t>(end - p);
+
+        if (n == 0) // Dateiende: letzte Zeile ohne Zeilenumbruch
+        {
+            if (kept)
+                onLine(p, end, ++line);
+            break;
+        }
+
+        if (kept == chunkSize)
+        {
+            onTooLong(++line);
+            skipping = true;
+            kept = 0;
+            continue;
+        }
+
+        std::memmove(buffer.get(), p, kept);
+    }
+
+    return line;
+}
+
+// Wie oben, wirft ParseError bei zu langen Zeilen:
+template <class F>
+uint32_t forEachLine(std::FILE *file, F &&onLine, size_t chunkSize = 1 << 20)
+{
+    return forEachLine(
+        file, std::forward<F>(onLine), [](uint32_t line) { throw ParseError(line, "Zeile zu lang!"); }, chunkSize);
+}
+
+// Liest die Datei blockweise ein und ruft onRecord(const ParsedCoordinate &) für jede Koordinate auf.
+// Liefert die Anzahl gelesener Zeilen. Wirft ParseError bei fehlerhaften Zeilen, std::runtime_error wenn die Datei fehlt.
+template <class F>
+uint32_t parseCoordinateFile(const char *filename, F &&onRecord, size_t chunkSize = 1 << 20)
+{
+    const std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::fopen(filename, "rb"), std::fclose};
+    if (!file)
+        throw std::runtime_error("Input-Datei ist fehlerhaft bzw. existiert nicht.");
+
+    ParsedCoordinate record;
+
+    return forEachLine(
+        file.get(), [&onRecord, &record](const char *begin, const char *end, uint32_t line) {
+            bool valid;
+            {
+                STATS_SCOPE(stats::Probe::ParseLine);
+                valid = parser::parseLine(begin, end, line, record);
+            }
+            if (valid)
+                onRecord(static_cast<const ParsedCoordinate &>(record));
+        },
+        chunkSize);
+}
+
+// Übernimmt eine eingelesene Zeile in den Koordinatenspeicher (Winkelfunktionen werden dabei einmalig berechnet):
+inline void addParsedCoordinate(CoordinateStore &store, const ParsedCoordinate &c)
+{
+    store.add(getAngle(AngleEl{c.phi_angle, c.phi_min, c.phi_sec, c.phi_dir}),
+              getAngle(AngleAz{c.lambda_angle, c.lambda_min, c.lambda_sec, c.lambda_dir}),
+              c.name, c.code);
+}
+
+// Liest die Datei direkt in einen Koordinatenspeicher:
+inline void loadCoordinateFile(const char *filename, CoordinateStore &store)
+{
+    parseCoordinateFile(filename, [&store](const ParsedCoordinate &c) { addParsedCoordinate(store, c); });
+}
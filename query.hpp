@@ -0,0 +1,887 @@
+// Nicht-interaktiver Stapelmodus: liest Befehle zeilenweise (Syntax wie in der Konsole, z.B. "4 A B") und
+// schreibt die Ergebnisse über einen großen Ausgabepuffer als Text, CSV, JSON-Zeilen oder Binärdatensätze.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>   // std::min
+#include <atomic>      // std::atomic
+#include <charconv>    // std::from_chars, std::to_chars
+#include <cmath>       // std::isfinite
+#include <cstdint>     // int-Typen
+#include <cstdio>      // std::FILE, std::fwrite, std::snprintf
+#include <cstring>     // std::strcmp
+#include <functional>  // std::function
+#include <limits>      // std::numeric_limits
+#include <memory>      // std::unique_ptr
+#include <mutex>       // std::call_once
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+/// Eigene Header
+#include "sphere.hpp" // calc*-Funktionen
+#include "output.hpp" // OutputBuffer, OutputFormat
+#include "store.hpp"  // CoordinateView
+#include "parser.hpp" // forEachLine
+#include "registry.hpp" // CoordinateRegistry
+#include "spatial.hpp"  // SpatialIndex
+#include "executor.hpp" // ThreadPool
+#include "route.hpp"    // GreatCircleLeg
+#include "geofence.hpp" // FenceLeg, checkGeofence
+#include "sweep.hpp"    // CrashSweep, SweepAxis
+#include "tour.hpp"     // optimizeTour
+#include "nvector.hpp"  // calc*-Funktionen je Rechenweise
+#include "ellipsoid.hpp" // WGS84-Strecken
+#include "cache.hpp"    // ResultCache
+#include "stats.hpp"    // STATS_SCOPE
+#include "libtrig.hpp"  // trig::evaluate, trig::Result
+
+namespace query
+{
+    // Zerlegt die Zeile an Leerzeichen/Tabulatoren in höchstens max Teile.
+    // Bezeichner mit Leerzeichen können in Anführungszeichen stehen ("Rio de Janeiro").
+    inline size_t tokenize(const char *p, const char *end, std::string_view *tokens, size_t max) noexcept
+    {
+        size_t n{0};
+        while (n < max)
+        {
+            p = parser::skipBlank(p, end);
+            if ((p == end) || (*p == '\r'))
+                break;
+
+            if (*p == '"')
+            {
+                const auto *start{++p};
+                while ((p < end) && (*p != '"') && (*p != '\r'))
+                    p++;
+                tokens[n++] = std::string_view(start, static_cast<size_t>(p - start));
+                if ((p < end) && (*p == '"'))
+                    p++;
+                continue;
+            }
+
+            const auto *start{p};
+            while ((p < end) && (*p != ' ') && (*p != '\t') && (*p != '\r'))
+                p++;
+            tokens[n++] = std::string_view(start, static_cast<size_t>(p - start));
+        }
+        return n;
+    }
+
+    // Kommentarzeile ("# ..."); ein leeres Token ("") ist kein Kommentar, sondern ein unbekannter Befehl:
+    inline bool isComment(std::string_view token) noexcept
+    {
+        return !token.empty() && (token[0] == '#');
+    }
+
+    // Löst eine Koordinate (Buchstabe, ID, Kennung oder Bezeichner) auf, liefert false, wenn sie nicht existiert:
+    inline bool resolve(const CoordinateRegistry &registry, std::string_view token, size_t &index) noexcept
+    {
+        const auto id{registry.resolve(token)};
+        index = id;
+        return id != InvalidId;
+    }
+
+    // Befehlsnummer am Anfang des Tokens, -1 wenn keine Zahl:
+    inline int command(std::string_view token) noexcept
+    {
+        int cmd{-1};
+        std::from_chars(token.data(), token.data() + token.size(), cmd);
+        return cmd;
+    }
+
+    inline bool toFloat(std::string_view token, float &value) noexcept
+    {
+        const auto res{std::from_chars(token.data(), token.data() + token.size(), value)};
+        return (res.ec == std::errc{}) && (res.ptr == token.data() + token.size());
+    }
+
+    // Nicht negative ganze Zahl (z.B. Anzahl der Nachbarn), Werte über SIZE_MAX werden abgewiesen:
+    inline bool toCount(std::string_view token, size_t &value) noexcept
+    {
+        const auto res{std::from_chars(token.data(), token.data() + token.size(), value)};
+        return (res.ec == std::errc{}) && (res.ptr == token.data() + token.size());
+    }
+
+    // Parameter von Befehl 7 (Geschwindigkeit, Treibstoff, Verbrauch) müssen endlich und positiv sein:
+    inline bool validCrashParams(const float *params) noexcept
+    {
+        for (int i = 0; i < 3; i++)
+            if (!std::isfinite(params[i]) || !(params[i] > 0.0f))
+                return false;
+        return true;
+    }
+
+    // Verdichtung als Anzahl ("200") oder Abstand ("50km"):
+    inline bool toRouteSpec(std::string_view token, RouteSpec &spec) noexcept
+    {
+        const auto isStep{(token.size() > 2) && (token.substr(token.size() - 2) == "km")};
+        if (isStep)
+        {
+            float step;
+            if (!toFloat(token.substr(0, token.size() - 2), step) || !(step > 0.0f))
+                return false;
+            spec.step = step;
+            return true;
+        }
+
+        uint32_t count;
+        const auto res{std::from_chars(token.data(), token.data() + token.size(), count)};
+        if ((res.ec != std::errc{}) || (res.ptr != token.data() + token.size()) || (count < 2))
+            return false;
+        spec.count = count;
+        return true;
+    }
+
+    // Stopps einer Rundreise: "*" (alle Koordinaten) oder Liste "A,B,C", liefert false bei unbekanntem Eintrag:
+    inline bool toStops(const CoordinateRegistry &registry, std::string_view token, std::vector<uint32_t> &stops)
+    {
+        stops.clear();
+        if (token == "*")
+        {
+            stops.resize(registry.view().size());
+            for (size_t i = 0; i < stops.size(); i++)
+                stops[i] = static_cast<uint32_t>(i);
+            return true;
+        }
+
+        while (!token.empty())
+        {
+            const auto comma{std::min(token.find(','), token.size())};
+            size_t id;
+            if (!resolve(registry, token.substr(0, comma), id))
+                return false;
+            stops.push_back(static_cast<uint32_t>(id));
+            token.remove_prefix(std::min(comma + 1, token.size()));
+        }
+        return true;
+    }
+
+    // Ergebnis eines Befehls (Rechnung in der Bibliothek, libtrig.cpp):
+    using Result = trig::Result;
+
+    // Berechnet einen Befehl mit der gewählten Rechenweise, wirft bei ungültigen Parametern. Das Erdmodell gilt für die
+    // Strecken (Befehle 4 und 6):
+    inline Result evaluate(int cmd, const PreparedCoordinate &A, const PreparedCoordinate &B, const float *params, Backend backend = Backend::Trig,
+                           Earth earth = Earth::Sphere)
+    {
+        STATS_SCOPE(stats::commandProbe(cmd));
+        Result res;
+        switch (trig::evaluate(cmd, A, B, params, res, backend, earth))
+        {
+        case trig::Status::Ok:
+            return res;
+        case trig::Status::UnknownCommand:
+            throw std::invalid_argument("Unbekannter Befehl!");
+        default:
+            throw std::overflow_error((backend == Backend::NVector) ? "Großkreis durch A und B ist nicht eindeutig!" : "Division durch Null!");
+        }
+    }
+
+    // Zwischenspeicher für Befehle 1 bis 7, nach dem Neuladen der Koordinaten zu leeren (invalidate):
+    using Cache = ResultCache<Result>;
+
+    // Wie evaluate, mit Nachschlagen im Cache (cache == nullptr: immer rechnen). Fehler werden nicht gespeichert:
+    inline Result evaluate(int cmd, const CoordinateView &coords, uint32_t a, uint32_t b, const float *params, Backend backend, Cache *cache,
+                           Earth earth = Earth::Sphere)
+    {
+        if (!cache)
+            return evaluate(cmd, coords.prepared(a), coords.prepared(b), params, backend, earth);
+
+        QueryKey key{cmd, a, b, {0.0f, 0.0f, 0.0f}, static_cast<uint32_t>(backend) | (static_cast<uint32_t>(earth) << 8)};
+        if (cmd == 7)
+            for (int i = 0; i < 3; i++)
+                key.params[i] = params[i];
+
+        Result res;
+        if (!cache->find(key, res))
+        {
+            res = evaluate(cmd, coords.prepared(a), coords.prepared(b), params, backend, earth);
+            cache->insert(key, res);
+        }
+        return res;
+    }
+
+    inline const char *positionName(PeakPosition position) noexcept
+    {
+        switch (position)
+        {
+        case PeakPosition::Zwischen:
+            return "innerhalb";
+        case PeakPosition::VorA:
+            return "vor A";
+        case PeakPosition::HinterB:
+            return "hinter B";
+        default:
+            return "";
+        }
+    }
+
+    // Beschriftung je Befehl im Textformat:
+    inline const char *label(int cmd) noexcept
+    {
+        switch (cmd)
+        {
+        case 1:
+            return "Zentriwinkel";
+        case 2:
+            return "Kurswinkel";
+        case 3:
+            return "Nördlichster Punkt";
+        case 4:
+            return "Strecke";
+        case 5:
+            return "Loxodromischer Kurs";
+        case 6:
+            return "Loxodromische Länge";
+        case 7:
+            return "Zwischenpunkt";
+        case 9:
+            return "Nächster Nachbar";
+        case 10:
+            return "Im Umkreis";
+        case 11:
+            return "Wegpunkt";
+        case 12:
+            return "Korridor";
+        case 13:
+            return "Reichweite";
+        case 14:
+            return "Rundreise";
+        default:
+            return "";
+        }
+    }
+
+    // Grad/Minuten/Sekunden wie Angle::print (gleiche Umrechnung splitDMS), ohne Auffüllen:
+    inline void writeDMS(OutputBuffer &out, float angle, char pos, char neg)
+    {
+        const auto [deg, min, sec] = splitDMS(rad2deg(angle));
+        out << uint32_t{deg} << "° " << uint32_t{min} << "' " << uint32_t{sec} << "'' " << ((angle < 0) ? neg : pos);
+    }
+
+    // Fehlermeldungen des Stapelmodus, im Binärformat als Nummer (Index + 1) kodiert:
+    constexpr const char *Errors[]{"Unbekannter Befehl", "Kein zugehöriges Koordinatenobjekt", "Start und Ziel ist gleiche Koordinate",
+                                   "Parameter fehlen", "Ungültige Parameter", "Zeile zu lang"};
+
+    inline uint8_t errorCode(const char *error) noexcept
+    {
+        if (!error)
+            return 0;
+        for (uint8_t i = 0; i < sizeof(Errors) / sizeof(Errors[0]); i++)
+            if (std::strcmp(error, Errors[i]) == 0)
+                return i + 1;
+        return 0xFF;
+    }
+
+    // Ergebnis im Binärformat (28 Byte, Winkel im Bogenmaß, nicht belegte Werte NaN, IDs bei Fehlern InvalidId):
+    struct BinaryRecord
+    {
+        uint32_t line;
+        uint32_t from, to;   // IDs im Koordinatenspeicher
+        float value;         // Befehle 1, 2, 4, 5, 6 und Wegpunkte (Strecke ab A)
+        float phi, lambda;   // Befehle 3, 7, 9, 10, 11
+        uint8_t cmd;
+        uint8_t error;       // 0 = kein Fehler, sonst errorCode
+        uint8_t position;    // PeakPosition
+        uint8_t unit;        // 0 = keine, 1 = Grad, 2 = km
+    };
+    static_assert(sizeof(BinaryRecord) == 28, "BinaryRecord darf keine Füllbytes enthalten");
+
+    // Anfrage im Binärformat (Servermodus, 24 Byte): Befehle 1 bis 7 über IDs, params nur für Befehl 7 (v, fuel, k):
+    struct BinaryRequest
+    {
+        uint8_t cmd;
+        uint8_t reserved[3];
+        uint32_t from, to;
+        float params[3];
+    };
+    static_assert(sizeof(BinaryRequest) == 24, "BinaryRequest darf keine Füllbytes enthalten");
+
+    inline BinaryRecord toBinaryRecord(uint32_t line, int cmd, uint32_t a, uint32_t b, const Result &res, const char *error) noexcept
+    {
+        constexpr auto none{std::numeric_limits<float>::quiet_NaN()};
+        const auto valid{!error};
+        return BinaryRecord{line, a, b,
+                            (valid && (!res.point || res.unit[0])) ? res.value : none,
+                            (valid && res.point) ? res.phi : none,
+                            (valid && res.point) ? res.lambda : none,
+                            static_cast<uint8_t>((cmd < 0) ? 0 : cmd),
+                            errorCode(error),
+                            static_cast<uint8_t>(res.position),
+                            static_cast<uint8_t>(!valid ? 0 : (res.unit[0] == 'G') ? 1 : (res.unit[0] == 'k') ? 2 : 0)};
+    }
+
+    // Führt einzelne Befehlszeilen gegen ein Verzeichnis aus und schreibt die Ergebnisse im gewählten Format (gemeinsam
+    // für runBatch und den Servermodus). execute() darf gleichzeitig aus mehreren Threads aufgerufen werden, jeder mit
+    // eigenem Puffer. Der räumliche Index wird beim ersten Suchbefehl über index() geholt bzw. ohne index selbst aufgebaut.
+    class Executor
+    {
+    public:
+        Executor(const CoordinateRegistry &_registry, OutputFormat _format, ThreadPool *_pool = nullptr, Backend _backend = Backend::Trig,
+                 Cache *_cache = nullptr, Earth _earth = Earth::Sphere, std::function<const SpatialIndex &()> _index = {})
+            : registry(_registry), coords(_registry.view()), format(_format), pool(_pool), backend(_backend), cache(_cache), earth(_earth),
+              index(std::move(_index))
+        {
+        }
+
+        // Kopf der Ausgabe (CSV-Spaltennamen bzw. BinaryHeader), einmal vor allen Ergebnissen:
+        static void header(OutputBuffer &buf, OutputFormat format)
+        {
+            if (format == OutputFormat::CSV)
+                buf << "line,cmd,from,to,value,unit,phi,lambda,position,error\n";
+            else if (format == OutputFormat::Binary)
+                buf.binary(BinaryHeader{{'T', 'R', 'G', 'Q'}, sizeof(BinaryRecord)});
+        }
+
+        // Schreibt einen Ergebnis- bzw. Fehlereintrag im gewählten Format (a, b: IDs von Start und Ziel, bei Fehlern InvalidId):
+        void record(OutputBuffer &buf, uint32_t line, int cmd, uint32_t a, uint32_t b, const Result &res, const char *error) const
+        {
+            STATS_SCOPE(stats::Probe::Format);
+            const auto from{(a != InvalidId) ? coords.name(a) : std::string_view{}};
+            const auto to{(b != InvalidId) ? coords.name(b) : std::string_view{}};
+            switch (format)
+            {
+            case OutputFormat::Text:
+                if (error)
+                    buf << "Fehler in Zeile " << line << ": " << error << '\n';
+                else if (res.point)
+                {
+                    buf << query::label(cmd) << " auf Großkreis von " << from << " nach " << to << ":\t";
+                    query::writeDMS(buf, res.phi, 'N', 'S');
+                    buf << '\t';
+                    query::writeDMS(buf, res.lambda, 'O', 'W');
+                    if (res.unit[0]) // Wegpunkte tragen zusätzlich die Strecke ab A
+                    {
+                        buf << '\t';
+                        buf.number(res.value, 5) << ' ' << res.unit;
+                    }
+                    if (res.position != PeakPosition::Unbestimmt)
+                        buf << " (" << query::positionName(res.position) << ')';
+                    buf << '\n';
+                }
+                else
+                {
+                    buf << query::label(cmd) << " von " << from << " nach " << to << ":\t";
+                    buf.number(res.value, (res.unit[0] == 'k') ? 5 : 4) << ' ' << res.unit << '\n';
+                }
+                break;
+
+            case OutputFormat::CSV:
+                buf << line << ',' << static_cast<uint32_t>(cmd) << ',';
+                buf.csv(from) << ',';
+                buf.csv(to) << ',';
+                if (!error && (!res.point || res.unit[0]))
+                    buf.number(res.value, 9) << ',' << res.unit;
+                else
+                    buf << ',';
+                buf << ',';
+                if (!error && res.point)
+                {
+                    buf.number(rad2deg(res.phi), 9) << ',';
+                    buf.number(rad2deg(res.lambda), 9);
+                }
+                else
+                    buf << ',';
+                buf << ',' << query::positionName(res.position) << ',' << (error ? error : "") << '\n';
+                break;
+
+            case OutputFormat::JSON:
+                buf << "{\"line\":" << line << ",\"cmd\":" << static_cast<uint32_t>(cmd < 0 ? 0 : cmd);
+                if (error)
+                {
+                    buf << ",\"error\":";
+                    buf.json(error) << "}\n";
+                    break;
+                }
+                buf << ",\"from\":";
+                buf.json(from) << ",\"to\":";
+                buf.json(to);
+                if (res.point)
+                {
+                    buf << ",\"phi\":";
+                    buf.jsonNumber(rad2deg(res.phi), 9) << ",\"lambda\":";
+                    buf.jsonNumber(rad2deg(res.lambda), 9);
+                    if (res.unit[0])
+                    {
+                        buf << ",\"value\":";
+                        buf.jsonNumber(res.value, 9) << ",\"unit\":";
+                        buf.json(res.unit);
+                    }
+                    if (res.position != PeakPosition::Unbestimmt)
+                    {
+                        buf << ",\"position\":";
+                        buf.json(query::positionName(res.position));
+                    }
+                }
+                else
+                {
+                    buf << ",\"value\":";
+                    buf.jsonNumber(res.value, 9) << ",\"unit\":";
+                    buf.json(res.unit);
+                }
+                buf << "}\n";
+                break;
+
+            case OutputFormat::Binary:
+                buf.binary(query::toBinaryRecord(line, cmd, a, b, res, error));
+                break;
+            }
+        }
+
+        // Führt eine Zeile aus (Befehl 0 wird vorher abgefangen) und schreibt nach buf:
+        void execute(OutputBuffer &buf, const char *begin, const char *end, uint32_t line)
+        {
+            std::string_view tok[7];
+            const auto n{query::tokenize(begin, end, tok, 7)};
+            if ((n == 0) || query::isComment(tok[0])) // Leerzeilen und Kommentare überspringen
+                return;
+
+            const auto cmd{query::command(tok[0])};
+
+            size_t a{0}, b{0};
+            float params[3]{};
+            const char *error{nullptr};
+
+            // Suchbefehle liefern einen Eintrag je Treffer:
+            if ((cmd == 9) || (cmd == 10))
+            {
+                size_t k{0}; // Befehl 9: Anzahl als ganze Zahl, höchstens alle Koordinaten
+                if ((n < 2) || !query::resolve(registry, tok[1], a))
+                    error = "Kein zugehöriges Koordinatenobjekt";
+                else if ((n < 3) || ((cmd == 9) ? !query::toCount(tok[2], k) : (!query::toFloat(tok[2], params[0]) || !(params[0] >= 0.0f))))
+                    error = "Parameter fehlen";
+
+                if (error)
+                    return record(buf, line, cmd, InvalidId, InvalidId, query::Result{}, error);
+
+                const auto &index{spatialIndex()};
+                const auto q{coords.prepared(a)};
+                const auto hits{(cmd == 9) ? index.nearest(q, std::min(k, coords.size()), q.id) : index.within(q, params[0], q.id)};
+
+                query::Result res;
+                res.unit = "km";
+                for (const auto &hit : hits)
+                {
+                    res.value = hit.km;
+                    record(buf, line, cmd, static_cast<uint32_t>(a), hit.id, res, nullptr);
+                }
+                executed++;
+                return;
+            }
+
+            // Verdichtung einer Strecke liefert einen Eintrag je Wegpunkt:
+            if (cmd == 11)
+            {
+                RouteSpec spec;
+                if ((n < 3) || !query::resolve(registry, tok[1], a) || !query::resolve(registry, tok[2], b))
+                    error = "Kein zugehöriges Koordinatenobjekt";
+                else if (a == b)
+                    error = "Start und Ziel ist gleiche Koordinate";
+                else if ((n > 3) && !query::toRouteSpec(tok[3], spec))
+                    error = "Parameter fehlen";
+
+                if (!error)
+                {
+                    try
+                    {
+                        const GreatCircleLeg leg(coords.prepared(a), coords.prepared(b));
+                        query::Result res;
+                        res.point = true;
+                        res.unit = "km";
+                        leg.densify(spec, [&](const float *phi, const float *lambda, const float *km, size_t count, size_t) {
+                            for (size_t i = 0; i < count; i++)
+                            {
+                                res.phi = phi[i];
+                                res.lambda = lambda[i];
+                                res.value = km[i];
+                                record(buf, line, cmd, static_cast<uint32_t>(a), static_cast<uint32_t>(b), res, nullptr);
+                            }
+                        });
+                        executed++;
+                        return;
+                    }
+                    catch (const std::exception &)
+                    {
+                        error = "Ungültige Parameter";
+                    }
+                }
+                return record(buf, line, cmd, InvalidId, InvalidId, query::Result{}, error);
+            }
+
+            // Korridorprüfung liefert einen Eintrag je Koordinate mit Abstand <= km zur Strecke A->B (von A, nach Treffer;
+            // Punkt der größten Annäherung, Querabstand als Wert, Lage des Lotfußpunkts):
+            if (cmd == 12)
+            {
+                if ((n < 3) || !query::resolve(registry, tok[1], a) || !query::resolve(registry, tok[2], b))
+                    error = "Kein zugehöriges Koordinatenobjekt";
+                else if (a == b)
+                    error = "Start und Ziel ist gleiche Koordinate";
+                else if ((n < 4) || !query::toFloat(tok[3], params[0]) || !(params[0] >= 0.0f))
+                    error = "Parameter fehlen";
+
+                if (!error)
+                {
+                    try
+                    {
+                        const FenceLeg leg(coords.prepared(a), coords.prepared(b));
+                        query::Result res;
+                        res.point = true;
+                        res.unit = "km";
+                        for (const auto &hit : checkGeofence(coords, &leg, 1, params[0]))
+                        {
+                            if ((hit.point == a) || (hit.point == b))
+                                continue;
+                            const auto closest{hit.track.closest(leg)};
+                            res.phi = closest.phi;
+                            res.lambda = closest.lambda;
+                            res.value = hit.track.cross;
+                            res.position = hit.track.position;
+                            record(buf, line, cmd, static_cast<uint32_t>(a), hit.point, res, nullptr);
+                        }
+                        executed++;
+                        return;
+                    }
+                    catch (const std::exception &)
+                    {
+                        error = "Ungültige Parameter";
+                    }
+                }
+                return record(buf, line, cmd, InvalidId, InvalidId, query::Result{}, error);
+            }
+
+            // Parameterstudie liefert einen Eintrag je Gitterpunkt (v außen, k innen) bzw. mit "l" je Punkt der Linie der
+            // erreichbaren Punkte, Abstand von A als Wert:
+            if (cmd == 13)
+            {
+                if ((n < 3) || !query::resolve(registry, tok[1], a) || !query::resolve(registry, tok[2], b))
+                    error = "Kein zugehöriges Koordinatenobjekt";
+                else if (a == b)
+                    error = "Start und Ziel ist gleiche Koordinate";
+                else if (n < 6)
+                    error = "Parameter fehlen";
+
+                if (!error)
+                {
+                    try
+                    {
+                        const auto v{SweepAxis::parse(tok[3])}, fuel{SweepAxis::parse(tok[4])}, k{SweepAxis::parse(tok[5])};
+                        const CrashSweep sweep(coords.prepared(a), coords.prepared(b));
+                        query::Result res;
+                        res.point = true;
+                        res.unit = "km";
+                        std::vector<SweepPoint> points;
+                        if ((n > 6) && (tok[6] == "l"))
+                            points = sweep.reachable(v, fuel, k, pool);
+                        else
+                        {
+                            points.resize(v.size() * fuel.size() * k.size());
+                            sweep.sweep(v, fuel, k, [&points](const SweepPoint *block, size_t count, size_t first) { std::copy(block, block + count, points.begin() + first); }, pool);
+                        }
+                        for (const auto &p : points)
+                        {
+                            res.phi = p.phi;
+                            res.lambda = p.lambda;
+                            res.value = p.along;
+                            record(buf, line, cmd, static_cast<uint32_t>(a), static_cast<uint32_t>(b), res, nullptr);
+                        }
+                        executed++;
+                        return;
+                    }
+                    catch (const std::exception &)
+                    {
+                        error = "Ungültige Parameter";
+                    }
+                }
+                return record(buf, line, cmd, InvalidId, InvalidId, query::Result{}, error);
+            }
+
+            // Rundreise liefert einen Eintrag je Stopp in optimierter Reihenfolge (von Stopp, nach nächstem Stopp; Koordinaten
+            // des Stopps, aufsummierte Strecke ab dem ersten Stopp als Wert), nur der Endstand wird geschrieben:
+            if (cmd == 14)
+            {
+                TourOptions options;
+                std::vector<uint32_t> stops;
+                if ((n < 2) || !query::toFloat(tok[1], params[0]) || !(params[0] >= 0.0f))
+                    error = "Parameter fehlen";
+                else if (!query::toStops(registry, (n > 2) ? tok[2] : std::string_view{"*"}, stops))
+                    error = "Kein zugehöriges Koordinatenobjekt";
+
+                if (!error)
+                {
+                    try
+                    {
+                        options.seconds = params[0];
+                        const auto order{optimizeTour(coords, stops, options, [](const TourProgress &) {}, pool)};
+                        query::Result res;
+                        res.point = true;
+                        res.unit = "km";
+                        res.value = 0.0f;
+                        for (size_t i = 0; i < order.size(); i++)
+                        {
+                            const auto next{order[(i + 1) % order.size()]};
+                            const auto stop{coords.prepared(order[i])};
+                            res.phi = stop.phi;
+                            res.lambda = stop.lambda;
+                            record(buf, line, cmd, order[i], next, res, nullptr);
+                            res.value += calcGCDkm(stop, coords.prepared(next));
+                        }
+                        executed++;
+                        return;
+                    }
+                    catch (const std::exception &)
+                    {
+                        error = "Ungültige Parameter";
+                    }
+                }
+                return record(buf, line, cmd, InvalidId, InvalidId, query::Result{}, error);
+            }
+
+            if ((cmd < 1) || (cmd > 7))
+                error = "Unbekannter Befehl";
+            else if ((n < 3) || !query::resolve(registry, tok[1], a) || !query::resolve(registry, tok[2], b))
+                error = "Kein zugehöriges Koordinatenobjekt";
+            else if (a == b)
+                error = "Start und Ziel ist gleiche Koordinate";
+            else if ((cmd == 7) && ((n < 6) || !query::toFloat(tok[3], params[0]) || !query::toFloat(tok[4], params[1]) || !query::toFloat(tok[5], params[2])))
+                error = "Parameter fehlen";
+            else if ((cmd == 7) && !query::validCrashParams(params))
+                error = "Ungültige Parameter";
+
+            query::Result res;
+            if (!error)
+            {
+                try
+                {
+                    res = query::evaluate(cmd, coords, static_cast<uint32_t>(a), static_cast<uint32_t>(b), params, backend, cache, earth);
+                    executed++;
+                }
+                catch (const std::exception &)
+                {
+                    error = "Ungültige Parameter";
+                }
+            }
+
+            if (error)
+                record(buf, line, cmd, InvalidId, InvalidId, res, error);
+            else
+                record(buf, line, cmd, static_cast<uint32_t>(a), static_cast<uint32_t>(b), res, nullptr);
+        }
+
+        // Führt eine Binäranfrage aus (IDs statt Bezeichner, sonst wie execute):
+        void execute(OutputBuffer &buf, const BinaryRequest &request, uint32_t line)
+        {
+            const int cmd{request.cmd};
+            const char *error{nullptr};
+
+            if ((cmd < 1) || (cmd > 7))
+                error = "Unbekannter Befehl";
+            else if ((request.from >= coords.size()) || (request.to >= coords.size()))
+                error = "Kein zugehöriges Koordinatenobjekt";
+            else if (request.from == request.to)
+                error = "Start und Ziel ist gleiche Koordinate";
+            else if ((cmd == 7) && !query::validCrashParams(request.params)) // kommen ungeprüft vom Socket
+                error = "Ungültige Parameter";
+
+            query::Result res;
+            if (!error)
+            {
+                try
+                {
+                    res = query::evaluate(cmd, coords, request.from, request.to, request.params, backend, cache, earth);
+                    executed++;
+                }
+                catch (const std::exception &)
+                {
+                    error = "Ungültige Parameter";
+                }
+            }
+
+            if (error)
+                record(buf, line, cmd, InvalidId, InvalidId, res, error);
+            else
+                record(buf, line, cmd, request.from, request.to, res, nullptr);
+        }
+
+        // Liefert true, wenn die Zeile das Ende der Befehle markiert (Befehl 0):
+        static bool isExit(const char *begin, const char *end) noexcept
+        {
+            std::string_view tok[1];
+            return tokenize(begin, end, tok, 1) && !isComment(tok[0]) && (command(tok[0]) == 0);
+        }
+
+        // Anzahl ausgeführter Befehle:
+        uint32_t count(void) const noexcept
+        {
+            return executed;
+        }
+
+    private:
+        const CoordinateRegistry &registry;
+        const CoordinateView &coords;
+        const OutputFormat format;
+        ThreadPool *const pool;
+        const Backend backend;
+        Cache *const cache;
+        const Earth earth;
+        const std::function<const SpatialIndex &()> index;
+
+        std::atomic<uint32_t> executed{0};
+        std::unique_ptr<SpatialIndex> ownIndex; // ohne index: wird erst beim ersten Suchbefehl aufgebaut
+        std::once_flag indexBuilt;
+
+        const SpatialIndex &spatialIndex(void)
+        {
+            if (index)
+                return index();
+            std::call_once(indexBuilt, [this]() { ownIndex = std::make_unique<SpatialIndex>(coords); });
+            return *ownIndex;
+        }
+    };
+} // namespace query
+
+// Führt alle Befehle aus in aus und schreibt die Ergebnisse nach out. Liefert die Anzahl ausgeführter Befehle.
+// Ungültige Zeilen erzeugen einen Fehlereintrag mit Zeilennummer, die Verarbeitung läuft weiter.
+// Mit pool werden die Zeilen blockweise parallel ausgeführt, die Ausgabe bleibt in Eingabereihenfolge.
+// Mit cache werden Ergebnisse der Befehle 1 bis 7 für wiederholte Abfragen zwischengespeichert.
+inline uint32_t runBatch(const CoordinateRegistry &registry, std::FILE *in, std::FILE *out, OutputFormat format, ThreadPool *pool = nullptr,
+                         Backend backend = Backend::Trig, query::Cache *cache = nullptr, Earth earth = Earth::Sphere)
+{
+    OutputBuffer output(out);
+    query::Executor executor(registry, format, pool, backend, cache, earth);
+    bool stop{false};
+
+    query::Executor::header(output, format);
+
+    // Zeilen über 1 MiB werden als Fehlereintrag gemeldet und übersprungen:
+    const auto tooLong = [&executor](OutputBuffer &buf, uint32_t line) {
+        executor.record(buf, line, -1, InvalidId, InvalidId, query::Result{}, "Zeile zu lang");
+    };
+
+    if (!pool || (pool->size() == 1))
+    {
+        forEachLine(
+            in,
+            [&](const char *begin, const char *end, uint32_t line) {
+                stop = stop || query::Executor::isExit(begin, end);
+                if (!stop)
+                    executor.execute(output, begin, end, line);
+            },
+            [&](uint32_t line) {
+                if (!stop)
+                    tooLong(output, line);
+            });
+        return executor.count();
+    }
+
+    // Parallel: Zeilen blockweise sammeln, in Teilblöcken mit eigenem Puffer ausführen, in Eingabereihenfolge ausgeben
+    constexpr size_t BlockLines{1 << 16}, TaskLines{512};
+    struct PendingLine
+    {
+        size_t offset, length;
+        uint32_t line;
+        bool tooLong; // nur Fehlereintrag, kein Text
+    };
+    std::string text;
+    std::vector<PendingLine> pending;
+    std::vector<std::string> results;
+
+    const auto drain = [&]() {
+        const auto tasks{(pending.size() + TaskLines - 1) / TaskLines};
+        results.resize(tasks);
+        pool->run(tasks, [&](size_t t) {
+            OutputBuffer local(nullptr, 0);
+            for (size_t i = t * TaskLines; i < std::min(pending.size(), (t + 1) * TaskLines); i++)
+                if (pending[i].tooLong)
+                    tooLong(local, pending[i].line);
+                else
+                    executor.execute(local, text.data() + pending[i].offset, text.data() + pending[i].offset + pending[i].length, pending[i].line);
+            results[t] = local.take();
+        });
+        for (size_t t = 0; t < tasks; t++)
+            output << std::string_view(results[t]);
+        text.clear();
+        pending.clear();
+    };
+
+    const auto push = [&](PendingLine pendingLine) {
+        pending.push_back(pendingLine);
+        if (pending.size() == BlockLines)
+            drain();
+    };
+
+    forEachLine(
+        in,
+        [&](const char *begin, const char *end, uint32_t line) {
+            stop = stop || query::Executor::isExit(begin, end);
+            if (stop)
+                return;
+
+            text.append(begin, end);
+            push(PendingLine{text.size() - static_cast<size_t>(end - begin), static_cast<size_t>(end - begin), line, false});
+        },
+        [&](uint32_t line) {
+            if (!stop)
+                push(PendingLine{text.size(), 0, line, true});
+        });
+    drain();
+
+    return executor.count();
+}
+
+// Wegpunkt im Binärformat (16 Byte, Winkel im Bogenmaß):
+struct RouteRecord
+{
+    uint32_t index;
+    float km, phi, lambda;
+};
+static_assert(sizeof(RouteRecord) == 16, "RouteRecord darf keine Füllbytes enthalten");
+
+// Schreibt die Wegpunkte einer Strecke nach out: Text (Nr., km, Grad/Minuten/Sekunden), CSV bzw. JSON-Zeilen
+// (index,km,phi,lambda in Grad) oder Binär (Kopf "TRGW", danach RouteRecord). Es werden keine Coordinate-Objekte angelegt, die Ausgabe läuft über den Puffer.
+inline size_t writeRoute(const GreatCircleLeg &leg, const RouteSpec &spec, std::FILE *out, OutputFormat format)
+{
+    OutputBuffer buf(out);
+    size_t points{0};
+
+    if (format == OutputFormat::CSV)
+        buf << "index,km,phi,lambda\n";
+    else if (format == OutputFormat::Binary)
+        buf.binary(BinaryHeader{{'T', 'R', 'G', 'W'}, sizeof(RouteRecord)});
+
+    leg.densify(spec, [&](const float *phi, const float *lambda, const float *km, size_t count, size_t first) {
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto index{static_cast<uint32_t>(first + i)};
+            switch (format)
+            {
+            case OutputFormat::Text:
+                buf << index << '\t';
+                buf.number(km[i], 6) << " km\t";
+                query::writeDMS(buf, phi[i], 'N', 'S');
+                buf << '\t';
+                query::writeDMS(buf, lambda[i], 'O', 'W');
+                buf << '\n';
+                break;
+            case OutputFormat::CSV:
+                buf << index << ',';
+                buf.number(km[i], 9) << ',';
+                buf.number(rad2deg(phi[i]), 9) << ',';
+                buf.number(rad2deg(lambda[i]), 9) << '\n';
+                break;
+            case OutputFormat::JSON:
+                buf << "{\"index\":" << index << ",\"km\":";
+                buf.jsonNumber(km[i], 9) << ",\"phi\":";
+                buf.jsonNumber(rad2deg(phi[i]), 9) << ",\"lambda\":";
+                buf.jsonNumber(rad2deg(lambda[i]), 9) << "}\n";
+                break;
+            case OutputFormat::Binary:
+                buf.binary(RouteRecord{index, km[i], phi[i], lambda[i]});
+                break;
+            }
+        }
+        points += count;
+    });
+
+    return points;
+}
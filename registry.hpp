@@ -0,0 +1,309 @@
+// Hash-Verzeichnis der Koordinaten: Auflösung von Bezeichnern und Kennungen auf 32-Bit-IDs
+//
+// Die ID einer Koordinate ist ihr Index im Koordinatenspeicher. Das Verzeichnis speichert keine Zeichenketten,
+// sondern nur Hashwert und Verweis (ID + Art) in einer offenen Hashtabelle mit linearer Sondierung. Der
+// Schlüsselvergleich liest den Text aus der CoordinateView, die Tabelle bleibt damit bei Millionen Einträgen
+// klein (8 Byte je Platz) und kann auch über einer eingeblendeten Datenbank aufgebaut werden.
+//
+// Angehängte Koordinaten (Neuladen einer gewachsenen Datei) kommen in eine eigene Ebene über dem unveränderten
+// Verzeichnis des vorherigen Stands, das dabei weder kopiert noch neu gehasht wird. Ebenen, die nicht größer sind als
+// die neue, werden mit ihr zusammengefasst (logarithmische Methode): je Schlüssel amortisiert O(log n) Einfügungen,
+// eine Suche prüft höchstens log2(n) + 1 Ebenen. Schlüsseltexte liest immer die Sicht der obersten Ebene, die Sichten
+// älterer Ebenen können auf inzwischen freigegebene Spalten zeigen.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>   // std::max
+#include <charconv>    // std::from_chars
+#include <cstddef>     // size_t
+#include <cstdint>     // int-Typen
+#include <memory>      // std::shared_ptr
+#include <stdexcept>   // std::length_error
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+/// Eigene Header
+#include "store.hpp" // CoordinateView
+#include "stats.hpp" // STATS_SCOPE
+
+constexpr uint32_t InvalidId{UINT32_MAX};
+
+class CoordinateRegistry
+{
+public:
+    CoordinateRegistry() = default;
+
+    // Baut das Verzeichnis über alle Bezeichner und Kennungen auf. Die Sicht muss länger leben als das Verzeichnis.
+    explicit CoordinateRegistry(const CoordinateView &_coords) : coords(_coords)
+    {
+        if (coords.size() > (UINT32_MAX >> 1)) // ein Bit des Verweises kennzeichnet die Art
+            throw std::length_error("Zu viele Koordinaten für das Verzeichnis!");
+
+        // Kapazität: Zweierpotenz mit Füllgrad <= 50 %
+        keys = countKeys(coords, 0, coords.size());
+
+        size_t capacity{16};
+        while (capacity < 2 * keys)
+            capacity <<= 1;
+
+        slots.assign(capacity, Slot{});
+        mask = capacity - 1;
+
+        for (size_t i = 0; i < coords.size(); i++)
+        {
+            insert(coords.name(i), static_cast<uint32_t>(i), false);
+            insert(coords.code(i), static_cast<uint32_t>(i), true);
+        }
+    }
+
+    // Übernimmt das Verzeichnis eines vorherigen Stands, in dem die Koordinaten [first; end) durch [first; end + delta)
+    // aus coords ersetzt wurden (IDs dahinter um delta verschoben). Nur die Schlüssel des geänderten Bereichs werden
+    // entfernt bzw. eingefügt; steigt der Füllgrad über 50 %, wird neu aufgebaut. Ebenen von previous werden dabei zu
+    // einer Tabelle zusammengeführt.
+    CoordinateRegistry(const CoordinateView &_coords, const CoordinateRegistry &previous, size_t first, size_t end, int64_t delta)
+    {
+        size_t oldKeys{0};
+        for (auto *layer = &previous; layer; layer = layer->below.get())
+            oldKeys += layer->keys;
+
+        const auto changedEnd{static_cast<size_t>(static_cast<int64_t>(end) + delta)};
+        const auto newKeys{oldKeys - countKeys(previous.coords, first, end) + countKeys(_coords, first, changedEnd)};
+        if (previous.slots.empty() || (!previous.below && (2 * newKeys > previous.slots.size())) || (_coords.size() > (UINT32_MAX >> 1)))
+        {
+            *this = CoordinateRegistry(_coords);
+            return;
+        }
+
+        coords = _coords;
+        keys = newKeys;
+        if (!previous.below)
+        {
+            slots = previous.slots;
+            mask = previous.mask;
+        }
+        else
+        {
+            // Plätze aller Ebenen umsetzen, ohne die Schlüssel erneut zu hashen (der Hashwert steht im Platz):
+            size_t capacity{16};
+            while (capacity < 2 * std::max(oldKeys, newKeys))
+                capacity <<= 1;
+
+            slots.assign(capacity, Slot{});
+            mask = capacity - 1;
+            for (auto *layer = &previous; layer; layer = layer->below.get())
+                for (const auto &slot : layer->slots)
+                    if (slot.ref != 0)
+                        place(slot);
+        }
+
+        for (size_t i = first; i < end; i++)
+        {
+            erase(previous.coords.name(i), static_cast<uint32_t>(i), false);
+            erase(previous.coords.code(i), static_cast<uint32_t>(i), true);
+        }
+        if (delta != 0)
+            for (auto &slot : slots)
+                if ((slot.ref != 0) && (id(slot) >= end))
+                    slot.ref = static_cast<uint32_t>(slot.ref + 2 * delta);
+        for (size_t i = first; i < changedEnd; i++)
+        {
+            insert(coords.name(i), static_cast<uint32_t>(i), false);
+            insert(coords.code(i), static_cast<uint32_t>(i), true);
+        }
+    }
+
+    // Erweitert das Verzeichnis previous um die angehängten Koordinaten [previous->size(); coords.size()), siehe oben:
+    CoordinateRegistry(const CoordinateView &_coords, std::shared_ptr<const CoordinateRegistry> previous) : coords(_coords)
+    {
+        if (coords.size() > (UINT32_MAX >> 1))
+            throw std::length_error("Zu viele Koordinaten für das Verzeichnis!");
+
+        first = previous->size();
+        below = std::move(previous);
+        while (below && (below->size() - below->first <= coords.size() - first))
+        {
+            first = below->first;
+            below = below->below;
+        }
+
+        keys = countKeys(coords, first, coords.size());
+        size_t capacity{16};
+        while (capacity < 2 * keys)
+            capacity <<= 1;
+
+        slots.assign(capacity, Slot{});
+        mask = capacity - 1;
+
+        for (size_t i = first; i < coords.size(); i++)
+        {
+            insert(coords.name(i), static_cast<uint32_t>(i), false);
+            insert(coords.code(i), static_cast<uint32_t>(i), true);
+        }
+    }
+
+    size_t size(void) const noexcept
+    {
+        return coords.size();
+    }
+
+    // Anzahl Ebenen (1 ohne angehängte Koordinaten):
+    size_t layers(void) const noexcept
+    {
+        size_t n{1};
+        for (auto *layer = below.get(); layer; layer = layer->below.get())
+            n++;
+        return n;
+    }
+
+    const CoordinateView &view(void) const noexcept
+    {
+        return coords;
+    }
+
+    // Sucht eine Kennung bzw. einen Bezeichner. Kennungen haben Vorrang; bei mehrfach vergebenen Schlüsseln
+    // gewinnt der erste Eintrag der Datei (kleinste ID, unabhängig von der Einfügereihenfolge). Liefert InvalidId, wenn
+    // nichts gefunden wurde.
+    uint32_t find(std::string_view key) const noexcept
+    {
+        if (key.empty())
+            return InvalidId;
+
+        const auto h{hash(key)};
+        uint32_t byCode{InvalidId}, byName{InvalidId};
+
+        for (auto *layer = this; layer; layer = layer->below.get())
+        {
+            if (layer->slots.empty())
+                continue;
+
+            for (size_t pos = h & layer->mask; layer->slots[pos].ref != 0; pos = (pos + 1) & layer->mask)
+            {
+                const auto &slot{layer->slots[pos]};
+                if ((slot.hash != h) || (text(slot) != key))
+                    continue;
+
+                auto &best{isCode(slot) ? byCode : byName};
+                if (id(slot) < best)
+                    best = id(slot);
+            }
+        }
+
+        return (byCode != InvalidId) ? byCode : byName;
+    }
+
+    // Löst eine Eingabe auf:
+    //   "#17"            direkte ID (wie von coordinateLabel ausgegeben)
+    //   "A" ... "Z"      bisherige Buchstabenbezeichnung (nur wenn die ID existiert)
+    //   sonst            Kennung, dann Bezeichner; nur aus Ziffern ("17") ohne Treffer als ID
+    uint32_t resolve(std::string_view token) const noexcept
+    {
+        STATS_SCOPE(stats::Probe::Lookup);
+        if (token.empty())
+            return InvalidId;
+
+        if (token[0] == '#')
+            return toId(token.substr(1));
+
+        if ((token.size() == 1) && (token[0] >= 'A') && (token[0] <= 'Z') && (static_cast<size_t>(token[0] - 'A') < size()))
+            return static_cast<uint32_t>(token[0] - 'A');
+
+        const auto id{find(token)}; // numerische Kennungen/Bezeichner haben Vorrang vor der ID
+        return (id != InvalidId) ? id : toId(token);
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t hash{0};
+        uint32_t ref{0}; // 0 = frei, sonst ((id << 1) | istKennung) + 1
+    };
+
+    CoordinateView coords;
+    std::vector<Slot> slots;
+    size_t mask{0};
+    size_t keys{0}; // belegte Plätze
+
+    size_t first{0};                                // Schlüssel der Koordinaten [first; size()) liegen in slots ...
+    std::shared_ptr<const CoordinateRegistry> below; // ... die davor in den Ebenen darunter
+
+    static size_t countKeys(const CoordinateView &view, size_t first, size_t end) noexcept
+    {
+        size_t n{0};
+        for (size_t i = first; i < end; i++)
+            n += !view.name(i).empty() + !view.code(i).empty();
+        return n;
+    }
+
+    // FNV-1a:
+    static uint32_t hash(std::string_view key) noexcept
+    {
+        uint32_t h{2166136261u};
+        for (const auto c : key)
+            h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+        return h;
+    }
+
+    // Ziffernfolge als ID, InvalidId wenn keine Zahl bzw. außerhalb:
+    uint32_t toId(std::string_view digits) const noexcept
+    {
+        uint32_t value;
+        const auto res{std::from_chars(digits.data(), digits.data() + digits.size(), value)};
+        return ((res.ec == std::errc{}) && (res.ptr == digits.data() + digits.size()) && (value < size())) ? value : InvalidId;
+    }
+
+    static uint32_t id(const Slot &slot) noexcept
+    {
+        return (slot.ref - 1) >> 1;
+    }
+
+    static bool isCode(const Slot &slot) noexcept
+    {
+        return (slot.ref - 1) & 1;
+    }
+
+    std::string_view text(const Slot &slot) const noexcept
+    {
+        return isCode(slot) ? coords.code(id(slot)) : coords.name(id(slot));
+    }
+
+    void insert(std::string_view key, uint32_t i, bool code) noexcept
+    {
+        if (key.empty())
+            return;
+
+        place(Slot{hash(key), ((i << 1) | (code ? 1u : 0u)) + 1});
+    }
+
+    void place(const Slot &slot) noexcept
+    {
+        auto pos{slot.hash & mask};
+        while (slots[pos].ref != 0)
+            pos = (pos + 1) & mask;
+        slots[pos] = slot;
+    }
+
+    // Entfernt den Schlüssel von i und rückt nachfolgende Einträge der Sondierungskette auf (keine Grabsteine):
+    void erase(std::string_view key, uint32_t i, bool code) noexcept
+    {
+        if (key.empty())
+            return;
+
+        const auto ref{((i << 1) | (code ? 1u : 0u)) + 1};
+        auto pos{hash(key) & mask};
+        while ((slots[pos].ref != 0) && (slots[pos].ref != ref))
+            pos = (pos + 1) & mask;
+        if (slots[pos].ref == 0)
+            return;
+
+        for (auto next = (pos + 1) & mask; slots[next].ref != 0; next = (next + 1) & mask)
+        {
+            const auto home{slots[next].hash & mask};
+            if (((next - home) & mask) >= ((next - pos) & mask)) // Heimatplatz liegt nicht zwischen pos und next
+            {
+                slots[pos] = slots[next];
+                pos = next;
+            }
+        }
+        slots[pos] = Slot{};
+    }
+};
@@ -0,0 +1,161 @@
+// Verdichtung einer Orthodrome: viele gleichmäßig verteilte Wegpunkte in einem Durchgang
+//
+// Die Geometrie der Strecke (Einheitsvektor a von A, Tangente t in A Richtung B, Zentriwinkel) wird einmal
+// berechnet. Der Wegpunkt im Winkelabstand s ist p(s) = a cos(s) + t sin(s); cos/sin der Schritte werden
+// blockweise per Drehung (komplexe Multiplikation) fortgeschrieben, am Blockanfang exakt neu gesetzt.
+// Je Wegpunkt fallen damit nur atan2 für Breite und Länge an. Meridianflüge und der Übergang über +-180 Grad
+// brauchen keine Sonderfälle: die Länge kommt aus atan2 und liegt immer in [-pi; pi].
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm> // std::min
+#include <cmath>     // std::atan2, std::sqrt, std::cos, std::sin
+#include <cstddef>   // size_t
+#include <stdexcept> // std::overflow_error, std::invalid_argument
+
+/// Eigene Header
+#include "sphere.hpp" // PreparedCoordinate, r_E
+
+// Verdichtung: feste Anzahl Wegpunkte oder fester Abstand (step > 0 hat Vorrang):
+struct RouteSpec
+{
+    size_t count{100};
+    double step{0}; // km
+};
+
+class GreatCircleLeg
+{
+public:
+    static constexpr size_t Block{256}; // Wegpunkte je Block (Puffergröße der Callbacks)
+
+    // Wirft bei gleichen oder gegenüberliegenden Punkten (Großkreis nicht eindeutig):
+    GreatCircleLeg(const PreparedCoordinate &A, const PreparedCoordinate &B)
+    {
+        const double a[3]{double{A.cosPhi} * A.cosLambda, double{A.cosPhi} * A.sinLambda, double{A.sinPhi}};
+        const double b[3]{double{B.cosPhi} * B.cosLambda, double{B.cosPhi} * B.sinLambda, double{B.sinPhi}};
+
+        const auto dot{a[0] * b[0] + a[1] * b[1] + a[2] * b[2]};
+        double t[3]{b[0] - dot * a[0], b[1] - dot * a[1], b[2] - dot * a[2]}; // Anteil von b senkrecht zu a
+        const auto norm{std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2])};
+
+        if (norm < 1e-9)
+            throw std::overflow_error("Großkreis durch A und B ist nicht eindeutig!");
+
+        for (int k = 0; k < 3; k++)
+        {
+            origin[k] = a[k];
+            tangent[k] = t[k] / norm;
+        }
+        zeta = std::atan2(norm, dot); // gut konditioniert auch für kleine und große Winkel
+    }
+
+    // Zentriwinkel in rad bzw. Länge in km:
+    double angle(void) const noexcept
+    {
+        return zeta;
+    }
+
+    double km(void) const noexcept
+    {
+        return zeta * r_E;
+    }
+
+    // Einzelner Wegpunkt im Abstand distance (km) von A:
+    Point at(double distance) const noexcept
+    {
+        const auto s{distance / r_E};
+        return toPoint(std::cos(s), std::sin(s));
+    }
+
+    // count >= 2 gleichmäßig verteilte Wegpunkte inkl. A und B. Ruft
+    // onBlock(const float *phi, const float *lambda, const float *km, size_t n, size_t first) blockweise auf.
+    template <class F>
+    void densify(size_t count, F &&onBlock) const
+    {
+        if (count < 2)
+            throw std::invalid_argument("Mindestens zwei Wegpunkte erforderlich!");
+
+        emit(count, zeta / static_cast<double>(count - 1), onBlock);
+    }
+
+    // Wegpunkte alle step km ab A, B wird als letzter Punkt immer ausgegeben:
+    template <class F>
+    void densifyEvery(double step, F &&onBlock) const
+    {
+        if (!(step > 0.0))
+            throw std::invalid_argument("Abstand muss größer 0 sein!");
+
+        const auto delta{step / r_E};
+        const auto inner{static_cast<size_t>(std::ceil(zeta / delta))}; // Punkte vor B
+        emit(inner + 1, delta, onBlock);
+    }
+
+    template <class F>
+    void densify(const RouteSpec &spec, F &&onBlock) const
+    {
+        if (spec.step > 0.0)
+            densifyEvery(spec.step, onBlock);
+        else
+            densify(spec.count, onBlock);
+    }
+
+private:
+    double origin[3];  // Einheitsvektor A
+    double tangent[3]; // Einheitstangente in A Richtung B
+    double zeta;       // Zentriwinkel A-B
+
+    Point toPoint(double c, double s) const noexcept
+    {
+        const auto x{origin[0] * c + tangent[0] * s};
+        const auto y{origin[1] * c + tangent[1] * s};
+        const auto z{origin[2] * c + tangent[2] * s};
+        return Point{static_cast<float>(std::atan2(z, std::sqrt(x * x + y * y))), static_cast<float>(std::atan2(y, x))};
+    }
+
+    // count Wegpunkte im Winkelabstand delta, der letzte liegt immer exakt auf B:
+    template <class F>
+    void emit(size_t count, double delta, F &onBlock) const
+    {
+        const auto cd{std::cos(delta)}, sd{std::sin(delta)};
+
+        float phi[Block], lambda[Block], km[Block];
+        double x[Block], y[Block], z[Block];
+
+        for (size_t first = 0; first < count; first += Block)
+        {
+            const auto n{std::min(Block, count - first)};
+
+            // Drehung fortschreiben (Start exakt, damit sich Rundungsfehler nicht über Blöcke aufsummieren):
+            auto c{std::cos(first * delta)}, s{std::sin(first * delta)};
+            for (size_t i = 0; i < n; i++)
+            {
+                x[i] = origin[0] * c + tangent[0] * s;
+                y[i] = origin[1] * c + tangent[1] * s;
+                z[i] = origin[2] * c + tangent[2] * s;
+                km[i] = static_cast<float>((first + i) * delta * r_E);
+
+                const auto cn{c * cd - s * sd};
+                s = s * cd + c * sd;
+                c = cn;
+            }
+
+            if (first + n == count) // letzter Punkt exakt auf B (bei festem Abstand ist der letzte Schritt kürzer)
+            {
+                const auto cz{std::cos(zeta)}, sz{std::sin(zeta)};
+                x[n - 1] = origin[0] * cz + tangent[0] * sz;
+                y[n - 1] = origin[1] * cz + tangent[1] * sz;
+                z[n - 1] = origin[2] * cz + tangent[2] * sz;
+                km[n - 1] = static_cast<float>(zeta * r_E);
+            }
+
+            // Umrechnung in Breite/Länge:
+            for (size_t i = 0; i < n; i++)
+            {
+                phi[i] = static_cast<float>(std::atan2(z[i], std::sqrt(x[i] * x[i] + y[i] * y[i])));
+                lambda[i] = static_cast<float>(std::atan2(y[i], x[i]));
+            }
+
+            onBlock(static_cast<const float *>(phi), static_cast<const float *>(lambda), static_cast<const float *>(km), n, first);
+        }
+    }
+};
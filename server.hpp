@@ -0,0 +1,580 @@
+// Lokaler Abfrageserver (--serve): Koordinaten werden einmal geladen, Anfragen kommen über einen Unix-Socket bzw. über
+// TCP auf 127.0.0.1 (Adresse nur aus Ziffern = Port)
+//
+// Ein Ereignisthread (epoll, nicht blockierende Sockets) nimmt Verbindungen an und liest. Eine Verbindung sendet
+// Befehlszeilen wie im Stapelmodus ("4 A B", beliebig viele, ohne auf Antworten zu warten) oder nach den ersten vier
+// Byte "TRGB" Binäranfragen (query::BinaryRequest, 24 Byte, Befehle 1 bis 7 über IDs). Alle Anfragen, die in einer Runde
+// von epoll_wait eingehen, werden über alle Verbindungen hinweg als ein Stapel auf demselben Stand des Katalogs
+// ausgeführt (auf den Thread-Pool verteilt) und danach je Verbindung in Eingangsreihenfolge zurückgeschrieben. Die
+// Zeilennummer eines Ergebnisses ist die laufende Nummer der Anfrage auf ihrer Verbindung.
+//
+// Textantworten stehen im gewählten Format (Text, CSV mit Kopfzeile zu Beginn, JSON-Zeilen) und werden je Zeile mit
+// einer Leerzeile abgeschlossen; Binärverbindungen erhalten zuerst BinaryHeader, dann einen BinaryRecord je Anfrage.
+// "status" liefert eine Zeile mit Warteschlangentiefe und Latenzen, "0" schließt die Verbindung. Solange mehr als
+// OutputLimit Byte auf eine Verbindung warten, wird von ihr nicht gelesen (Gegendruck statt unbegrenzter Puffer).
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>     // std::min
+#include <cerrno>        // errno
+#include <chrono>        // std::chrono::steady_clock
+#include <csignal>       // SIGINT, SIGTERM
+#include <cstdint>       // int-Typen
+#include <cstdio>        // std::snprintf
+#include <cstring>       // std::memcpy, std::strerror
+#include <iomanip>       // std::setprecision
+#include <ostream>       // std::ostream
+#include <stdexcept>     // std::runtime_error
+#include <string>        // std::string
+#include <string_view>   // std::string_view
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+#include <arpa/inet.h>    // htonl, htons, ntohs
+#include <fcntl.h>        // O_NONBLOCK, O_CLOEXEC
+#include <netinet/in.h>   // sockaddr_in
+#include <netinet/tcp.h>  // TCP_NODELAY
+#include <pthread.h>      // pthread_sigmask
+#include <sys/epoll.h>    // epoll_create1, epoll_ctl, epoll_wait
+#include <sys/signalfd.h> // signalfd
+#include <sys/socket.h>   // socket, bind, listen, accept4, send, recv
+#include <sys/stat.h>     // stat
+#include <sys/un.h>       // sockaddr_un
+#include <unistd.h>       // close, pipe, read, write, unlink
+
+/// Eigene Header
+#include "catalog.hpp"  // Catalog, CatalogSnapshot
+#include "executor.hpp" // ThreadPool
+#include "output.hpp"   // OutputBuffer, OutputFormat
+#include "query.hpp"    // query::Executor, query::BinaryRequest
+#include "stats.hpp"    // stats::Histogram
+
+class QueryServer
+{
+public:
+    static constexpr size_t MaxLine{1 << 16};      // längste Befehlszeile, sonst wird die Verbindung geschlossen
+    static constexpr size_t ReadLimit{1 << 18};    // je Verbindung und Runde (andere Verbindungen kommen auch dran)
+    static constexpr size_t OutputLimit{1 << 20};  // wartende Antworten, ab denen nicht mehr gelesen wird
+    static constexpr size_t TaskRequests{128};     // Anfragen je Aufgabe im Thread-Pool
+
+    struct Options
+    {
+        OutputFormat format{OutputFormat::Text}; // für Textverbindungen (Binary: Text)
+        Backend backend{Backend::Trig};
+        Earth earth{Earth::Sphere};
+        bool cache{true}; // Ergebnis-Cache des Stands verwenden
+    };
+
+    // Öffnet den Socket und blockiert SIGINT/SIGTERM im aufrufenden Thread; vor dem Start weiterer Threads (Thread-Pool,
+    // Überwachung) anlegen, damit diese die Maske erben und nur run() die Signale über signalfd erhält.
+    explicit QueryServer(const std::string &_address) : address(_address)
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, &previousMask);
+
+        const auto tcp{!address.empty() && (address.find_first_not_of("0123456789") == std::string::npos)};
+        try
+        {
+            listener = tcp ? listenTcp() : listenUnix();
+            epoll = epoll_create1(EPOLL_CLOEXEC);
+            signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+            if ((epoll < 0) || (signalFd < 0) || (::pipe2(wake, O_NONBLOCK | O_CLOEXEC) != 0))
+                fail("Ereignisschleife kann nicht angelegt werden");
+            watch(listener, ListenerId, EPOLLIN);
+            watch(signalFd, SignalId, EPOLLIN);
+            watch(wake[0], WakeId, EPOLLIN);
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    ~QueryServer()
+    {
+        for (const auto &c : connections)
+            ::close(c.second.fd);
+        release();
+    }
+
+    QueryServer(const QueryServer &) = delete;
+    QueryServer &operator=(const QueryServer &) = delete;
+
+    // Adresse wie angegeben (bei Port 0 der vom System gewählte Port):
+    const std::string &name(void) const noexcept
+    {
+        return address;
+    }
+
+    // Bedient Anfragen bis SIGINT/SIGTERM bzw. stop(). Jeder Stapel arbeitet auf dem dann aktuellen Stand des Katalogs.
+    void run(const Catalog &catalog, ThreadPool &pool, const Options &options)
+    {
+        epoll_event events[64];
+        bool running{true};
+        textFormat = (options.format == OutputFormat::Binary) ? OutputFormat::Text : options.format;
+
+        while (running)
+        {
+            const auto n{epoll_wait(epoll, events, 64, -1)};
+            if ((n < 0) && (errno != EINTR))
+                fail("Fehler in der Ereignisschleife");
+
+            round++;
+            for (int e = 0; e < n; e++)
+            {
+                const auto id{events[e].data.u64};
+                if (id == ListenerId)
+                    accept();
+                else if ((id == SignalId) || (id == WakeId))
+                    running = false;
+                else
+                {
+                    const auto it{connections.find(id)};
+                    if (it == connections.end())
+                        continue;
+                    auto &c{it->second};
+                    if ((events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && (c.events & EPOLLIN))
+                        receive(id, c);
+                    touch(id, c);
+                }
+            }
+
+            if (!queue.empty())
+                execute(catalog, pool, options);
+
+            for (const auto id : touched)
+                update(id);
+            touched.clear();
+        }
+    }
+
+    // Beendet run() aus einem anderen Thread:
+    void stop(void) noexcept
+    {
+        const char c{0};
+        (void)!::write(wake[1], &c, 1);
+    }
+
+    // Abschlussbericht (Anfragen, Stapel, Warteschlangentiefe, Latenz vom Eingang bis zur fertigen Antwort):
+    void report(std::ostream &out) const
+    {
+        const auto flags{out.flags()};
+        const auto precision{out.precision()};
+        out << "Server: " << requests << " Anfragen in " << batches << " Stapeln, Warteschlange mittel " << std::fixed << std::setprecision(1)
+            << meanDepth() << " / max " << maxDepth << ", Latenz p50 " << us(latency.percentile(0.50)) << " µs, p95 "
+            << us(latency.percentile(0.95)) << " µs, p99 " << us(latency.percentile(0.99)) << " µs, max " << us(latency.max) << " µs" << std::endl;
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+private:
+    enum : uint64_t
+    {
+        ListenerId,
+        SignalId,
+        WakeId,
+        FirstConnection
+    };
+
+    enum class Mode : uint8_t
+    {
+        Unknown, // noch keine vier Byte empfangen
+        Text,
+        Binary
+    };
+
+    struct Connection
+    {
+        int fd;
+        Mode mode{Mode::Unknown};
+        uint32_t events{0};   // angemeldete epoll-Ereignisse
+        uint32_t requests{0}; // laufende Nummer der Anfrage
+        uint64_t round{0};    // letzte Runde in touched
+        bool closing{false};  // "0" erhalten: nichts mehr lesen, nach dem Senden schließen
+        bool eof{false};      // Gegenseite sendet nichts mehr
+        bool broken{false};   // Fehler, sofort schließen
+        std::string input{};  // unvollständige Anfragen
+        std::string output{}; // noch nicht gesendete Antworten
+    };
+
+    enum class Kind : uint8_t
+    {
+        Text,
+        Binary,
+        Status,
+        Close
+    };
+
+    struct Request
+    {
+        uint64_t connection;
+        Kind kind;
+        uint32_t line;
+        size_t offset, length; // Text: Bereich in text
+        query::BinaryRequest binary;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    std::string address;
+    int listener{-1}, epoll{-1}, signalFd{-1}, wake[2]{-1, -1};
+    bool unixSocket{false};
+    sigset_t previousMask;
+    OutputFormat textFormat{OutputFormat::Text};
+
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t nextId{FirstConnection}, round{0};
+    std::vector<uint64_t> touched; // Verbindungen mit Ereignissen bzw. Antworten in dieser Runde
+
+    // Stapel der laufenden Runde:
+    std::vector<Request> queue;
+    std::string text;
+    std::vector<size_t> ends;          // Ende der Antwort je Anfrage in results
+    std::vector<std::string> results;  // Antworten je Aufgabe
+
+    // Statistik:
+    uint64_t requests{0}, batches{0}, depthTotal{0}, maxDepth{0};
+    stats::Histogram latency;
+
+    [[noreturn]] void fail(const std::string &what) const
+    {
+        throw std::runtime_error(what + " (" + address + "): " + std::strerror(errno));
+    }
+
+    static double us(uint64_t ns) noexcept
+    {
+        return static_cast<double>(ns) / 1e3;
+    }
+
+    double meanDepth(void) const noexcept
+    {
+        return batches ? static_cast<double>(depthTotal) / static_cast<double>(batches) : 0.0;
+    }
+
+    void release(void) noexcept
+    {
+        for (const auto fd : {listener, epoll, signalFd, wake[0], wake[1]})
+            if (fd >= 0)
+                ::close(fd);
+        if (unixSocket)
+            ::unlink(address.c_str());
+        pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+    }
+
+    int listenUnix(void)
+    {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (address.empty() || (address.size() >= sizeof(addr.sun_path)))
+            throw std::runtime_error("Ungültiger Socket-Pfad: " + address);
+        std::memcpy(addr.sun_path, address.c_str(), address.size() + 1);
+
+        // Verwaisten Socket eines früheren Laufs entfernen (andere Dateien bleiben unangetastet):
+        struct stat st;
+        if ((::stat(address.c_str(), &st) == 0) && S_ISSOCK(st.st_mode))
+            ::unlink(address.c_str());
+
+        const auto fd{::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)};
+        if (fd < 0)
+            fail("Server-Socket kann nicht geöffnet werden");
+        if ((::bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) || (::listen(fd, SOMAXCONN) != 0))
+        {
+            ::close(fd);
+            fail("Server-Socket kann nicht geöffnet werden");
+        }
+        unixSocket = true;
+        return fd;
+    }
+
+    int listenTcp(void)
+    {
+        const auto port{std::stoul(address)};
+        if (port > UINT16_MAX)
+            throw std::runtime_error("Ungültiger Port: " + address);
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // nur lokal erreichbar
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+
+        const auto fd{::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)};
+        if (fd < 0)
+            fail("Server-Socket kann nicht geöffnet werden");
+        const int on{1};
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        socklen_t length{sizeof(addr)};
+        if ((::bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) || (::listen(fd, SOMAXCONN) != 0) ||
+            (::getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &length) != 0))
+        {
+            ::close(fd);
+            fail("Server-Socket kann nicht geöffnet werden");
+        }
+        address = std::to_string(ntohs(addr.sin_port));
+        return fd;
+    }
+
+    void watch(int fd, uint64_t id, uint32_t events)
+    {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = id;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev) != 0)
+            fail("Ereignisschleife kann nicht angelegt werden");
+    }
+
+    void accept(void)
+    {
+        int fd;
+        while ((fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+        {
+            if (!unixSocket)
+            {
+                const int on{1}; // kurze Antworten nicht zurückhalten
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            }
+
+            const auto id{nextId++};
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = id;
+            if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev) != 0)
+            {
+                ::close(fd);
+                continue;
+            }
+            auto &c{connections.emplace(id, Connection{fd}).first->second};
+            c.events = EPOLLIN;
+        }
+    }
+
+    void touch(uint64_t id, Connection &c)
+    {
+        if (c.round != round)
+        {
+            c.round = round;
+            touched.push_back(id);
+        }
+    }
+
+    // Liest bis EAGAIN bzw. ReadLimit und reiht alle vollständigen Anfragen ein:
+    void receive(uint64_t id, Connection &c)
+    {
+        char chunk[1 << 16];
+        size_t total{0};
+        while (total < ReadLimit)
+        {
+            const auto n{::recv(c.fd, chunk, sizeof(chunk), 0)};
+            if (n > 0)
+            {
+                c.input.append(chunk, static_cast<size_t>(n));
+                total += static_cast<size_t>(n);
+            }
+            else if (n == 0)
+            {
+                c.eof = true;
+                break;
+            }
+            else
+            {
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+                    c.broken = true;
+                if (errno != EINTR)
+                    break;
+            }
+        }
+
+        const auto now{std::chrono::steady_clock::now()};
+        if (c.mode == Mode::Unknown)
+        {
+            const auto n{std::min<size_t>(c.input.size(), 4)};
+            if (c.input.compare(0, n, "TRGB", n) != 0)
+                c.mode = Mode::Text;
+            else if (n == 4)
+            {
+                c.mode = Mode::Binary;
+                c.input.erase(0, 4);
+            }
+            else if (!c.eof)
+                return;
+            else
+                c.mode = Mode::Text;
+
+            // Kopf vor allen Antworten der Verbindung:
+            OutputBuffer header(nullptr, 0);
+            query::Executor::header(header, (c.mode == Mode::Binary) ? OutputFormat::Binary : textFormat);
+            c.output += header.take();
+        }
+
+        if (c.mode == Mode::Binary)
+            parseBinary(id, c, now);
+        else
+            parseText(id, c, now);
+    }
+
+    void parseText(uint64_t id, Connection &c, std::chrono::steady_clock::time_point now)
+    {
+        if (c.eof && !c.input.empty() && (c.input.back() != '\n')) // letzte Zeile ohne Zeilenumbruch
+            c.input.push_back('\n');
+
+        size_t pos{0}, end;
+        while (!c.closing && ((end = c.input.find('\n', pos)) != std::string::npos))
+        {
+            auto length{end - pos};
+            if (length && (c.input[end - 1] == '\r'))
+                length--;
+            const char *line{c.input.data() + pos};
+            pos = end + 1;
+
+            Request r{id, Kind::Text, ++c.requests, text.size(), length, {}, now};
+            std::string_view tok[2];
+            const auto n{query::tokenize(line, line + length, tok, 2)};
+            if ((n == 1) && (tok[0] == "status"))
+                r.kind = Kind::Status;
+            else if (query::Executor::isExit(line, line + length))
+            {
+                r.kind = Kind::Close;
+                c.closing = true;
+            }
+            else
+                text.append(line, length);
+            queue.push_back(r);
+        }
+        c.input.erase(0, c.closing ? c.input.size() : pos);
+
+        if (c.input.size() > MaxLine)
+            c.broken = true;
+    }
+
+    void parseBinary(uint64_t id, Connection &c, std::chrono::steady_clock::time_point now)
+    {
+        constexpr auto Size{sizeof(query::BinaryRequest)};
+        size_t pos{0};
+        for (; pos + Size <= c.input.size(); pos += Size)
+        {
+            Request r{id, Kind::Binary, ++c.requests, 0, 0, {}, now};
+            std::memcpy(&r.binary, c.input.data() + pos, Size);
+            queue.push_back(r);
+        }
+        c.input.erase(0, pos);
+    }
+
+    // Führt den Stapel auf dem aktuellen Stand aus und hängt die Antworten an die Verbindungen:
+    void execute(const Catalog &catalog, ThreadPool &pool, const Options &options)
+    {
+        const auto snapshot{catalog.current()};
+        auto *const cache{options.cache ? &snapshot->cache : nullptr};
+        const auto index = [&snapshot]() -> const SpatialIndex & { return snapshot->index(); };
+        query::Executor textExecutor(snapshot->registry, textFormat, &pool, options.backend, cache, options.earth, index);
+        query::Executor binaryExecutor(snapshot->registry, OutputFormat::Binary, &pool, options.backend, cache, options.earth, index);
+
+        const auto count{queue.size()};
+        const auto tasks{(count + TaskRequests - 1) / TaskRequests};
+        ends.resize(count);
+        results.resize(tasks);
+        pool.run(tasks, [&](size_t t) {
+            OutputBuffer local(nullptr, 0);
+            for (size_t i = t * TaskRequests; i < std::min(count, (t + 1) * TaskRequests); i++)
+            {
+                const auto &r{queue[i]};
+                if (r.kind == Kind::Text)
+                {
+                    textExecutor.execute(local, text.data() + r.offset, text.data() + r.offset + r.length, r.line);
+                    local << '\n';
+                }
+                else if (r.kind == Kind::Binary)
+                    binaryExecutor.execute(local, r.binary, r.line);
+                ends[i] = local.size();
+            }
+            results[t] = local.take();
+        });
+
+        requests += count;
+        batches++;
+        depthTotal += count;
+        maxDepth = std::max<uint64_t>(maxDepth, count);
+
+        // In Eingangsreihenfolge verteilen:
+        const auto now{std::chrono::steady_clock::now()};
+        for (size_t t = 0; t < tasks; t++)
+        {
+            size_t pos{0};
+            for (size_t i = t * TaskRequests; i < std::min(count, (t + 1) * TaskRequests); pos = ends[i], i++)
+            {
+                const auto &r{queue[i]};
+                const auto it{connections.find(r.connection)};
+                if (it == connections.end())
+                    continue;
+                auto &c{it->second};
+                touch(r.connection, c);
+
+                if (r.kind == Kind::Status)
+                    c.output += status(count) + "\n\n";
+                else if (r.kind == Kind::Close)
+                    c.closing = true;
+                else
+                    c.output.append(results[t], pos, ends[i] - pos);
+                latency.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - r.arrival).count()));
+            }
+        }
+
+        queue.clear();
+        text.clear();
+    }
+
+    // Eine Zeile für "status" (depth: Anfragen im laufenden Stapel):
+    std::string status(size_t depth) const
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "Status: %zu Verbindungen, %llu Anfragen in %llu Stapeln, Warteschlange aktuell %zu, mittel %.1f, max %llu, "
+                      "Latenz p50 %.1f µs, p95 %.1f µs, p99 %.1f µs, max %.1f µs",
+                      connections.size(), static_cast<unsigned long long>(requests), static_cast<unsigned long long>(batches), depth,
+                      meanDepth(), static_cast<unsigned long long>(maxDepth), us(latency.percentile(0.50)), us(latency.percentile(0.95)),
+                      us(latency.percentile(0.99)), us(latency.max));
+        return line;
+    }
+
+    // Sendet wartende Antworten, passt die angemeldeten Ereignisse an bzw. schließt die Verbindung:
+    void update(uint64_t id)
+    {
+        const auto it{connections.find(id)};
+        if (it == connections.end())
+            return;
+        auto &c{it->second};
+
+        size_t sent{0};
+        while (!c.broken && (sent < c.output.size()))
+        {
+            const auto n{::send(c.fd, c.output.data() + sent, c.output.size() - sent, MSG_NOSIGNAL)};
+            if (n > 0)
+                sent += static_cast<size_t>(n);
+            else if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+                c.broken = true;
+            else if (errno != EINTR)
+                break;
+        }
+        c.output.erase(0, sent);
+
+        if (c.broken || ((c.closing || c.eof) && c.output.empty()))
+        {
+            epoll_ctl(epoll, EPOLL_CTL_DEL, c.fd, nullptr);
+            ::close(c.fd);
+            connections.erase(it);
+            return;
+        }
+
+        const uint32_t events{((!c.closing && !c.eof && (c.output.size() < OutputLimit)) ? uint32_t{EPOLLIN} : 0u) |
+                              (c.output.empty() ? 0u : uint32_t{EPOLLOUT})};
+        if (events != c.events)
+        {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.u64 = id;
+            epoll_ctl(epoll, EPOLL_CTL_MOD, c.fd, &ev);
+            c.events = events;
+        }
+    }
+};
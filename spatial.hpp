@@ -0,0 +1,251 @@
+// Räumlicher Index für Nächste-Nachbarn- und Umkreissuche auf der Kugel
+//
+// k-d-Baum über den Einheitsvektoren (x, y, z) der Koordinaten. Die Sehnenlänge zwischen zwei Einheitsvektoren
+// wächst monoton mit dem Zentriwinkel, der kleinste Abstand des Suchvektors zur Hüllbox eines Knotens liefert
+// daher eine untere Schranke für die Großkreisdistanz aller Punkte darin. Knoten werden nur mit dieser Schranke
+// (plus Sicherheitsabstand für float-Rundung) verworfen; die Distanz jedes Kandidaten wird mit calcGCDkm
+// berechnet. Ergebnisse stimmen damit exakt mit einem Vergleich gegen alle Koordinaten überein.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>   // std::nth_element, std::sort, std::push_heap
+#include <cmath>       // std::acos, std::sqrt
+#include <cstddef>     // size_t
+#include <cstdint>     // int-Typen
+#include <vector>      // std::vector
+
+/// Eigene Header
+#include "sphere.hpp" // PreparedCoordinate, calcGCDkm, r_E
+#include "store.hpp"  // CoordinateView, withTrig
+
+// Treffer einer Suche, aufsteigend nach Distanz (bei Gleichstand nach ID) sortiert:
+struct Neighbour
+{
+    uint32_t id;
+    float km; // calcGCDkm(Suchpunkt, Koordinate id)
+
+    bool operator<(const Neighbour &other) const noexcept
+    {
+        return (km < other.km) || ((km == other.km) && (id < other.id));
+    }
+};
+
+class SpatialIndex
+{
+public:
+    static constexpr uint32_t LeafSize{16}; // Punkte je Blatt
+
+    explicit SpatialIndex(const CoordinateView &source)
+    {
+        TrigColumns derived;
+        const auto coords{withTrig(source, derived)};
+        const auto n{coords.size()};
+        ids.resize(n);
+        std::vector<float> xyz(3 * n);
+        for (size_t i = 0; i < n; i++)
+        {
+            ids[i] = static_cast<uint32_t>(i);
+            xyz[3 * i + 0] = coords.cosPhi[i] * coords.cosLambda[i];
+            xyz[3 * i + 1] = coords.cosPhi[i] * coords.sinLambda[i];
+            xyz[3 * i + 2] = coords.sinPhi[i];
+        }
+
+        if (n)
+        {
+            nodes.reserve(2 * (n / LeafSize + 1));
+            build(xyz, 0, static_cast<uint32_t>(n));
+        }
+
+        // Punkte in Baumreihenfolge ablegen, damit ein Blatt zusammenhängend im Speicher liegt:
+        points.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const auto id{ids[i]};
+            points[i] = TreePoint{xyz[3 * id], xyz[3 * id + 1], xyz[3 * id + 2],
+                                  coords.sinPhi[id], coords.cosPhi[id], coords.sinLambda[id], coords.cosLambda[id]};
+        }
+    }
+
+    size_t size(void) const noexcept
+    {
+        return ids.size();
+    }
+
+    // Die k nächsten Koordinaten zu q. exclude (z.B. die ID von q selbst) wird übersprungen.
+    std::vector<Neighbour> nearest(const PreparedCoordinate &q, size_t k, uint32_t exclude = UINT32_MAX) const
+    {
+        std::vector<Neighbour> heap; // Max-Heap der bisher besten k
+        if ((k == 0) || nodes.empty())
+            return heap;
+        k = std::min(k, ids.size()); // mehr Treffer als Koordinaten gibt es nicht
+        heap.reserve(k + 1);
+
+        const auto qv{unit(q)};
+        searchNearest(0, q, qv, k, exclude, heap);
+
+        std::sort_heap(heap.begin(), heap.end());
+        return heap;
+    }
+
+    // Alle Koordinaten mit calcGCDkm(q, p) <= km, sortiert:
+    std::vector<Neighbour> within(const PreparedCoordinate &q, float km, uint32_t exclude = UINT32_MAX) const
+    {
+        std::vector<Neighbour> hits;
+        if (nodes.empty() || !(km >= 0.0f))
+            return hits;
+
+        const auto qv{unit(q)};
+        searchWithin(0, q, qv, km, exclude, hits);
+
+        std::sort(hits.begin(), hits.end());
+        return hits;
+    }
+
+private:
+    struct Node
+    {
+        float lo[3], hi[3];   // Hüllbox der Einheitsvektoren
+        uint32_t begin, end;  // Bereich in points/ids
+        uint32_t left, right; // Kindknoten, 0 bei Blättern (Knoten 0 ist immer die Wurzel)
+    };
+
+    struct TreePoint
+    {
+        float x, y, z;
+        float sinPhi, cosPhi, sinLambda, cosLambda;
+    };
+
+    struct Vec3
+    {
+        float x, y, z;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<TreePoint> points;
+    std::vector<uint32_t> ids;
+
+    static Vec3 unit(const PreparedCoordinate &q) noexcept
+    {
+        return Vec3{q.cosPhi * q.cosLambda, q.cosPhi * q.sinLambda, q.sinPhi};
+    }
+
+    uint32_t build(const std::vector<float> &xyz, uint32_t begin, uint32_t end)
+    {
+        const auto index{static_cast<uint32_t>(nodes.size())};
+        nodes.push_back(Node{{1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}, begin, end, 0, 0});
+
+        float lo[3]{1.0f, 1.0f, 1.0f}, hi[3]{-1.0f, -1.0f, -1.0f};
+        for (auto i = begin; i < end; i++)
+            for (int a = 0; a < 3; a++)
+            {
+                lo[a] = std::min(lo[a], xyz[3 * ids[i] + a]);
+                hi[a] = std::max(hi[a], xyz[3 * ids[i] + a]);
+            }
+        std::copy(lo, lo + 3, nodes[index].lo);
+        std::copy(hi, hi + 3, nodes[index].hi);
+
+        if (end - begin <= LeafSize)
+            return index;
+
+        // An der längsten Achse im Median teilen:
+        int axis{0};
+        for (int a = 1; a < 3; a++)
+            if (hi[a] - lo[a] > hi[axis] - lo[axis])
+                axis = a;
+
+        const auto mid{begin + (end - begin) / 2};
+        std::nth_element(ids.begin() + begin, ids.begin() + mid, ids.begin() + end,
+                         [&xyz, axis](uint32_t a, uint32_t b) { return xyz[3 * a + axis] < xyz[3 * b + axis]; });
+
+        const auto left{build(xyz, begin, mid)};
+        const auto right{build(xyz, mid, end)};
+        nodes[index].left = left;
+        nodes[index].right = right;
+        return index;
+    }
+
+    // Untere Schranke der Großkreisdistanz in km vom Suchvektor zu allen Punkten der Hüllbox:
+    static float lowerBoundKm(const Node &node, const Vec3 &q) noexcept
+    {
+        const float c[3]{q.x, q.y, q.z};
+        double d2{0};
+        for (int a = 0; a < 3; a++)
+        {
+            const double d{(c[a] < node.lo[a]) ? node.lo[a] - c[a] : ((c[a] > node.hi[a]) ? c[a] - node.hi[a] : 0.0)};
+            d2 += d * d;
+        }
+
+        // Sehne s -> cos(zeta) = 1 - s^2 / 2; Zuschlag für die float-Rundung in calcCosGCD bzw. den Einheitsvektoren
+        const auto cosZeta{std::min(1.0, 1.0 - d2 / 2.0 + 1e-5)};
+        return static_cast<float>(std::acos(cosZeta) * r_E * (1.0 - 1e-5));
+    }
+
+    float distance(const PreparedCoordinate &q, uint32_t i) const noexcept
+    {
+        const auto &p{points[i]};
+        return calcGCDkm(q, PreparedCoordinate{0.0f, 0.0f, p.sinPhi, p.cosPhi, p.sinLambda, p.cosLambda, 0.0f, {}, ids[i]});
+    }
+
+    void searchNearest(uint32_t index, const PreparedCoordinate &q, const Vec3 &qv, size_t k, uint32_t exclude, std::vector<Neighbour> &heap) const
+    {
+        const auto &node{nodes[index]};
+
+        if (!node.left)
+        {
+            for (auto i = node.begin; i < node.end; i++)
+            {
+                if (ids[i] == exclude)
+                    continue;
+
+                const Neighbour candidate{ids[i], distance(q, i)};
+                if (heap.size() < k)
+                {
+                    heap.push_back(candidate);
+                    std::push_heap(heap.begin(), heap.end());
+                }
+                else if (candidate < heap.front())
+                {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = candidate;
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+            return;
+        }
+
+        // Näheres Kind zuerst, das andere nur, wenn es noch bessere Punkte enthalten kann:
+        const auto dl{lowerBoundKm(nodes[node.left], qv)};
+        const auto dr{lowerBoundKm(nodes[node.right], qv)};
+        const auto first{(dl <= dr) ? node.left : node.right};
+        const auto second{(dl <= dr) ? node.right : node.left};
+        const auto secondBound{std::max(dl, dr)};
+
+        searchNearest(first, q, qv, k, exclude, heap);
+        if ((heap.size() < k) || (secondBound <= heap.front().km))
+            searchNearest(second, q, qv, k, exclude, heap);
+    }
+
+    void searchWithin(uint32_t index, const PreparedCoordinate &q, const Vec3 &qv, float km, uint32_t exclude, std::vector<Neighbour> &hits) const
+    {
+        const auto &node{nodes[index]};
+        if (lowerBoundKm(node, qv) > km)
+            return;
+
+        if (!node.left)
+        {
+            for (auto i = node.begin; i < node.end; i++)
+            {
+                if (ids[i] == exclude)
+                    continue;
+
+                const auto d{distance(q, i)};
+                if (d <= km)
+                    hits.push_back(Neighbour{ids[i], d});
+            }
+            return;
+        }
+
+        searchWithin(node.left, q, qv, km, exclude, hits);
+        searchWithin(node.right, q, qv, km, exclude, hits);
+    }
+};
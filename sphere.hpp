@@ -0,0 +1,444 @@
+// Strukturen im Grad/Minuten/Sekunden-Format (Coordinate), die bisherigen Berechnungen darauf und die Ausgabe auf der
+// Konsole. Der Rechenkern im Bogenmaß (PreparedCoordinate, calc*Rad, ...) liegt ohne Ein-/Ausgabe in geometry.hpp.
+// Winkel werden standardmäßig im Bogenmaß übergeben!
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>   // std::min, std::max
+#include <cmath>       // PI
+#include <cstdint>     // int-Typen
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <tuple>       // std::tuple
+#include <stdexcept>   // Exceptions
+
+/// Eigene Header
+#include "geometry.hpp" // Konstanten, PreparedCoordinate, calc*Rad
+#include "output.hpp"   // OutputBuffer, console(), ansi()
+
+/// Strukturen
+// Richtung Elevation-Winkel (Nord/Süd):
+enum class directionEl // Definition: Nord: 90 Grad bis 0 Grad, Süd: 0 Grad bis -90 Grad
+{
+    N,
+    S
+};
+
+// Richtung Azimut-Winkel (West/Ost):
+enum class directionAz // Definition: West: -180 Grad bis 0 Grad; Ost: 0 Grad bis 180 Grad
+{
+    W,
+    O
+};
+
+// Zerlegt einen Winkel in Grad (Betrag) in Grad, Minuten und auf ganze Sekunden gerundete Sekunden, damit z.B.
+// 38.9999'' wieder als 39'' erscheint. Einzige Umrechnung für alle Ausgaben (Konsole und Stapelmodus):
+template <class T>
+inline std::tuple<uint16_t, uint8_t, uint8_t> splitDMS(T degrees) noexcept
+{
+    const auto sec{static_cast<uint32_t>(std::lround(std::fabs(degrees) * T{3600}))};
+    return std::make_tuple(static_cast<uint16_t>(sec / 3600), static_cast<uint8_t>((sec / 60) % 60), static_cast<uint8_t>(sec % 60));
+}
+
+// Winkel-Basisklasse:
+struct Angle // nicht instanziieren, sondern abgeleitete Klassen AngleEl/AngleAz verwenden!
+{
+    uint16_t angle; // Winkel
+    uint8_t min;    // Winkelminuten
+    uint8_t sec;    // Winkelsekunden
+
+    Angle(uint16_t _angle, uint8_t _min, uint8_t _sec) : angle(_angle), min(_min), sec(_sec) {} // Konstruktor
+    Angle(float _angle) : Angle(std::make_from_tuple<Angle>(splitDMS(_angle))) {} // Konstruktor der Winkel (in Grad!) als Gleitkommazahl übernimmt
+
+    void print(OutputBuffer &out) const
+    {
+        out.padded(uint32_t{angle}, 3) << "° ";
+        out.padded(uint32_t{min}, 2) << "' ";
+        out.padded(uint32_t{sec}, 2) << "'' ";
+    }
+};
+
+// Elevation-Winkel:
+struct AngleEl : Angle
+{
+    directionEl dir;
+
+    AngleEl(uint16_t _angle, uint8_t _min, uint8_t _sec, directionEl _dir) : Angle(_angle, _min, _sec), dir(_dir) {} // Konstruktor für Grad, Min., Sek.-Format
+    AngleEl(float _angle) : dir((_angle < 0) ? (directionEl::S) : (directionEl::N)), Angle(fabsf(_angle)) {}         // Konstruktor für Gleitkommazahl-Format (in Grad!)
+
+    void print(OutputBuffer &out) const
+    {
+        Angle::print(out);
+        out << ((dir == directionEl::N) ? 'N' : 'S');
+    }
+};
+
+// Azimut-Winkel:
+struct AngleAz : Angle
+{
+    directionAz dir;
+
+    AngleAz(uint16_t _angle, uint8_t _min, uint8_t _sec, directionAz _dir) : Angle(_angle, _min, _sec), dir(_dir) {} // Konstruktor für Grad, Min., Sek.-Format
+    AngleAz(float _angle) : dir((_angle < 0) ? (directionAz::W) : (directionAz::O)), Angle(fabsf(_angle)) {}         // Konstruktor für Gleitkommazahl-Format (in Grad!)
+
+    void print(OutputBuffer &out) const
+    {
+        Angle::print(out);
+        out << ((dir == directionAz::W) ? 'W' : 'O');
+    }
+};
+
+// Koordinate im Grad/Minuten/Sekunden-Format für Anzeige und die bisherigen calc*-Funktionen. Gespeichert werden
+// Koordinaten in den Spalten des CoordinateStore (store.hpp).
+struct Coordinate
+{
+    AngleEl phi;      // Breitengrad
+    AngleAz lambda;   // Längengrad
+    int8_t no;        // fortlaufende Nummer/Buchstabe (wird als Referenz für Programmparameter genutzt)
+    std::string name; // Bezeichner aus .txt-Datei
+
+    Coordinate(uint16_t phi_angle, uint8_t phi_min, uint8_t phi_sec, directionEl phi_dir, uint16_t lambda_angle, uint8_t lambda_min, uint8_t lambda_sec, directionAz lambda_dir, const std::string &bez, int8_t _no) : phi(phi_angle, phi_min, phi_sec, phi_dir), lambda(lambda_angle, lambda_min, lambda_sec, lambda_dir), name(bez), no(_no) // Konstruktor
+    {
+    }
+
+    Coordinate(float angle_el, float angle_az, const std::string &bez, int8_t _no) : phi(angle_el), lambda(angle_az), name(bez), no(_no) {}
+
+    void print(OutputBuffer &out) const
+    {
+        out << ansi(BOLD KGRN) << static_cast<char>(no) << ".) " << ansi(RESET BOLD) << name << '\n' << ansi(RESET);
+        out << "\t\u03A6: "; // phi
+        phi.print(out);
+        out << "\t\u03BB: "; // lambda
+        lambda.print(out);
+        out << "\n\n";
+    }
+
+    // Ausgabe auf die Konsole (an stdout weitergegeben, aber nicht geleert):
+    void print(void) const
+    {
+        print(console());
+        console().flush();
+    }
+};
+
+// Liefert Winkel als Dezimalzahl im Bogenmaß
+template <class T = float>
+inline T getAngle(const AngleAz &angle) noexcept
+{
+    const auto calc{deg2rad(angle.angle + (angle.min / T{60}) + (angle.sec / T{3600}))};
+    return (angle.dir == directionAz::W) ? (-1 * calc) : calc;
+}
+
+// Liefert Winkel als Dezimalzahl im Bogenmaß
+template <class T = float>
+inline T getAngle(const AngleEl &angle) noexcept
+{
+    const auto calc{deg2rad(angle.angle + (angle.min / T{60}) + (angle.sec / T{3600}))}; // Winkel in Grad
+    return (angle.dir == directionEl::S) ? (-1 * calc) : calc;
+}
+
+// Berechnet den loxodromischen Kurs von A nach B
+inline float calcLoxodromicCourse(const Coordinate &A, const Coordinate &B)
+{
+    // sigma von phi: [sigma](phi) = [ln(tan(pi/4 + phi/2))] oben: phi, unten: 0 (gilt nur für e = 0 (Kugel!))
+    const auto sigma = [](float phi) {
+        return logf(tanf(M_PI / 4 + phi / 2));
+    };
+
+    return atan2f((getAngle(B.lambda) - getAngle(A.lambda)), (sigma(getAngle(B.phi)) - sigma(getAngle(A.phi))));
+}
+
+// Berechnet loxodromische Länge von A nach B
+inline float calcLoxodromicLength(const Coordinate &A, const Coordinate &B)
+{
+    return r_E * fabsf((getAngle(B.phi) - getAngle(A.phi)) / cosf(calcLoxodromicCourse(A, B)));
+}
+
+// Gibt Winkel zwischen zwei Punkten auf der Kugel zurück (Zentriwinkel)
+inline float calcGCDrad(const Coordinate &A, const Coordinate &B) noexcept
+{
+    const auto phi_a{getAngle(A.phi)};
+    const auto phi_b{getAngle(B.phi)};
+
+    const auto lambda_a{getAngle(A.lambda)};
+    const auto lambda_b{getAngle(B.lambda)};
+
+    // Zentriwinkel:
+    return acosf(sinf(phi_a) * sinf(phi_b) + cosf(phi_a) * cosf(phi_b) * cosf(lambda_b - lambda_a));
+    /* Trigon. Fkt. in C++ verwenden ihren Parameter in Bogenmaß, deshalb hier noch umrechnen (* rad). Für acosf nicht nötig, da Wert bereits im Bogenmaß! */
+}
+
+// Gibt Kurswinkel zurück: Winkel zwischen Nordrichtung und Südrichtung, zeta im Bogenmaß!
+inline float calcAlphaRad(const struct Coordinate &A, const struct Coordinate &B)
+{
+    const auto zeta{calcGCDrad(A, B)}; // Zentriwinkel
+
+    if (zeta == 0)
+        throw std::overflow_error("Division durch Null!"); // Division durch Null abfangen
+
+    const auto phi_a{getAngle(A.phi)};
+    const auto lambda_a{getAngle(A.lambda)};
+
+    const auto phi_b{getAngle(B.phi)};
+    const auto lambda_b{getAngle(B.lambda)};
+
+    const auto c{calcGCDrad(A, B)};
+
+    return acosf((sinf(phi_b) - sinf(phi_a) * cosf(c)) / (cosf(phi_a) * sinf(c)));
+}
+
+// Gibt Strecke des Winkels zurück (Orthodrom!)
+inline float calcBetaRad(const Coordinate &A, const Coordinate &B) noexcept
+{
+    return calcAlphaRad(B, A);
+}
+
+// Gibt Strecke des Winkels zurück (Orthodrom!)
+inline float calcGCDkm(const Coordinate &A, const Coordinate &B) noexcept
+{
+    return (calcGCDrad(A, B) * r_E);
+}
+
+// Gibt den nördlichsten Punkt auf einem Großkreis zurück
+inline Coordinate calcNorthPeakPoint(const Coordinate &A, const Coordinate &B)
+{
+    // Gegeben: A und alpha
+    // A
+    const auto phi_a{getAngle(A.phi)};
+    const auto lambda_a{getAngle(A.lambda)};
+    // B
+    const auto lambda_b{getAngle(B.lambda)};
+
+    // Auf Sonderfall prüfen:
+    {
+        if (lambda_a == getAngle(B.lambda)) // Sonderfall: Orthodrom == Meridian: Alle Punkte auf Großkreis haben gleichen Längengrad & Großkr. geht durch Nordpol, damit ist der nördlichste Scheitelpunkt der Nordpol selbst.
+            return Coordinate{90, 0, 0, directionEl::N, 0, 0, 0, directionAz::O, "Nordpol", 0};
+    }
+
+    const auto alpha{calcAlphaRad(A, B)}; // Innenwinkel sp. Dreieck
+    const auto beta{calcBetaRad(A, B)};   // Innenwinkel sp. Dreieck
+
+    enum Lage
+    {
+        zwischen,
+        vor_A,
+        hinter_B,
+        unbestimmt
+    } lage{Lage::unbestimmt};
+
+    if (((alpha > 0) && (alpha < M_PI / 2)) && ((beta > 0) && (beta < M_PI / 2)))
+        lage = Lage::zwischen; // Zwischen A und B
+    else if (((alpha > M_PI / 2) && (alpha < M_PI)) && ((beta > 0) && (beta < M_PI / 2)))
+        lage = Lage::vor_A; // Vor A
+    else if (((alpha > 0) && (alpha < M_PI / 2)) && ((beta > M_PI / 2) && (beta < M_PI)))
+        lage = Lage::hinter_B; // hinter B
+
+    // Umgeht Singularität von Wechsel -180 - +180 Grad
+    const auto calcDeltaLambda = [lambda_a, lambda_b]() -> float {
+        const auto dL{lambda_a - lambda_b};
+
+        if (dL > M_PI)
+            return dL - 2 * M_PI;
+        else if (dL < -M_PI)
+            return dL + 2 * M_PI;
+        else
+            return dL;
+    };
+    const auto deltaLambda{calcDeltaLambda()};
+
+    // Berechnung Längengrad des Scheitelpunkts abhängig von dessen Lage
+    const auto calcLambda_S = [lage, lambda_a, phi_a, deltaLambda](float phi_s) -> float {
+        if (lage == Lage::zwischen || lage == Lage::hinter_B)
+        {
+            if (deltaLambda < 0)
+                return lambda_a + acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Oste
+            else if (deltaLambda > 0)
+                return lambda_a - acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Westen
+        }
+        else if (lage == Lage::vor_A) // umgedrehte Fälle:
+        {
+            if (deltaLambda < 0)
+                return lambda_a - acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Westen
+            else if (deltaLambda > 0)
+                return lambda_a + acosf(tanf(phi_a) / tanf(phi_s)); // Flugrichtung: Osten
+        }
+        return lambda_a; // Lage unbestimmt bzw. deltaLambda == 0
+    };
+
+    // Scheitelpunkt s
+    const auto phi_s{acosf(sinf(alpha) * cosf(phi_a))};
+    const auto lambda_s{calcLambda_S(phi_s)};
+
+    return Coordinate(rad2deg(phi_s), rad2deg(lambda_s), "Nördlichster Punkt", 0);
+}
+
+// Berechnet Zwischenpunkt auf Großkreis (v == Speed, k == Verbrach)
+inline Coordinate calcCrashPoint(const Coordinate &A, const Coordinate &B, float v, float fuel, float k)
+{
+    // A
+    const auto phi_a{getAngle(A.phi)};
+    const auto lambda_a{getAngle(A.lambda)};
+
+    // B
+    const auto phi_b{getAngle(B.phi)};
+    const auto lambda_b{getAngle(B.lambda)};
+
+    const auto eAB{calcGCDkm(A, B)};
+
+    // alpha
+    const auto alpha{calcAlphaRad(A, B)};
+
+    // deltaLambda
+    const auto deltaLambda{lambda_a - lambda_b};
+
+    // Attribute für Streckenberechnung des Zwischenpunkts:
+    //const auto time{calcFlightTime(fuel,k)}; // So lange reicht der Treibstoff [h]
+
+    const auto calcDistanceRatio = [v, fuel, eAB, k]() {
+        const auto prop{(v * fuel) / (eAB * k)}; // > 1: Bewegung über Punkt B hinaus (also wieder zurück), < 1: B wird nicht erreicht, Zwischenpunkt dazwischen
+        float integral;
+        const auto frac{std::modf(prop, &integral)}; // Nachkommastellen des Verhältnisses
+
+        if (std::fmod(integral, 2.0f) != 0) // wie calcFlightDistanceRad, ohne Umwandlung in eine ganze Zahl
+            return 1 - frac; // von B ausgehend
+        else
+            return frac; // von A ausgehend
+    };
+
+    const auto distance{calcDistanceRatio() * calcGCDrad(A, B)}; // Strecke von A nach B in rad
+
+    // Längengrad muss abhängig von Vorzeichen berechnet werden:
+    const auto calcLambda_p = [deltaLambda, distance, lambda_a, phi_a](float phi_p) {
+        if (((deltaLambda < 0) && (distance <= M_PI)) || ((deltaLambda > 0) && (distance > M_PI)))               // arccos() bildet nur auf Interval [0; M_PI) ab, daher dessen Argument zusätzlich in Abhängigkeit von d behandeln!
+            return lambda_a + acosf((cosf(distance) - sinf(phi_a) * sinf(phi_p)) / (cosf(phi_a) * cosf(phi_p))); // Flugrichtung: Osten
+        else
+            return lambda_a - acosf((cosf(distance) - sinf(phi_a) * sinf(phi_p)) / (cosf(phi_a) * cosf(phi_p))); // Flugrichtung: Westen
+    };
+
+    // ***************************** SONDERFALL *****************************
+    // Sonderfall: beide Koordinaten liegen auf gleichem Großkreis: Flugrichtung ist dann direkt nach Norden bzw. Süden entlang eines Meridians
+    // nachfolgend ausschließlich diverse Lambdas, die erforderliche Funktionen definieren
+    // endgültige Berechnung erfolgt zum Funktionsende
+
+    // Der Breitegrad wird auf das Intervall (-pi; pi] gemappt:
+    const auto transformPhi = [](float phi_x, float lambda_x) {
+        if ((phi_x >= 0) && (lambda_x < 0))
+            return M_PI - phi_x;
+        else if ((phi_x < 0) & (lambda_x < 0))
+            return -M_PI - phi_x;
+        return static_cast<double>(phi_x); // östliche Hälfte bleibt unverändert
+    };
+
+    // mathematisch kürzeste Flugstrecke ist dann dPhi = phi_a - phi_b, dazu noch auf entsprechendes Interval mappen:
+    const auto calcDeltaPhiDach = [](float deltaPhi_dach) -> float {
+        if (deltaPhi_dach > M_PI)
+            return deltaPhi_dach - 2 * M_PI;
+        else if (deltaPhi_dach < -M_PI)
+            return deltaPhi_dach + 2 * M_PI;
+        else
+            return deltaPhi_dach;
+    };
+
+    // transformierter Breitengrad des Zielpunktes:
+    const auto calcTransformPhi = [distance](float deltaPhi_dach, float phi_a_dach) {
+        if (deltaPhi_dach >= 0)
+            return phi_a_dach - distance; // Flugrichtung: Süden (distance ist in rad)
+        else
+            return phi_a_dach + distance; // Flugrichtung: Norden
+    };
+
+    // Breitengrad wird auf Interval (-pi; pi] reduziert und auf Ausgangsinterval zurück transformiert:
+    const auto calcInterval = [](float phi_p_dach) -> float {
+        if (phi_p_dach > (M_PI / 2))
+            return M_PI - phi_p_dach;
+        else if (phi_p_dach < -(M_PI / 2))
+            return -M_PI - phi_p_dach;
+        else
+            return phi_p_dach;
+    };
+
+    // Längengrad des Zielpunktes: A und B liegen auf demselben Halbmeridian, der Bogen A-B führt nicht über einen Pol
+    // und die Flugstrecke ist höchstens so lang wie A-B:
+    const auto calcLambda_p_special = [lambda_a]() -> float { return lambda_a; };
+
+    // Berechnet den Breitengrad des Zwischenpunktes abhängig davon ob Sonderfall (auf Meridian) oder kein Sonderfall (nicht auf Meridian) vorliegt:
+    const auto resPhi_p = [lambda_a, phi_a, lambda_b, phi_b, calcInterval, calcTransformPhi, calcDeltaPhiDach, transformPhi, distance, alpha]() {
+        if (lambda_a == lambda_b)
+            return calcInterval(calcTransformPhi(calcDeltaPhiDach(transformPhi(phi_a, lambda_a) - transformPhi(phi_b, lambda_b)), transformPhi(phi_a, lambda_a))); // Zwischenpunkt liegt auf Meridian
+        else
+            return asinf(cosf(distance) * sinf(phi_a) + sinf(distance) * cos(phi_a) * cosf(alpha)); // Zwischenpunkt nicht auf Meridian
+    };
+
+    // Berechnet den Längengrad des Zwischenpunktes abhängig davon ob Sonderfall (auf Meridian) oder kein Sonderfall (nicht auf Meridian) vorliegt:
+    const auto resLambda_p = [lambda_a, lambda_b, calcLambda_p_special, calcLambda_p](float phi_p) {
+        if (lambda_a == lambda_b)
+            return calcLambda_p_special();
+        else
+            return calcLambda_p(phi_p);
+    };
+    // ****************************************************
+
+    const auto phi_p{resPhi_p()};
+    const auto lambda_p{resLambda_p(phi_p)};
+
+    return Coordinate(rad2deg(phi_p), rad2deg(lambda_p), "Zwischenpunkt", 0);
+}
+
+
+/// Vorbereitete Koordinaten
+// Bezeichnung einer Koordinate in der Konsole: A-Z für die ersten 26, danach #ID:
+inline std::string coordinateLabel(uint32_t id)
+{
+    return (id < 26) ? std::string(1, static_cast<char>('A' + id)) : '#' + std::to_string(id);
+}
+
+// Vorbereitete Koordinate aus dem Grad/Minuten/Sekunden-Format:
+template <class T = float>
+inline BasicPreparedCoordinate<T> prepared(const Coordinate &c) noexcept
+{
+    return BasicPreparedCoordinate<T>(getAngle<T>(c.phi), getAngle<T>(c.lambda), c.name, (c.no >= 'A') ? static_cast<uint32_t>(c.no - 'A') : 0);
+}
+
+// Ausgabe wie Coordinate::print, Grad/Minuten/Sekunden werden aus dem Bogenmaß abgeleitet:
+template <class T>
+inline void printCoordinate(OutputBuffer &out, const BasicPreparedCoordinate<T> &c)
+{
+    const auto [phi_angle, phi_min, phi_sec] = splitDMS(rad2deg(c.phi));
+    const auto [lambda_angle, lambda_min, lambda_sec] = splitDMS(rad2deg(c.lambda));
+
+    out << ansi(BOLD KGRN) << coordinateLabel(c.id) << ".) " << ansi(RESET BOLD) << c.name << '\n' << ansi(RESET);
+    out << "\t\u03A6: "; // phi
+    AngleEl{phi_angle, phi_min, phi_sec, (c.phi < 0) ? directionEl::S : directionEl::N}.print(out);
+    out << "\t\u03BB: "; // lambda
+    AngleAz{lambda_angle, lambda_min, lambda_sec, (c.lambda < 0) ? directionAz::W : directionAz::O}.print(out);
+    out << "\n\n";
+}
+
+// Nördlichster Punkt wie calcNorthPeakPointRad, als Coordinate zur Ausgabe:
+template <class T>
+inline Coordinate calcNorthPeakPoint(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> alpha)
+{
+    if (A.lambda == B.lambda)
+        return Coordinate{90, 0, 0, directionEl::N, 0, 0, 0, directionAz::O, "Nordpol", 0};
+
+    const auto s{calcNorthPeakPointRad(A, B, alpha)};
+    return Coordinate(static_cast<float>(rad2deg(s.phi)), static_cast<float>(rad2deg(s.lambda)), "Nördlichster Punkt", 0);
+}
+
+// Nördlichster Punkt auf Großkreis (Kurswinkel werden hier berechnet):
+template <class T>
+inline Coordinate calcNorthPeakPoint(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B)
+{
+    if (A.lambda == B.lambda)
+        return calcNorthPeakPoint(A, B, T{0}); // Sonderfall Meridian, Kurswinkel wird nicht benötigt
+
+    return calcNorthPeakPoint(A, B, calcAlphaRad(A, B));
+}
+
+// Zwischenpunkt wie calcCrashPointRad, als Coordinate zur Ausgabe:
+template <class T>
+inline Coordinate calcCrashPoint(const BasicPreparedCoordinate<T> &A, const BasicPreparedCoordinate<T> &B, Scalar<T> v, Scalar<T> fuel, Scalar<T> k)
+{
+    const auto p{calcCrashPointRad(A, B, v, fuel, k)};
+    return Coordinate(static_cast<float>(rad2deg(p.phi)), static_cast<float>(rad2deg(p.lambda)), "Zwischenpunkt", 0);
+}
@@ -0,0 +1,255 @@
+// Laufzeitstatistik der heißen Pfade (--stats): Aufrufe, Summen und Latenz-Histogramme je Messstelle
+//
+// Jeder Thread schreibt in eigene Zähler (keine atomaren Operationen, kein Teilen von Cache-Lines); die Zähler werden
+// beim Bericht zusammengeführt. Die Histogramme sind logarithmisch mit 8 Unterteilungen je Zweierpotenz (Abweichung der
+// Perzentile höchstens 1/16 des Werts). Gemessen wird nur nach stats::enable(), sonst kostet eine Messstelle eine
+// Verzweigung. Mit -DNO_STATS entfallen die Messstellen vollständig (STATS_SCOPE wird zu nichts).
+#pragma once
+
+/// Standardbibliotheken
+#include <chrono>   // std::chrono::steady_clock
+#include <cstddef>  // size_t
+#include <cstdint>  // int-Typen
+#include <iomanip>  // std::setw
+#include <memory>   // std::unique_ptr
+#include <mutex>    // std::mutex
+#include <ostream>  // std::ostream
+#include <vector>   // std::vector
+
+namespace stats
+{
+    // Messstellen:
+    enum class Probe : uint8_t
+    {
+        ParseLine,            // Zeile der Koordinatendatei
+        Lookup,               // CoordinateRegistry::resolve (Bezeichner/Kennung/ID, Konsole und Stapelmodus)
+        CentricAngle,         // Befehl 1
+        HeadingAngle,         // Befehl 2
+        NorthPeakPoint,       // Befehl 3
+        RouteLength,          // Befehl 4
+        LoxodromicCourse,     // Befehl 5
+        LoxodromicLength,     // Befehl 6
+        CrashPoint,           // Befehl 7
+        Format,               // Ausgabe eines Ergebnisses
+        Count
+    };
+
+    // Die Befehle 1 bis 7 werden als Ganzes gemessen und heißen nach dem Befehl, nicht nach einer Kernfunktion: je nach
+    // --backend bzw. --earth rechnen sie mit unterschiedlichen Funktionen (z.B. Befehl 4 mit calcGeodesicKm bei wgs84).
+    inline const char *probeName(Probe probe) noexcept
+    {
+        static const char *const names[]{"parseLine", "resolve", "cmd1 centralAngle", "cmd2 course", "cmd3 northPeak",
+                                         "cmd4 distance", "cmd5 loxCourse", "cmd6 loxLength", "cmd7 crashPoint", "format"};
+        return (probe < Probe::Count) ? names[static_cast<size_t>(probe)] : "";
+    }
+
+    // Messstelle eines Befehls 1 bis 7 (sonst Probe::Count, wird nicht gemessen):
+    inline Probe commandProbe(int cmd) noexcept
+    {
+        return ((cmd >= 1) && (cmd <= 7)) ? static_cast<Probe>(static_cast<int>(Probe::CentricAngle) + cmd - 1) : Probe::Count;
+    }
+
+    // Histogramm (auch ohne Messstellen verfügbar, z.B. für Latenzen im Servermodus):
+    constexpr size_t Buckets{16 + 60 * 8}; // 0..15 ns einzeln, danach 8 je Zweierpotenz bis 2^64
+
+    // Histogramm-Fach zu einer Dauer in ns:
+    inline size_t bucket(uint64_t ns) noexcept
+    {
+        if (ns < 16)
+            return static_cast<size_t>(ns);
+        const auto e{63 - __builtin_clzll(ns)}; // >= 4
+        return 16 + static_cast<size_t>(e - 4) * 8 + ((ns >> (e - 3)) & 7);
+    }
+
+    // Untere Grenze und Breite eines Fachs:
+    inline uint64_t bucketLow(size_t b) noexcept
+    {
+        if (b < 16)
+            return b;
+        const auto e{(b - 16) / 8 + 4};
+        return (uint64_t{8} + (b - 16) % 8) << (e - 3);
+    }
+
+    inline uint64_t bucketWidth(size_t b) noexcept
+    {
+        return (b < 16) ? 1 : (uint64_t{1} << ((b - 16) / 8 + 1));
+    }
+
+    struct Histogram
+    {
+        uint64_t calls{0}, total{0}, max{0}; // ns
+        uint64_t counts[Buckets]{};
+
+        void add(uint64_t ns) noexcept
+        {
+            calls++;
+            total += ns;
+            max = (ns > max) ? ns : max;
+            counts[bucket(ns)]++;
+        }
+
+        void merge(const Histogram &other) noexcept
+        {
+            calls += other.calls;
+            total += other.total;
+            max = (other.max > max) ? other.max : max;
+            for (size_t b = 0; b < Buckets; b++)
+                counts[b] += other.counts[b];
+        }
+
+        // Perzentil p in [0; 1] (Mitte des Fachs, höchstens max):
+        uint64_t percentile(double p) const noexcept
+        {
+            const auto rank{static_cast<uint64_t>(p * static_cast<double>(calls - 1))};
+            uint64_t seen{0};
+            for (size_t b = 0; b < Buckets; b++)
+            {
+                seen += counts[b];
+                if (seen > rank)
+                {
+                    const auto mid{bucketLow(b) + bucketWidth(b) / 2};
+                    return (mid < max) ? mid : max;
+                }
+            }
+            return max;
+        }
+    };
+
+#ifndef NO_STATS
+    // Zähler eines Threads:
+    struct alignas(64) ThreadCounters
+    {
+        Histogram probes[static_cast<size_t>(Probe::Count)];
+    };
+
+    // Alle Zähler aller Threads, leben bis Programmende (auch nach Ende der Threads):
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadCounters>> threads;
+        bool enabled{false};
+        std::chrono::steady_clock::time_point start;
+    };
+
+    inline Registry &registry(void)
+    {
+        static Registry r;
+        return r;
+    }
+
+    // Zähler des aufrufenden Threads, beim ersten Aufruf angelegt:
+    inline ThreadCounters &local(void)
+    {
+        thread_local ThreadCounters *counters{nullptr};
+        if (!counters)
+        {
+            auto &r{registry()};
+            const std::lock_guard<std::mutex> lock(r.mutex);
+            r.threads.push_back(std::make_unique<ThreadCounters>());
+            counters = r.threads.back().get();
+        }
+        return *counters;
+    }
+
+    // Vor dem Start weiterer Threads aufrufen:
+    inline void enable(void)
+    {
+        registry().enabled = true;
+        registry().start = std::chrono::steady_clock::now();
+    }
+
+    inline bool enabled(void) noexcept
+    {
+        return registry().enabled;
+    }
+
+    inline void record(Probe probe, uint64_t ns)
+    {
+        local().probes[static_cast<size_t>(probe)].add(ns);
+    }
+
+    // Misst die Lebensdauer des Objekts:
+    class Scope
+    {
+    public:
+        explicit Scope(Probe _probe) noexcept : probe(_probe), active(enabled() && (_probe < Probe::Count))
+        {
+            if (active)
+                start = std::chrono::steady_clock::now();
+        }
+
+        ~Scope()
+        {
+            if (active)
+                record(probe, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Probe probe;
+        bool active;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Führt die Zähler aller Threads zusammen und schreibt den Bericht (Zeiten in µs):
+    inline void report(std::ostream &out)
+    {
+        auto &r{registry()};
+        if (!r.enabled)
+            return;
+
+        Histogram merged[static_cast<size_t>(Probe::Count)];
+        {
+            const std::lock_guard<std::mutex> lock(r.mutex);
+            for (const auto &t : r.threads)
+                for (size_t p = 0; p < static_cast<size_t>(Probe::Count); p++)
+                    merged[p].merge(t->probes[p]);
+        }
+
+        const auto seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - r.start).count()};
+        const auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+
+        const auto flags{out.flags()};
+        const auto precision{out.precision()};
+        out << "Statistik nach " << std::fixed << std::setprecision(3) << seconds << " s (" << r.threads.size() << " Threads, Zeiten in µs):\n"
+            << std::left << std::setw(22) << "  Messstelle" << std::right << std::setw(10) << "Aufrufe" << std::setw(12) << "Aufrufe/s"
+            << std::setw(12) << "Summe ms" << std::setw(10) << "Mittel" << std::setw(10) << "p50" << std::setw(10) << "p95"
+            << std::setw(10) << "p99" << std::setw(10) << "Max" << '\n';
+
+        for (size_t p = 0; p < static_cast<size_t>(Probe::Count); p++)
+        {
+            const auto &h{merged[p]};
+            if (!h.calls)
+                continue;
+
+            out << "  " << std::left << std::setw(20) << probeName(static_cast<Probe>(p)) << std::right << std::setw(10) << h.calls
+                << std::setprecision(0) << std::setw(12) << (seconds > 0 ? h.calls / seconds : 0.0)
+                << std::setprecision(3) << std::setw(12) << static_cast<double>(h.total) / 1e6
+                << std::setw(10) << us(h.total) / h.calls << std::setw(10) << us(h.percentile(0.50)) << std::setw(10) << us(h.percentile(0.95))
+                << std::setw(10) << us(h.percentile(0.99)) << std::setw(10) << us(h.max) << '\n';
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+#define STATS_SCOPE(probe) const stats::Scope STATS_CONCAT(statsScope, __LINE__){probe}
+#else
+    inline void enable(void) {}
+
+    inline bool enabled(void) noexcept
+    {
+        return false;
+    }
+
+    inline void report(std::ostream &out)
+    {
+        out << "Statistik nicht verfügbar (mit -DNO_STATS übersetzt)\n";
+    }
+
+#define STATS_SCOPE(probe)
+#endif
+} // namespace stats
@@ -0,0 +1,289 @@
+// Koordinatenspeicher (alle Winkel im Bogenmaß)
+//
+// CoordinateStore besitzt die Koordinaten als gepackte Datensätze (CoordinateRecord, 16 Byte: phi, lambda und zwei
+// 32-Bit-Handles für Bezeichner und Kennung in einer Arena, strings.hpp). CoordinateView ist eine nicht besitzende
+// Sicht darauf, die ebenso auf eine eingeblendete Binärdatenbank (database.hpp) zeigen kann; alle Stapelberechnungen
+// arbeiten auf der Sicht. Die Winkelfunktionen (sin/cos von phi und lambda, Mercator-Ordinate) sind abgeleitet: Eine
+// Sicht kann sie als Spalten mitbringen (Datenbank, Cache des Speichers nach cacheTrig(), libtrig), sonst berechnet
+// prepared(i) sie bei Bedarf und die Kerne legen sie mit withTrig() einmal je Aufruf an.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm>   // std::min
+#include <cmath>       // sinf, cosf, logf, tanf
+#include <cstddef>     // size_t
+#include <cstdint>     // int-Typen
+#include <memory>      // std::shared_ptr
+#include <string_view> // std::string_view
+#include <type_traits> // std::is_trivially_copyable
+#include <vector>      // std::vector
+
+/// Eigene Header
+#include "geometry.hpp" // PreparedCoordinate
+#include "strings.hpp"  // StringPool
+
+// Besitzende Darstellung einer Koordinate im Speicher:
+struct CoordinateRecord
+{
+    float phi;                // Breitengrad
+    float lambda;             // Längengrad
+    StringPool::Handle name;  // Bezeichner in der Arena des Speichers
+    StringPool::Handle code;  // Kennung (z.B. ICAO-Code), StringPool::Empty wenn keine vorhanden
+};
+static_assert(sizeof(CoordinateRecord) == 16, "CoordinateRecord muss gepackt bleiben");
+static_assert(std::is_trivially_copyable<CoordinateRecord>::value, "CoordinateRecord wird blockweise kopiert");
+
+// float-Spalte mit Schrittweite: 1 für Spalten einer Binärdatenbank, 4 für ein Feld von CoordinateRecord.
+struct FloatColumn
+{
+    const float *data{nullptr};
+    size_t stride{1}; // in float
+
+    FloatColumn() = default;
+    FloatColumn(const float *_data, size_t _stride = 1) noexcept : data(_data), stride(_stride) {}
+
+    float operator[](size_t i) const noexcept
+    {
+        return data[i * stride];
+    }
+};
+
+// Nicht besitzende Sicht auf die Koordinaten eines Speichers oder einer Binärdatenbank:
+struct CoordinateView
+{
+    size_t count{0};
+
+    FloatColumn phi;    // Breitengrade
+    FloatColumn lambda; // Längengrade
+
+    // Vorberechnete Winkelfunktionen als zusammenhängende Spalten, alle nullptr wenn nicht vorhanden (siehe hasTrig):
+    const float *sinPhi{nullptr};
+    const float *cosPhi{nullptr};
+    const float *sinLambda{nullptr};
+    const float *cosLambda{nullptr};
+    const float *sigma{nullptr}; // Mercator-Ordinate
+
+    // Bezeichner und Kennungen entweder als Handles in einen StringPool (Koordinatenspeicher) ...
+    const StringPool *strings{nullptr};
+    const CoordinateRecord *records{nullptr};
+
+    // ... oder hintereinander mit Versatztabelle (Binärdatenbank), falls strings == nullptr:
+    const uint32_t *nameOffsets{nullptr}; // count + 1 Einträge, Bezeichner i liegt in [nameOffsets[i]; nameOffsets[i + 1])
+    const char *names{nullptr};           // Bezeichner hintereinander, ohne Nullterminierung
+    const uint32_t *codeOffsets{nullptr}; // Kennungen (z.B. ICAO-Code) wie Bezeichner, nullptr wenn keine vorhanden
+    const char *codes{nullptr};
+
+    size_t size(void) const noexcept
+    {
+        return count;
+    }
+
+    bool hasTrig(void) const noexcept
+    {
+        return sinPhi != nullptr;
+    }
+
+    std::string_view name(size_t i) const noexcept
+    {
+        if (strings)
+            return strings->get(records[i].name);
+        return std::string_view(names + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+    }
+
+    std::string_view code(size_t i) const noexcept
+    {
+        if (strings)
+            return strings->get(records[i].code);
+        if (!codeOffsets)
+            return {};
+        return std::string_view(codes + codeOffsets[i], codeOffsets[i + 1] - codeOffsets[i]);
+    }
+
+    // Vorbereitete Koordinate i, mit vorberechneten Spalten ohne erneute Auswertung der Winkelfunktionen:
+    PreparedCoordinate prepared(size_t i) const noexcept
+    {
+        if (!hasTrig())
+            return PreparedCoordinate{phi[i], lambda[i], name(i), static_cast<uint32_t>(i)};
+        return PreparedCoordinate{phi[i], lambda[i], sinPhi[i], cosPhi[i], sinLambda[i], cosLambda[i], sigma[i],
+                                  name(i), static_cast<uint32_t>(i)};
+    }
+};
+
+// Spalten der Winkelfunktionen (Cache eines Speichers bzw. von withTrig für einen Kernaufruf):
+struct TrigColumns
+{
+    std::vector<float> sinPhi, cosPhi, sinLambda, cosLambda, sigma;
+
+    void push(const PreparedCoordinate &c)
+    {
+        sinPhi.push_back(c.sinPhi);
+        cosPhi.push_back(c.cosPhi);
+        sinLambda.push_back(c.sinLambda);
+        cosLambda.push_back(c.cosLambda);
+        sigma.push_back(c.sigma);
+    }
+
+    void reserve(size_t n)
+    {
+        for (auto *col : {&sinPhi, &cosPhi, &sinLambda, &cosLambda, &sigma})
+            col->reserve(n);
+    }
+
+    void clear(void) noexcept
+    {
+        for (auto *col : {&sinPhi, &cosPhi, &sinLambda, &cosLambda, &sigma})
+            std::vector<float>().swap(*col);
+    }
+
+    size_t bytes(void) const noexcept
+    {
+        return 5 * sinPhi.capacity() * sizeof(float);
+    }
+
+    size_t spare(void) const noexcept
+    {
+        auto n{SIZE_MAX};
+        for (const auto *col : {&sinPhi, &cosPhi, &sinLambda, &cosLambda, &sigma})
+            n = std::min(n, col->capacity() - col->size());
+        return n;
+    }
+
+    // Trägt die Spalten in v ein:
+    void attach(CoordinateView &v) const noexcept
+    {
+        v.sinPhi = sinPhi.data();
+        v.cosPhi = cosPhi.data();
+        v.sinLambda = sinLambda.data();
+        v.cosLambda = cosLambda.data();
+        v.sigma = sigma.data();
+    }
+};
+
+// Sicht mit Winkelfunktionsspalten für die Kerne: coords selbst, wenn sie welche mitbringt, sonst einmalig aus
+// phi/lambda in cache berechnet (cache muss die zurückgegebene Sicht überleben).
+inline CoordinateView withTrig(const CoordinateView &coords, TrigColumns &cache)
+{
+    if (coords.hasTrig() || (coords.size() == 0))
+        return coords;
+
+    cache.reserve(coords.size());
+    for (size_t i = 0; i < coords.size(); i++)
+        cache.push(PreparedCoordinate{coords.phi[i], coords.lambda[i]});
+
+    auto v{coords};
+    cache.attach(v);
+    return v;
+}
+
+// Besitzender Koordinatenspeicher. Bezeichner und Kennungen werden im StringPool interniert; Speicher, die aus einem
+// anderen hervorgehen (z.B. beim Neuladen), teilen sich dessen Arena, unveränderte Bezeichner werden dann nicht kopiert.
+// Die Arena belegt erst mit dem ersten Bezeichner Speicher (z.B. nicht bei --convert oder eingeblendeter Datenbank).
+// Die Winkelfunktionen werden nur nach cacheTrig() gespeichert (20 Byte je Koordinate zusätzlich), z.B. wenn viele
+// Abfragen dieselben Koordinaten vorbereiten.
+struct CoordinateStore
+{
+    std::vector<CoordinateRecord> records;
+    std::shared_ptr<StringPool> strings;
+    TrigColumns trig; // leer, solange cacheTrig() nicht aufgerufen wurde
+
+    explicit CoordinateStore(std::shared_ptr<StringPool> pool = std::make_shared<StringPool>()) : strings(std::move(pool)) {}
+
+    void add(float _phi, float _lambda, std::string_view name = {}, std::string_view code = {})
+    {
+        records.push_back(CoordinateRecord{_phi, _lambda, strings->intern(name), strings->intern(code)});
+        if (cachedTrig)
+            trig.push(PreparedCoordinate{_phi, _lambda});
+    }
+
+    void add(const PreparedCoordinate &c, std::string_view code = {}) // übernimmt die bereits vorberechneten Winkelfunktionen
+    {
+        records.push_back(CoordinateRecord{c.phi, c.lambda, strings->intern(c.name), strings->intern(code)});
+        if (cachedTrig)
+            trig.push(c);
+    }
+
+    // Hängt die Koordinaten [first; first + n) einer Sicht an. Bei gleicher Arena werden die Datensätze blockweise
+    // kopiert, Winkelfunktionen der Quelle übernommen.
+    void append(const CoordinateView &src, size_t first, size_t n)
+    {
+        if (src.strings == strings.get())
+            records.insert(records.end(), src.records + first, src.records + first + n);
+        else
+            for (size_t i = first; i < first + n; i++)
+                records.push_back(CoordinateRecord{src.phi[i], src.lambda[i], strings->intern(src.name(i)), strings->intern(src.code(i))});
+
+        if (cachedTrig)
+            for (size_t i = first; i < first + n; i++)
+                trig.push(src.prepared(i));
+    }
+
+    // Legt die Winkelfunktionen als Spalten an (bzw. verwirft sie mit on == false), view() liefert sie dann mit:
+    void cacheTrig(bool on = true)
+    {
+        if (on == cachedTrig)
+            return;
+        cachedTrig = on;
+        trig.clear();
+        if (!on)
+            return;
+        trig.reserve(records.capacity());
+        for (const auto &r : records)
+            trig.push(PreparedCoordinate{r.phi, r.lambda});
+    }
+
+    // Koordinaten, die ohne Umlagern der Datensätze (und ggf. Winkelfunktionen) angehängt werden können; bis dahin
+    // bleiben Sichten auf die bisherigen Koordinaten gültig:
+    size_t spare(void) const noexcept
+    {
+        const auto free{records.capacity() - records.size()};
+        return cachedTrig ? std::min(free, trig.spare()) : free;
+    }
+
+    bool hasTrigCache(void) const noexcept
+    {
+        return cachedTrig;
+    }
+
+    void reserve(size_t n)
+    {
+        records.reserve(n);
+        if (cachedTrig)
+            trig.reserve(n);
+    }
+
+    size_t size(void) const noexcept
+    {
+        return records.size();
+    }
+
+    // Belegter Speicher in Byte (Datensätze, ggf. Winkelfunktionen und Arena, diese ggf. mit anderen Speichern geteilt):
+    size_t bytes(void) const noexcept
+    {
+        return records.capacity() * sizeof(CoordinateRecord) + trig.bytes() + strings->bytes();
+    }
+
+    CoordinateView view(void) const noexcept
+    {
+        CoordinateView v;
+        v.count = size();
+        if (!records.empty())
+        {
+            constexpr auto Stride{sizeof(CoordinateRecord) / sizeof(float)};
+            v.phi = FloatColumn{&records[0].phi, Stride};
+            v.lambda = FloatColumn{&records[0].lambda, Stride};
+        }
+        if (cachedTrig)
+            trig.attach(v);
+        v.strings = strings.get();
+        v.records = records.data();
+        return v;
+    }
+
+    operator CoordinateView(void) const noexcept
+    {
+        return view();
+    }
+
+private:
+    bool cachedTrig{false};
+};
@@ -0,0 +1,177 @@
+// Arena für Bezeichner und Kennungen mit Internierung (gleiche Zeichenketten werden nur einmal abgelegt)
+//
+// Zeichenketten liegen mit 2 Byte Längenpräfix hintereinander in Blöcken zu 1 MiB, die nie verschoben werden. Ein
+// Handle (32 Bit) ist die Position in der Arena: Block = Handle >> 20, Versatz = Handle & (1 MiB - 1). Handle 0 ist
+// die leere Zeichenkette. Die Blocktabelle hat feste Größe, get() ist daher auch dann sicher, wenn ein anderer Thread
+// gleichzeitig neue Zeichenketten anhängt (nur ein schreibender Thread, Handles müssen vorher veröffentlicht sein,
+// z.B. über einen neuen Stand des Katalogs). Blocktabelle und erster Block werden erst mit der ersten nicht leeren
+// Zeichenkette angelegt, ein leerer Pool belegt keinen Speicher. Die Internierung nutzt eine offene Hashtabelle aus
+// Handles (4 Byte je Platz, Füllgrad <= 50 %), verglichen wird gegen den Text in der Arena.
+#pragma once
+
+/// Standardbibliotheken
+#include <cstddef>     // size_t
+#include <cstdint>     // int-Typen
+#include <cstring>     // std::memcpy, std::memset
+#include <memory>      // std::unique_ptr
+#include <stdexcept>   // std::length_error
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+class StringPool
+{
+public:
+    using Handle = uint32_t;
+
+    static constexpr Handle Empty{0};
+    static constexpr size_t MaxLength{UINT16_MAX}; // Zeichen je Eintrag
+
+    StringPool() = default;
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    // Liefert das Handle von str, legt die Zeichenkette bei Bedarf an. Wirft std::length_error bei zu langen
+    // Zeichenketten bzw. voller Arena (4 GiB).
+    Handle intern(std::string_view str)
+    {
+        if (str.empty())
+            return Empty;
+        if (str.size() > MaxLength)
+            throw std::length_error("Bezeichner länger als 64 KiB!");
+
+        if (2 * (count + 1) > table.size())
+            rehash(table.empty() ? 1024 : 2 * table.size());
+
+        const auto mask{table.size() - 1};
+        auto pos{hash(str) & mask};
+        for (; table[pos] != Empty; pos = (pos + 1) & mask)
+            if (get(table[pos]) == str)
+                return table[pos];
+
+        const auto handle{append(str)};
+        table[pos] = handle;
+        count++;
+        return handle;
+    }
+
+    std::string_view get(Handle handle) const noexcept
+    {
+        if (handle == Empty) // auch ohne angelegte Blöcke
+            return {};
+        const char *p{blocks[handle >> BlockBits].get() + (handle & BlockMask)};
+        uint16_t length;
+        std::memcpy(&length, p, Prefix);
+        return std::string_view(p + Prefix, length);
+    }
+
+    // Stand der Arena für rollback():
+    struct Mark
+    {
+        size_t allocated, used, count;
+    };
+
+    Mark mark(void) const noexcept
+    {
+        return Mark{allocated, used, count};
+    }
+
+    // Verwirft alle seit m angelegten Zeichenketten (z.B. nach einem fehlgeschlagenen Neuladen). Deren Handles dürfen
+    // nirgends veröffentlicht worden sein; ältere Handles bleiben gültig, auch für gleichzeitig lesende Threads.
+    void rollback(const Mark &m)
+    {
+        if (count == m.count)
+            return;
+
+        const auto limit{m.allocated ? static_cast<Handle>(((m.allocated - 1) << BlockBits) | m.used) : Empty}; // Handles steigen monoton
+        for (auto b = m.allocated; b < allocated; b++)
+            blocks[b].reset();
+        allocated = m.allocated;
+        used = m.used;
+        count = m.count;
+        rehash(table.size(), limit);
+    }
+
+    // Anzahl verschiedener (nicht leerer) Zeichenketten:
+    size_t size(void) const noexcept
+    {
+        return count;
+    }
+
+    // Belegter Speicher (Blöcke und Hashtabelle) in Byte:
+    size_t bytes(void) const noexcept
+    {
+        return allocated * BlockSize + table.capacity() * sizeof(Handle) + (blocks ? MaxBlocks * sizeof(blocks[0]) : 0);
+    }
+
+private:
+    static constexpr size_t BlockBits{20};
+    static constexpr size_t BlockSize{size_t{1} << BlockBits};
+    static constexpr size_t BlockMask{BlockSize - 1};
+    static constexpr size_t MaxBlocks{(size_t{UINT32_MAX} + 1) >> BlockBits};
+    static constexpr size_t Prefix{sizeof(uint16_t)};
+
+    std::unique_ptr<std::unique_ptr<char[]>[]> blocks; // feste Tabelle ab dem ersten Block, Blöcke werden nur angehängt
+    size_t allocated{0};       // Blöcke
+    size_t used{0};            // Byte im letzten Block
+    size_t count{0};           // Einträge
+    std::vector<Handle> table; // Internierung, Empty = frei
+
+    // FNV-1a:
+    static uint32_t hash(std::string_view str) noexcept
+    {
+        uint32_t h{2166136261u};
+        for (const auto c : str)
+            h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+        return h;
+    }
+
+    void allocate(void)
+    {
+        if (allocated == MaxBlocks)
+            throw std::length_error("Bezeichner überschreiten 4 GiB!");
+        if (!blocks)
+            blocks.reset(new std::unique_ptr<char[]>[MaxBlocks]);
+        blocks[allocated++].reset(new char[BlockSize]);
+        used = 0;
+
+        if (allocated == 1) // Handle 0: leere Zeichenkette
+        {
+            std::memset(blocks[0].get(), 0, Prefix);
+            used = Prefix;
+        }
+    }
+
+    Handle append(std::string_view str)
+    {
+        if ((allocated == 0) || (used + Prefix + str.size() > BlockSize)) // Einträge liegen nie über einer Blockgrenze
+            allocate();
+
+        char *p{blocks[allocated - 1].get() + used};
+        const auto length{static_cast<uint16_t>(str.size())};
+        std::memcpy(p, &length, Prefix);
+        std::memcpy(p + Prefix, str.data(), str.size());
+
+        const auto handle{static_cast<Handle>(((allocated - 1) << BlockBits) | used)};
+        used += Prefix + str.size();
+        return handle;
+    }
+
+    // Baut die Tabelle mit capacity Plätzen neu auf, Handles ab limit entfallen:
+    void rehash(size_t capacity, Handle limit = UINT32_MAX)
+    {
+        std::vector<Handle> old(capacity, Empty);
+        old.swap(table);
+
+        const auto mask{table.size() - 1};
+        for (const auto handle : old)
+        {
+            if ((handle == Empty) || (handle >= limit))
+                continue;
+            auto pos{hash(get(handle)) & mask};
+            while (table[pos] != Empty)
+                pos = (pos + 1) & mask;
+            table[pos] = handle;
+        }
+    }
+};
@@ -0,0 +1,289 @@
+// Parameterstudie zum Zwischenpunkt (Befehl 7) über Gitter aus Geschwindigkeit, Treibstoff und Verbrauch
+//
+// calcCrashPointRad berechnet je Aufruf Zentriwinkel, Kurswinkel und die Daten des Meridian-Sonderfalls neu, obwohl
+// sie nur von A und B abhängen. CrashSweep berechnet die Geometrie der Strecke einmal (Einheitsvektor a von A,
+// Tangente t in A Richtung B, Zentriwinkel zeta, wie GreatCircleLeg). Der Zwischenpunkt hängt dann nur noch von der
+// Flugstrecke v * fuel / k ab:
+//   prop = v * fuel / (e_AB * k), s = frac(prop) bzw. 1 - frac(prop) (ungerader Anteil: Rückflug ab B), s *= zeta
+//   p(s) = a cos(s) + t sin(s)
+// Der Meridianflug braucht keinen Sonderfall. Das Gitter wird blockweise in Struct-of-Arrays-Schleifen ohne
+// Verzweigungen ausgewertet und über den Thread-Pool verteilt. Mit Accuracy::Fast laufen sin/cos und atan2 über die
+// Polynome aus fastmath.hpp (ohne libm-Aufruf, vektorisierbar); der Zwischenpunkt weicht dann um höchstens
+// FastAtan2MaxError * r_E (ca. 80 m) ab.
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm> // std::min, std::sort
+#include <charconv>  // std::from_chars
+#include <cmath>     // std::floor, std::atan2, std::sqrt, std::sin, std::cos
+#include <cstddef>   // size_t
+#include <cstdint>   // int-Typen
+#include <stdexcept> // std::overflow_error, std::invalid_argument
+#include <string_view> // std::string_view
+#include <vector>    // std::vector
+
+/// Eigene Header
+#include "sphere.hpp"   // PreparedCoordinate, Point, r_E
+#include "fastmath.hpp" // Accuracy, fastSin, fastAtan2
+#include "executor.hpp" // ThreadPool
+
+// Achse des Gitters: Einzelwert ("600"), Liste ("500,600,700") oder Bereich "Start:Ende:Schritt" (Ende eingeschlossen):
+struct SweepAxis
+{
+    static constexpr size_t MaxValues{1 << 20};
+
+    std::vector<float> values;
+
+    // Wirft bei ungültigem Format, Schritt <= 0 oder zu vielen Werten:
+    static SweepAxis parse(std::string_view token)
+    {
+        const auto toFloat = [](std::string_view s) {
+            float value;
+            const auto res{std::from_chars(s.data(), s.data() + s.size(), value)};
+            if ((res.ec != std::errc{}) || (res.ptr != s.data() + s.size()))
+                throw std::invalid_argument("Ungültiger Wert in Parameterbereich!");
+            return value;
+        };
+
+        SweepAxis axis;
+        const auto colon{token.find(':')};
+        if (colon != std::string_view::npos)
+        {
+            const auto second{token.find(':', colon + 1)};
+            if (second == std::string_view::npos)
+                throw std::invalid_argument("Bereich erwartet Start:Ende:Schritt!");
+
+            const auto first{toFloat(token.substr(0, colon))};
+            const auto last{toFloat(token.substr(colon + 1, second - colon - 1))};
+            const auto step{toFloat(token.substr(second + 1))};
+            if (!(step > 0.0f) || !(last >= first) || ((last - first) / step >= MaxValues))
+                throw std::invalid_argument("Ungültiger Parameterbereich!");
+
+            // Werte als first + i * step (keine aufsummierten Rundungsfehler), Ende mit halbem Promille Spielraum:
+            const auto count{static_cast<size_t>(std::floor((last - first) / step + 5e-4f)) + 1};
+            axis.values.reserve(count);
+            for (size_t i = 0; i < count; i++)
+                axis.values.push_back(first + static_cast<float>(i) * step);
+            return axis;
+        }
+
+        while (!token.empty())
+        {
+            const auto comma{token.find(',')};
+            axis.values.push_back(toFloat(token.substr(0, comma)));
+            if (axis.values.size() > MaxValues)
+                throw std::invalid_argument("Zu viele Werte in Parameterliste!");
+            token = (comma == std::string_view::npos) ? std::string_view{} : token.substr(comma + 1);
+        }
+        if (axis.values.empty())
+            throw std::invalid_argument("Leere Parameterliste!");
+        return axis;
+    }
+
+    size_t size(void) const noexcept
+    {
+        return values.size();
+    }
+};
+
+// Ergebnis eines Gitterpunkts bzw. eines Punkts der Reichweitenlinie:
+struct SweepPoint
+{
+    float v, fuel, k; // Parameter (Linie: vom ersten Gitterpunkt mit dieser Flugstrecke)
+    float along;      // Abstand des Zwischenpunkts von A entlang der Strecke in km
+    float phi, lambda;
+};
+
+class CrashSweep
+{
+public:
+    static constexpr size_t Block{256}; // Gitterpunkte je Schleifendurchlauf
+
+    // Wirft bei gleichen oder gegenüberliegenden Punkten (Großkreis nicht eindeutig):
+    CrashSweep(const PreparedCoordinate &A, const PreparedCoordinate &B)
+    {
+        const double a[3]{double{A.cosPhi} * A.cosLambda, double{A.cosPhi} * A.sinLambda, double{A.sinPhi}};
+        const double b[3]{double{B.cosPhi} * B.cosLambda, double{B.cosPhi} * B.sinLambda, double{B.sinPhi}};
+
+        const auto dot{a[0] * b[0] + a[1] * b[1] + a[2] * b[2]};
+        double t[3]{b[0] - dot * a[0], b[1] - dot * a[1], b[2] - dot * a[2]};
+        const auto norm{std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2])};
+
+        if (norm < 1e-9)
+            throw std::overflow_error("Großkreis durch A und B ist nicht eindeutig!");
+
+        for (int k = 0; k < 3; k++)
+        {
+            origin[k] = static_cast<float>(a[k]);
+            tangent[k] = static_cast<float>(t[k] / norm);
+        }
+        zeta = static_cast<float>(std::atan2(norm, dot));
+        eAB = zeta * r_E;
+    }
+
+    // Länge der Strecke A-B in km:
+    float km(void) const noexcept
+    {
+        return eAB;
+    }
+
+    // Zwischenpunkt für eine Flugstrecke v * fuel / k in km (Pendeln zwischen A und B wie calcFlightDistanceRad):
+    Point at(float flight, float *along = nullptr) const noexcept
+    {
+        float phi, lambda, s;
+        evaluate(&flight, 1, &phi, &lambda, &s, Accuracy::Exact);
+        if (along)
+            *along = s;
+        return Point{phi, lambda};
+    }
+
+    // Wertet das Gitter v x fuel x k aus (k läuft innen, v außen) und ruft sink(points, count, first) je Block in
+    // Gitterreihenfolge auf. Mit pool werden Blöcke parallel berechnet; sink läuft dann in mehreren Threads, jeder
+    // Block hat seinen eigenen Bereich ab first. Wirft bei k <= 0 oder negativer Geschwindigkeit bzw. Treibstoff.
+    template <class Sink>
+    void sweep(const SweepAxis &v, const SweepAxis &fuel, const SweepAxis &k, Sink &&sink, ThreadPool *pool = nullptr,
+               Accuracy accuracy = Accuracy::Exact) const
+    {
+        validate(v, fuel, k);
+        const auto nk{k.size()}, nfk{fuel.size() * nk}, total{v.size() * nfk};
+
+        const auto block = [&](size_t begin, size_t end) {
+            float flight[Block], phi[Block], lambda[Block], along[Block];
+            SweepPoint points[Block];
+            for (auto first = begin; first < end; first += Block)
+            {
+                const auto count{std::min(Block, end - first)};
+
+                // Gitterindizes am Blockanfang, danach weiterzählen (keine Division je Punkt):
+                auto iv{first / nfk}, jf{(first % nfk) / nk}, jk{first % nk};
+                for (size_t i = 0; i < count; i++)
+                {
+                    points[i].v = v.values[iv];
+                    points[i].fuel = fuel.values[jf];
+                    points[i].k = k.values[jk];
+                    flight[i] = points[i].v * points[i].fuel / points[i].k;
+                    if (++jk == nk)
+                    {
+                        jk = 0;
+                        if (++jf == fuel.size())
+                            jf = 0, iv++;
+                    }
+                }
+
+                evaluate(flight, count, phi, lambda, along, accuracy);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    points[i].along = along[i];
+                    points[i].phi = phi[i];
+                    points[i].lambda = lambda[i];
+                }
+                sink(static_cast<const SweepPoint *>(points), count, first);
+            }
+        };
+
+        if (!pool || (pool->size() == 1))
+            return block(0, total);
+
+        pool->parallelFor(total, 16 * Block, block);
+    }
+
+    // Erreichbare Punkte als Linie entlang der Strecke: jeder Zwischenpunkt einmal, sortiert nach Abstand von A.
+    // Gleiche Flugstrecken (z.B. doppelte Geschwindigkeit bei doppeltem Verbrauch) werden vor der Auswertung
+    // zusammengefasst.
+    std::vector<SweepPoint> reachable(const SweepAxis &v, const SweepAxis &fuel, const SweepAxis &k, ThreadPool *pool = nullptr,
+                                      Accuracy accuracy = Accuracy::Exact) const
+    {
+        validate(v, fuel, k);
+
+        std::vector<SweepPoint> line;
+        line.reserve(v.size() * fuel.size() * k.size());
+        for (const auto sv : v.values)
+            for (const auto sf : fuel.values)
+                for (const auto sk : k.values)
+                    line.push_back(SweepPoint{sv, sf, sk, foldedKm(sv * sf / sk), 0.0f, 0.0f});
+
+        std::stable_sort(line.begin(), line.end(), [](const SweepPoint &x, const SweepPoint &y) { return x.along < y.along; });
+        line.erase(std::unique(line.begin(), line.end(), [](const SweepPoint &x, const SweepPoint &y) { return x.along == y.along; }), line.end());
+
+        const auto block = [&](size_t begin, size_t end) {
+            float flight[Block], phi[Block], lambda[Block], along[Block];
+            for (auto first = begin; first < end; first += Block)
+            {
+                const auto count{std::min(Block, end - first)};
+                for (size_t i = 0; i < count; i++)
+                    flight[i] = line[first + i].v * line[first + i].fuel / line[first + i].k;
+                evaluate(flight, count, phi, lambda, along, accuracy);
+                for (size_t i = 0; i < count; i++)
+                    line[first + i].phi = phi[i], line[first + i].lambda = lambda[i];
+            }
+        };
+
+        if (!pool || (pool->size() == 1))
+            block(0, line.size());
+        else
+            pool->parallelFor(line.size(), 16 * Block, block);
+
+        return line;
+    }
+
+private:
+    float origin[3], tangent[3];
+    float zeta; // Zentriwinkel in rad
+    float eAB;  // Strecke in km
+
+    static void validate(const SweepAxis &v, const SweepAxis &fuel, const SweepAxis &k)
+    {
+        for (const auto x : v.values)
+            if (!(x >= 0.0f))
+                throw std::invalid_argument("Geschwindigkeit muss >= 0 sein!");
+        for (const auto x : fuel.values)
+            if (!(x >= 0.0f))
+                throw std::invalid_argument("Treibstoff muss >= 0 sein!");
+        for (const auto x : k.values)
+            if (!(x > 0.0f))
+                throw std::invalid_argument("Verbrauch muss > 0 sein!");
+    }
+
+    // Abstand von A in km nach Pendeln zwischen A und B (wie calcFlightDistanceRad). prop >= 0, ganzzahliger Anteil
+    // über Umwandlung statt floor (libm-Aufruf); ab 2^23 hat float keine Nachkommastellen mehr:
+    float foldedKm(float flight) const noexcept
+    {
+        const auto prop{flight / eAB};
+        const auto big{!(prop < 8388608.0f)};
+        const auto whole{static_cast<int32_t>(big ? 0.0f : prop)};
+        const auto frac{big ? 0.0f : prop - static_cast<float>(whole)};
+        return ((whole & 1) ? 1.0f - frac : frac) * eAB; // ungerade: Rückflug ab B
+    }
+
+    // Zwischenpunkte für count Flugstrecken (km), verzweigungsfrei über alle Werte:
+    void evaluate(const float *flight, size_t count, float *phi, float *lambda, float *along, Accuracy accuracy) const noexcept
+    {
+        for (size_t i = 0; i < count; i++)
+            along[i] = foldedKm(flight[i]);
+
+        if (accuracy == Accuracy::Fast)
+        {
+            // lokale Kopien: die Ausgaben dürfen sonst als Alias der Geometrie gelten
+            const auto a0{origin[0]}, a1{origin[1]}, a2{origin[2]}, t0{tangent[0]}, t1{tangent[1]}, t2{tangent[2]};
+            for (size_t i = 0; i < count; i++)
+            {
+                const auto s{along[i] / r_E}; // in [0; pi]
+                const auto cs{fastSin(static_cast<float>(M_PI / 2) - s)}, sn{fastSin(s)};
+                const auto x{a0 * cs + t0 * sn}, y{a1 * cs + t1 * sn}, z{a2 * cs + t2 * sn};
+                phi[i] = fastAtan2(z, std::sqrt(x * x + y * y));
+                lambda[i] = fastAtan2(y, x);
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto s{along[i] / r_E};
+            const auto cs{std::cos(s)}, sn{std::sin(s)};
+            const auto x{origin[0] * cs + tangent[0] * sn}, y{origin[1] * cs + tangent[1] * sn}, z{origin[2] * cs + tangent[2] * sn};
+            phi[i] = std::atan2(z, std::sqrt(x * x + y * y));
+            lambda[i] = std::atan2(y, x);
+        }
+    }
+};
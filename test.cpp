@@ -0,0 +1,351 @@
+// Regressionstests für Fehler, die bereits aufgetreten sind (Aufruf: make test)
+
+/// Standardbibliotheken
+#include <cmath>    // std::fabs, std::remainder
+#include <cstdio>   // std::remove
+#include <fstream>  // std::ifstream, std::ofstream
+#include <iostream> // Konsolenausgabe
+#include <iterator> // std::istreambuf_iterator
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+/// Eigene Header
+#include "nvector.hpp" // Backend, calcCrashPointRad
+#include "store.hpp"   // CoordinateStore, StringPool, withTrig
+#include "database.hpp" // Database, writeDatabase
+#include "catalog.hpp"  // Catalog
+#include "libtrig.hpp"  // trig::distances, trig::evaluate
+
+using PointD = BasicPoint<double>;
+
+static uint32_t failures{0}; // Anzahl fehlgeschlagener Prüfungen
+
+// Vorbereitete Koordinate aus Grad:
+inline PreparedCoordinateD preparedDeg(double phi, double lambda)
+{
+    return PreparedCoordinateD(deg2rad(phi), deg2rad(lambda));
+}
+
+// Vergleicht zwei Winkel in Grad, Längengrade modulo 360 Grad:
+void check(const char *name, double actual, double expected, double tolerance = 1e-6)
+{
+    if (std::fabs(std::remainder(actual - expected, 360.0)) <= tolerance)
+        return;
+    std::cerr << "FEHLER " << name << ": " << actual << " statt " << expected << '\n';
+    ++failures;
+}
+
+// Zwischenpunkt nach dem Bruchteil frac der Strecke A-B (Flugstrecke = frac * Strecke A-B):
+PointD crashPointDeg(const PreparedCoordinateD &A, const PreparedCoordinateD &B, double frac, Backend backend)
+{
+    const auto p{calcCrashPointRad(A, B, calcGCDkm(A, B), frac, 1.0, backend)};
+    return PointD{rad2deg(p.phi), rad2deg(p.lambda)};
+}
+
+// Befehl 7 über die Datumsgrenze: der kürzere Weg führt von 170° O nach Osten über 180°, nicht zurück nach Westen.
+void testCrashPointAntimeridian()
+{
+    const auto A{preparedDeg(10, 170)}, B{preparedDeg(20, -170)};
+    for (const auto frac : {0.25, 0.5, 0.75})
+    {
+        const auto trig{crashPointDeg(A, B, frac, Backend::Trig)};
+        const auto nvec{crashPointDeg(A, B, frac, Backend::NVector)};
+        check("Datumsgrenze phi", trig.phi, nvec.phi);
+        check("Datumsgrenze lambda", trig.lambda, nvec.lambda);
+    }
+
+    const auto west{crashPointDeg(B, A, 0.5, Backend::Trig)}; // Rückweg von 170° W nach Westen
+    check("Datumsgrenze Rückweg lambda", west.lambda, crashPointDeg(B, A, 0.5, Backend::NVector).lambda);
+}
+
+// Befehl 7 auf einem Meridian nach Süden, weiter als 90° - phi_A: der Zwischenpunkt bleibt auf dem Meridian von A
+// (bisher um 180° gedreht, im Gegensatz zu Befehl 13 und --backend nvector).
+void testCrashPointMeridian()
+{
+    const auto A{preparedDeg(60, 10)}, B{preparedDeg(0, 10)};
+    for (const auto backend : {Backend::Trig, Backend::NVector})
+    {
+        const auto p{crashPointDeg(A, B, 40.0 / 60.0, backend)};
+        check("Meridian Süden phi", p.phi, 20);
+        check("Meridian Süden lambda", p.lambda, 10);
+    }
+
+    const auto legacy{calcCrashPoint(Coordinate(60.0f, 10.0f, "A", 'A'), Coordinate(0.0f, 10.0f, "B", 'B'),
+                                     static_cast<float>(calcGCDkm(A, B)), 40.0f / 60.0f, 1.0f)};
+    check("Meridian Süden lambda (Coordinate)", rad2deg(getAngle<double>(legacy.lambda)), 10, 1e-3);
+}
+
+// Pendeln zwischen A und B: gerade/ungerade Anzahl Teilstrecken auch bei Verhältnissen >= 2^32 (bisher undefinierte
+// Umwandlung in uint32_t, z.B. bei fast gleichen Punkten):
+void testFlightDistanceParity()
+{
+    const auto km{earthRadius<double>}; // Strecke A-B für zeta == 1
+    check("Pendeln 3.25", calcFlightDistanceRad(1.0, 3.25 * km, 1.0, 1.0), 0.75);
+    check("Pendeln 2^33 + 1.5", calcFlightDistanceRad(1.0, 8589934593.5 * km, 1.0, 1.0), 0.5);
+    check("Pendeln 2^33 + 0.25", calcFlightDistanceRad(1.0, 8589934592.25 * km, 1.0, 1.0), 0.25, 1e-3);
+}
+
+// Befehl 3 auf einem Meridian: beide Rechenweisen liefern den Nordpol bei Längengrad 0.
+void testNorthPeakMeridian()
+{
+    const auto A{preparedDeg(10, 20)}, B{preparedDeg(50, 20)};
+    for (const auto backend : {Backend::Trig, Backend::NVector})
+    {
+        const auto s{calcNorthPeakPointRad(A, B, backend)};
+        check("Meridian Scheitelpunkt phi", rad2deg(s.phi), 90);
+        check("Meridian Scheitelpunkt lambda", rad2deg(s.lambda), 0);
+    }
+}
+
+// Ein leerer StringPool (z.B. im Koordinatenspeicher bei --convert) belegt keine Arena, Rücksetzen auf den leeren
+// Stand gibt alle Blöcke wieder frei.
+void testStringPoolLazy()
+{
+    CoordinateStore store;
+    if (store.strings->bytes() != 0)
+    {
+        std::cerr << "FEHLER leerer StringPool belegt " << store.strings->bytes() << " Byte\n";
+        ++failures;
+    }
+    if (!store.strings->get(StringPool::Empty).empty())
+    {
+        std::cerr << "FEHLER leere Zeichenkette ohne Arena\n";
+        ++failures;
+    }
+
+    auto &pool{*store.strings};
+    const auto mark{pool.mark()};
+    const auto a{pool.intern("Würzburg")};
+    if ((a == StringPool::Empty) || (pool.get(a) != "Würzburg") || (pool.intern("Würzburg") != a))
+    {
+        std::cerr << "FEHLER Internierung im ersten Block\n";
+        ++failures;
+    }
+
+    pool.rollback(mark);
+    const auto b{pool.intern("Tokio")};
+    if ((pool.size() != 1) || (b == StringPool::Empty) || (pool.get(b) != "Tokio"))
+    {
+        std::cerr << "FEHLER Rücksetzen auf leere Arena\n";
+        ++failures;
+    }
+}
+
+// Der Koordinatenspeicher besitzt nur Datensätze; vorbereitete Koordinaten sind mit und ohne Winkelfunktions-Cache
+// gleich, withTrig liefert für die Kerne dieselben Spalten wie der Cache.
+void testStoreTrigCache()
+{
+    CoordinateStore plain, cached;
+    cached.cacheTrig();
+    for (auto *store : {&plain, &cached})
+    {
+        store->add(0.8690f, 0.1737f, "Würzburg", "EDFW");
+        store->add(-0.3997f, -0.7540f, "Rio de Janeiro");
+    }
+
+    const auto a{plain.view()}, b{cached.view()};
+    TrigColumns derived;
+    const auto c{withTrig(a, derived)};
+    if (a.hasTrig() || !b.hasTrig() || !c.hasTrig() || (a.code(0) != "EDFW") || (a.name(1) != "Rio de Janeiro"))
+    {
+        std::cerr << "FEHLER Sicht des Koordinatenspeichers\n";
+        ++failures;
+    }
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        const auto p{a.prepared(i)}, q{b.prepared(i)};
+        if ((p.phi != q.phi) || (p.lambda != q.lambda) || (p.sinPhi != q.sinPhi) || (p.cosLambda != q.cosLambda) || (p.sigma != q.sigma) ||
+            (c.sinLambda[i] != b.sinLambda[i]) || (c.cosPhi[i] != b.cosPhi[i]))
+        {
+            std::cerr << "FEHLER Winkelfunktionen ohne Cache, Koordinate " << i << '\n';
+            ++failures;
+        }
+    }
+}
+
+// Stapelfunktionen über mehrere Blöcke (einer nach vielen und paarweise) gegen die skalaren Funktionen, unbestimmte
+// Ergebnisse als NaN bzw. Status ohne Exception:
+void testLibrary()
+{
+    std::vector<Point> a(600), b(600);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        a[i] = Point{0.0013f * i - 0.39f, 0.0101f * i - 3.0f};
+        b[i] = Point{0.5f - 0.0017f * i, 2.9f - 0.0097f * i};
+    }
+    b[7] = a[7];
+
+    std::vector<float> km(b.size()), one(b.size()), rad(b.size());
+    const auto pairs{trig::distances(a, b, km)};
+    const auto single{trig::distances(trig::Span<const Point>(a.data(), 1), b, one)};
+    const auto courses{trig::courses(a, b, rad)};
+    if ((pairs != trig::Status::Ok) || (single != trig::Status::Ok) || (courses != trig::Status::Undefined) || !std::isnan(rad[7]) ||
+        std::isnan(rad[8]) || (trig::distances(a, b, trig::Span<float>(km.data(), 5)) != trig::Status::SizeMismatch))
+    {
+        std::cerr << "FEHLER Status der Stapelfunktionen\n";
+        ++failures;
+    }
+
+    const auto first{trig::prepare(a[0])};
+    for (size_t i = 0; i < b.size(); i++)
+    {
+        const auto d{calcGCDkm(trig::prepare(a[i]), trig::prepare(b[i]))}, e{calcGCDkm(first, trig::prepare(b[i]))};
+        if ((std::fabs(km[i] - d) > 5.0f) || (std::fabs(one[i] - e) > 5.0f))
+        {
+            std::cerr << "FEHLER Stapelstrecke " << i << ": " << km[i] << " / " << one[i] << " statt " << d << " / " << e << '\n';
+            ++failures;
+        }
+    }
+
+    trig::Result res;
+    const float params[]{800.0f, 10.0f, 2.0f};
+    if ((trig::evaluate(9, first, first, params, res) != trig::Status::UnknownCommand) ||
+        (trig::evaluate(2, first, first, params, res, Backend::NVector) != trig::Status::Undefined) ||
+        (trig::evaluate(7, first, first, params, res, Backend::NVector) != trig::Status::Undefined) ||
+        (trig::evaluate(3, first, trig::prepare(b[0]), params, res) != trig::Status::Ok) || !res.point)
+    {
+        std::cerr << "FEHLER trig::evaluate\n";
+        ++failures;
+    }
+}
+
+// Angehängte Zeilen werden allein zerlegt und in den Speicher des bisherigen Stands angehängt, der weiter gültig bleibt;
+// alte und neue Bezeichner sind auffindbar. Geänderte Zeilen laufen über den Vergleich aller Zeilen, ersetzte
+// Bezeichner lassen die Arena nicht unbegrenzt wachsen.
+void testCatalogAppend()
+{
+    constexpr auto File{"test_catalog.txt"};
+    const auto line = [](size_t i, const std::string &name) { return "12 34 " + std::to_string(i % 60) + " N, 65 43 21 O, " + name + '\n'; };
+    const auto write = [&line](size_t count, const std::string &middle) {
+        std::ofstream out(File, std::ios::trunc);
+        for (size_t i = 0; i < count; i++)
+            out << line(i, (i == 50) && !middle.empty() ? middle : "Punkt " + std::to_string(i));
+    };
+    const auto fail = [](const char *what) {
+        std::cerr << "FEHLER Neuladen: " << what << '\n';
+        ++failures;
+    };
+
+    write(100, "");
+    Catalog catalog(File, 16);
+    const auto first{catalog.current()};
+
+    ReloadReport r;
+    for (size_t i = 100; i < 120; i++)
+    {
+        std::ofstream(File, std::ios::app) << line(i, "Punkt " + std::to_string(i));
+        catalog.reload(&r, true);
+        if (!r.appended || (r.parsed != 1) || (r.added != 1) || (r.count != i + 1))
+            fail("angehängte Zeile");
+    }
+
+    const auto appended{catalog.current()};
+    if ((appended->registry.find("Punkt 0") != 0) || (appended->registry.find("Punkt 119") != 119) || (appended->registry.layers() > 6))
+        fail("Verzeichnis mit Ebenen");
+    if ((first->view.size() != 100) || (first->registry.find("Punkt 99") != 99) || (first->registry.find("Punkt 100") != InvalidId) ||
+        (first->view.name(42) != "Punkt 42"))
+        fail("bisheriger Stand nach dem Anhängen");
+
+    write(120, "Geändert");
+    catalog.reload(&r, true);
+    const auto changed{catalog.current()};
+    if (r.appended || (r.parsed != 1) || (changed->registry.find("Geändert") != 50) || (changed->registry.find("Punkt 50") != InvalidId) ||
+        (changed->registry.find("Punkt 119") != 119))
+        fail("geänderte Zeile");
+
+    bool rebuilt{false};
+    for (size_t k = 0; k < 300; k++)
+    {
+        write(120, "Geändert " + std::to_string(k));
+        catalog.reload(&r, true);
+        rebuilt |= r.poolRebuilt;
+    }
+    const auto last{catalog.current()};
+    if (!rebuilt || (last->store->strings->size() > 2 * 120) || (last->registry.find("Geändert 299") != 50))
+        fail("Arena nach vielen Änderungen");
+
+    std::remove(File);
+}
+
+// Beschädigte Binärdatenbanken werden beim Öffnen abgewiesen, statt außerhalb der Einblendung zu lesen:
+void testDatabaseBounds()
+{
+    constexpr auto File{"test_bounds.db"};
+    CoordinateStore store;
+    store.add(0.1f, 0.2f, "Würzburg", "EDFW");
+    store.add(0.3f, 0.4f, "Tokio", "RJTT");
+    store.add(0.5f, 0.6f, "Rio de Janeiro");
+    writeDatabase(store.view(), File);
+
+    std::string original;
+    {
+        std::ifstream in(File, std::ios::binary);
+        original.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // Schreibt die Datei nach change(header, bytes) neu (fileSize passt zur neuen Länge) und versucht sie zu öffnen:
+    const auto opens = [&](auto &&change) {
+        auto bytes{original};
+        DatabaseHeader h;
+        std::memcpy(&h, bytes.data(), sizeof(h));
+        change(h, bytes);
+        h.fileSize = bytes.size();
+        std::memcpy(&bytes[0], &h, sizeof(h));
+        std::ofstream(File, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        try
+        {
+            Database db(File);
+            return true;
+        }
+        catch (const std::runtime_error &)
+        {
+            return false;
+        }
+    };
+
+    const struct
+    {
+        const char *name;
+        bool valid;
+        void (*change)(DatabaseHeader &, std::string &);
+    } cases[]{
+        {"unverändert", true, [](DatabaseHeader &, std::string &) {}},
+        {"abgeschnittene Kennungen", false, [](DatabaseHeader &h, std::string &b) { b.resize(h.codeIndexOffset + 4); }},
+        {"Anzahl zu groß", false, [](DatabaseHeader &h, std::string &) { h.count = UINT64_MAX / 2; }},
+        {"Spalte hinter Dateiende", false, [](DatabaseHeader &h, std::string &b) { h.lambdaOffset = b.size(); }},
+        {"Spalte nicht ausgerichtet", false, [](DatabaseHeader &h, std::string &) { h.phiOffset += 2; }},
+        {"Versatz ohne Überlauf", false, [](DatabaseHeader &h, std::string &) { h.trigOffset = UINT64_MAX - 3; }},
+        {"Namensverzeichnis fällt", false, [](DatabaseHeader &h, std::string &b) {
+             const auto last{static_cast<uint32_t>(h.nameDataSize)}; // Eintrag 1 liegt dann hinter Eintrag 2
+             std::memcpy(&b[h.nameIndexOffset + sizeof(uint32_t)], &last, sizeof(last));
+         }},
+    };
+    for (const auto &c : cases)
+        if (opens(c.change) != c.valid)
+        {
+            std::cerr << "FEHLER Datenbank " << c.name << ": " << (c.valid ? "abgewiesen" : "geöffnet") << '\n';
+            ++failures;
+        }
+    std::remove(File);
+}
+
+int main()
+{
+    testCrashPointAntimeridian();
+    testCrashPointMeridian();
+    testNorthPeakMeridian();
+    testFlightDistanceParity();
+    testStringPoolLazy();
+    testStoreTrigCache();
+    testLibrary();
+    testCatalogAppend();
+    testDatabaseBounds();
+
+    if (failures)
+    {
+        std::cerr << failures << " Prüfung(en) fehlgeschlagen\n";
+        return 1;
+    }
+    std::cout << "Alle Prüfungen bestanden\n";
+    return 0;
+}
@@ -0,0 +1,555 @@
+// Rundreise über viele Stopps (Reihenfolge optimieren) auf einer einmal berechneten Distanzmatrix
+//
+// Aufbau:
+//   - Die Stopps werden entlang einer Hilbert-Kurve über (Länge, Breite) umnummeriert. Räumlich benachbarte Stopps haben
+//     dann benachbarte Nummern, die Matrixzeilen (calcGCDMatrix, dicht, float) der Kandidaten eines Zuges liegen nahe
+//     beieinander im Speicher.
+//   - Je Stopp werden die TourOptions::neighbours nächsten Stopps als Kandidatenliste abgelegt. Verbesserungszüge prüfen nur Kanten zu
+//     diesen Kandidaten (statt aller n), abgebrochen wird, sobald die neue Kante länger als die entfernte ist.
+//   - Start: Nächster-Nachbar-Tour ab dem ersten Stopp, danach lokale Suche mit 2-opt und Or-opt (Teilstücke mit 1 bis 3
+//     Stopps verschieben, auch umgedreht). "Don't look bits": nur Stopps, deren Nachbarschaft sich geändert hat, werden
+//     erneut geprüft.
+//   - Verbesserung im Zeitbudget: jeder Thread des Pools führt eine iterierte lokale Suche aus (Double-Bridge-Störung
+//     eines kurzen Abschnitts, lokale Suche ab den geänderten Stopps, Übernahme nur bei kürzerer Tour). Die beste Tour
+//     wird geteilt; Threads, die zurückliegen, übernehmen sie in regelmäßigen Abständen.
+// Die beste Tour wird über einen Callback gemeldet (höchstens alle TourOptions::reportInterval Sekunden und am Ende).
+#pragma once
+
+/// Standardbibliotheken
+#include <algorithm> // std::min, std::sort, std::nth_element, std::rotate, std::reverse
+#include <atomic>    // std::atomic
+#include <chrono>    // std::chrono::steady_clock
+#include <cstddef>   // size_t
+#include <cstdint>   // int-Typen
+#include <mutex>     // std::mutex
+#include <random>    // std::mt19937
+#include <stdexcept> // std::out_of_range, std::length_error
+#include <vector>    // std::vector
+
+/// Eigene Header
+#include "sphere.hpp"   // PreparedCoordinate
+#include "store.hpp"    // CoordinateView, CoordinateStore
+#include "batch.hpp"    // calcGCDMatrix
+#include "executor.hpp" // ThreadPool
+
+// Einstellungen der Optimierung:
+struct TourOptions
+{
+    double seconds{1.0};        // Zeitbudget der Verbesserung (ohne Aufbau der Matrix)
+    size_t neighbours{10};      // Kandidaten je Stopp
+    double reportInterval{0.2}; // Mindestabstand der Zwischenstände in s
+    uint32_t seed{1};           // Zufallsfolge der Störungen (je Thread seed + Nummer)
+};
+
+// Zwischen- bzw. Endstand der Optimierung:
+struct TourProgress
+{
+    const std::vector<uint32_t> &order; // IDs der Stopps in Reihenfolge, beginnt mit dem ersten Stopp
+    double km;                          // Länge der Rundreise (zurück zum ersten Stopp)
+    double seconds;                     // seit Beginn der Verbesserung
+    uint64_t kicks;                     // bisherige Störungen über alle Threads
+    bool final;                         // Endstand
+};
+
+namespace tour
+{
+    constexpr float Eps{1e-3f};       // km, kleinere Gewinne gelten nicht als Verbesserung
+    constexpr size_t MaxStops{20000}; // Distanzmatrix 1.6 GB
+
+    // Position auf einer Hilbert-Kurve über ein 2^16 x 2^16-Gitter:
+    inline uint64_t hilbertIndex(uint32_t x, uint32_t y) noexcept
+    {
+        uint64_t d{0};
+        for (uint32_t s = 1u << 15; s > 0; s >>= 1)
+        {
+            const uint32_t rx{(x & s) ? 1u : 0u}, ry{(y & s) ? 1u : 0u};
+            d += uint64_t{s} * s * ((3 * rx) ^ ry);
+            if (ry == 0) // Quadrant drehen
+            {
+                if (rx == 1)
+                {
+                    x = 0xFFFF - x;
+                    y = 0xFFFF - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    // Distanzmatrix und Kandidatenlisten der Stopps (Nummern 0..n-1 in Hilbert-Reihenfolge):
+    class Instance
+    {
+    public:
+        Instance(const CoordinateView &coords, const std::vector<uint32_t> &stops, size_t neighbours, ThreadPool *pool)
+            : n(stops.size()), k(std::min(neighbours, stops.empty() ? size_t{0} : stops.size() - 1))
+        {
+            if (n > MaxStops)
+                throw std::length_error("Zu viele Stopps für die Distanzmatrix!");
+
+            std::vector<std::pair<uint64_t, uint32_t>> order(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                if (stops[i] >= coords.size())
+                    throw std::out_of_range("Ungültige ID in Stoppliste!");
+                const auto x{static_cast<uint32_t>((coords.lambda[stops[i]] + M_PI) / (2 * M_PI) * 65535.0)};
+                const auto y{static_cast<uint32_t>((coords.phi[stops[i]] + M_PI / 2) / M_PI * 65535.0)};
+                order[i] = {hilbertIndex(std::min(x, 0xFFFFu), std::min(y, 0xFFFFu)), static_cast<uint32_t>(i)};
+            }
+            std::sort(order.begin(), order.end());
+
+            CoordinateStore sub;
+            sub.reserve(n);
+            ids.resize(n);
+            local.resize(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                ids[i] = stops[order[i].second];
+                local[order[i].second] = static_cast<uint32_t>(i);
+                auto c{coords.prepared(ids[i])};
+                c.name = {};
+                sub.add(c);
+            }
+
+            matrix = calcGCDMatrix(sub.view(), MatrixLayout::Dense, detectIsa(), pool);
+            for (size_t i = 0; i < n; i++)
+                matrix[i * n + i] = 0.0f;
+
+            // Kandidaten: die k nächsten je Zeile, aufsteigend nach Abstand
+            candidates.resize(n * k);
+            const auto rows = [this](size_t begin, size_t end) {
+                std::vector<uint32_t> idx(n);
+                for (auto i = begin; i < end; i++)
+                {
+                    size_t m{0};
+                    for (uint32_t j = 0; j < n; j++)
+                        if (j != i)
+                            idx[m++] = j;
+                    const auto *row{&matrix[i * n]};
+                    const auto closer = [row](uint32_t a, uint32_t b) { return row[a] < row[b]; };
+                    std::nth_element(idx.begin(), idx.begin() + k, idx.begin() + m, closer);
+                    std::sort(idx.begin(), idx.begin() + k, closer);
+                    std::copy(idx.begin(), idx.begin() + k, candidates.begin() + i * k);
+                }
+            };
+            if (!pool || (pool->size() == 1))
+                rows(0, n);
+            else
+                pool->parallelFor(n, 64, rows);
+        }
+
+        size_t size(void) const noexcept
+        {
+            return n;
+        }
+
+        float operator()(uint32_t a, uint32_t b) const noexcept
+        {
+            return matrix[size_t{a} * n + b];
+        }
+
+        const uint32_t *neighbours(uint32_t a) const noexcept
+        {
+            return candidates.data() + size_t{a} * k;
+        }
+
+        size_t neighbourCount(void) const noexcept
+        {
+            return k;
+        }
+
+        uint32_t id(uint32_t a) const noexcept
+        {
+            return ids[a];
+        }
+
+        // Nummer des i-ten übergebenen Stopps:
+        uint32_t stop(size_t i) const noexcept
+        {
+            return local[i];
+        }
+
+        double length(const std::vector<uint32_t> &tour) const noexcept
+        {
+            double km{0};
+            for (size_t i = 0; i < tour.size(); i++)
+                km += (*this)(tour[i], tour[(i + 1) % tour.size()]);
+            return km;
+        }
+
+    private:
+        size_t n, k;
+        std::vector<float> matrix;          // n x n, Zeilen in Hilbert-Reihenfolge
+        std::vector<uint32_t> candidates;   // n x k
+        std::vector<uint32_t> ids, local;   // Nummer -> ID, Eingabeindex -> Nummer
+    };
+
+    // Nächster-Nachbar-Tour ab Stopp start:
+    inline std::vector<uint32_t> nearestNeighbour(const Instance &inst, uint32_t start)
+    {
+        const auto n{inst.size()};
+        std::vector<uint32_t> tour;
+        std::vector<bool> used(n, false);
+        tour.reserve(n);
+        for (auto a = start; tour.size() < n;)
+        {
+            tour.push_back(a);
+            used[a] = true;
+            uint32_t best{a};
+            float bestKm{0};
+            for (uint32_t c = 0; c < n; c++)
+                if (!used[c] && ((best == a) || (inst(a, c) < bestKm)))
+                    best = c, bestKm = inst(a, c);
+            a = best;
+        }
+        return tour;
+    }
+
+    // Tour als Feld mit Positionen, lokale Suche (2-opt, Or-opt) und Störung. Alle Änderungen sind Umkehrungen bzw.
+    // Rotationen von Abschnitten und werden protokolliert, damit eine verworfene Störung in der Zeit ihrer Änderungen
+    // (statt O(n)) zurückgenommen werden kann:
+    class Search
+    {
+    public:
+        Search(const Instance &inst, std::vector<uint32_t> start) : inst(inst), n(inst.size()), tour(std::move(start)), pos(n), look(n, 1)
+        {
+            for (size_t i = 0; i < n; i++)
+                pos[tour[i]] = static_cast<uint32_t>(i);
+            for (uint32_t a = 0; a < n; a++)
+                queue.push_back(a);
+            km = inst.length(tour);
+        }
+
+        const std::vector<uint32_t> &order(void) const noexcept
+        {
+            return tour;
+        }
+
+        double length(void) const noexcept
+        {
+            return km;
+        }
+
+        void assign(const std::vector<uint32_t> &other, double otherKm)
+        {
+            tour = other;
+            km = otherKm;
+            for (size_t i = 0; i < n; i++)
+                pos[tour[i]] = static_cast<uint32_t>(i);
+            journal.clear();
+        }
+
+        // Beginnt ein neues Protokoll bzw. nimmt alle Änderungen seit mark zurück:
+        void mark(void)
+        {
+            journal.clear();
+            marked = km;
+        }
+
+        void undo(void)
+        {
+            for (auto it = journal.rbegin(); it != journal.rend(); ++it)
+            {
+                if (it->rotate)
+                    rotate(it->i, it->i + (it->end - it->j), it->end, false);
+                else
+                    reversePositions(it->i, it->j, false);
+            }
+            journal.clear();
+            km = marked;
+        }
+
+        // Lokale Suche ab allen markierten Stopps (anfangs alle, nach kick die Endpunkte):
+        void improve(void)
+        {
+            if (n < 5)
+                queue.clear();
+            while (!queue.empty())
+            {
+                const auto a{queue.back()};
+                queue.pop_back();
+                look[a] = 0;
+                if (twoOpt(a) || orOpt(a))
+                    wake(a);
+            }
+        }
+
+        // Double Bridge auf einem Abschnitt ab zufälliger Position (Teilstücke je 1..Span Stopps), die Endpunkte werden
+        // zur Prüfung markiert:
+        void kick(std::mt19937 &gen)
+        {
+            constexpr size_t Span{50};
+            if (n < 8)
+                return;
+            const auto span{std::min(Span, (n - 2) / 3)};
+            std::uniform_int_distribution<size_t> len{1, span};
+            const auto l1{len(gen)}, l2{len(gen)}, l3{len(gen)};
+            std::uniform_int_distribution<size_t> at{0, n - (l1 + l2 + l3) - 1};
+            const auto i{at(gen)};
+            const auto b{i + l1}, c{b + l2}, e{c + l3}; // [i; b) [b; c) [c; e) -> [i; b) [c; e) [b; c)
+
+            km += -inst(tour[b - 1], tour[b]) - inst(tour[c - 1], tour[c]) - inst(tour[e - 1], tour[e]);
+            km += inst(tour[b - 1], tour[c]) + inst(tour[e - 1], tour[b]) + inst(tour[c - 1], tour[e]);
+
+            rotate(b, c, e, true);
+            for (const auto p : {b - 1, b, b + l3 - 1, b + l3, e - 1, e})
+                wake(tour[p]);
+        }
+
+    private:
+        // Protokolleintrag: Umkehrung der Positionen i..j (zyklisch) bzw. Rotation [i; end) mit neuem Anfang j:
+        struct Change
+        {
+            uint32_t i, j, end;
+            bool rotate;
+        };
+
+        const Instance &inst;
+        const size_t n;
+        std::vector<uint32_t> tour, pos;
+        std::vector<uint8_t> look; // 1: Stopp muss geprüft werden
+        std::vector<uint32_t> queue;
+        std::vector<Change> journal;
+        double km{0}, marked{0};
+
+        uint32_t next(uint32_t a) const noexcept
+        {
+            return tour[(pos[a] + 1 == n) ? 0 : pos[a] + 1];
+        }
+
+        uint32_t prev(uint32_t a) const noexcept
+        {
+            return tour[(pos[a] == 0) ? n - 1 : pos[a] - 1];
+        }
+
+        void wake(uint32_t a)
+        {
+            if (!look[a])
+            {
+                look[a] = 1;
+                queue.push_back(a);
+            }
+        }
+
+        void reversePositions(size_t i, size_t j, bool log)
+        {
+            const auto len{(j + n - i) % n + 1};
+            for (size_t s = 0; s < len / 2; s++)
+            {
+                const auto p{(i + s) % n}, q{(j + n - s) % n};
+                std::swap(tour[p], tour[q]);
+                pos[tour[p]] = static_cast<uint32_t>(p);
+                pos[tour[q]] = static_cast<uint32_t>(q);
+            }
+            if (log)
+                journal.push_back(Change{static_cast<uint32_t>(i), static_cast<uint32_t>(j), 0, false});
+        }
+
+        void rotate(size_t b, size_t c, size_t e, bool log)
+        {
+            std::rotate(tour.begin() + b, tour.begin() + c, tour.begin() + e);
+            for (auto p = b; p < e; p++)
+                pos[tour[p]] = static_cast<uint32_t>(p);
+            if (log)
+                journal.push_back(Change{static_cast<uint32_t>(b), static_cast<uint32_t>(c), static_cast<uint32_t>(e), true});
+        }
+
+        // Dreht den Weg von u vorwärts bis v um. Bei mehr als n/2 Stopps wird stattdessen der Rest umgedreht: gleiche
+        // Kanten, die Tour liest sich danach in Gegenrichtung.
+        void reverse(uint32_t u, uint32_t v)
+        {
+            const size_t i{pos[u]}, j{pos[v]};
+            const auto len{(j + n - i) % n + 1};
+            if ((2 * len > n) && (len < n))
+                reversePositions((j + 1) % n, (i + n - 1) % n, true);
+            else
+                reversePositions(i, j, true);
+        }
+
+        bool twoOpt(uint32_t a)
+        {
+            const auto *cand{inst.neighbours(a)};
+            for (const bool forward : {true, false})
+            {
+                const auto b{forward ? next(a) : prev(a)};
+                const auto dab{inst(a, b)};
+                for (size_t m = 0; m < inst.neighbourCount(); m++)
+                {
+                    const auto c{cand[m]};
+                    const auto dac{inst(a, c)};
+                    if (dac >= dab - Eps)
+                        break;
+                    const auto d{forward ? next(c) : prev(c)};
+                    if ((c == b) || (d == a))
+                        continue;
+
+                    const auto delta{dac + inst(b, d) - dab - inst(c, d)};
+                    if (delta < -Eps)
+                    {
+                        // vorwärts: a b .. c d -> a c .. b d, rückwärts: b a .. d c -> b d .. a c
+                        forward ? reverse(b, c) : reverse(a, d);
+                        km += delta;
+                        wake(b), wake(c), wake(d);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // Verschiebt das Teilstück ab a (Länge 1..3) neben einen Kandidaten von a bzw. vom Ende des Teilstücks:
+        bool orOpt(uint32_t a)
+        {
+            for (size_t len = 1; len <= 3; len++)
+            {
+                const auto s1{a}, s2{tour[(pos[a] + len - 1) % n]};
+                const auto p{prev(s1)}, nx{next(s2)};
+                if ((p == nx) || (p == s2) || (nx == s1))
+                    return false;
+                const auto removed{inst(p, s1) + inst(s2, nx) - inst(p, nx)};
+                if (removed <= Eps)
+                    continue;
+
+                const auto inSegment = [&](uint32_t x) { return ((pos[x] + n - pos[s1]) % n) < len; };
+                for (const auto end : {s1, s2})
+                {
+                    const auto *cand{inst.neighbours(end)};
+                    for (size_t m = 0; m < inst.neighbourCount(); m++)
+                    {
+                        const auto c{cand[m]};
+                        const auto dc{inst(end, c)};
+                        if (dc >= removed - Eps)
+                            break;
+                        if (inSegment(c))
+                            continue;
+
+                        // end neben c: zwischen c und next(c) oder zwischen prev(c) und c
+                        for (const bool after : {true, false})
+                        {
+                            const auto e{after ? next(c) : prev(c)};
+                            if (inSegment(e))
+                                continue;
+                            const auto other{(end == s1) ? s2 : s1};
+                            const auto delta{dc + inst(other, e) - inst(c, e) - removed};
+                            if (delta < -Eps)
+                            {
+                                // Einsetzen zwischen x und next(x), an x grenzt first:
+                                const auto x{after ? c : e};
+                                move(s1, s2, p, nx, x, after ? end : other);
+                                km += delta;
+                                wake(p), wake(nx), wake(c), wake(e), wake(s1), wake(s2);
+                                return true;
+                            }
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+
+        // Setzt das Teilstück s1..s2 (zwischen p und nx) zwischen x und y = next(x) ein, first grenzt danach an x. Als
+        // Folge von Umkehrungen (2-opt-Züge):
+        //   p s1..s2 nx .. x y  ->  p x .. nx s2..s1 y  ->  p nx .. x s2..s1 y  (-> p nx .. x s1..s2 y)
+        // Nach einer Umkehrung des Rests liest sich die Tour in Gegenrichtung, die Richtung wird deshalb an p geprüft.
+        void move(uint32_t s1, uint32_t s2, uint32_t p, uint32_t nx, uint32_t x, uint32_t first)
+        {
+            reverse(s1, x);
+            if (next(p) == x)
+                reverse(x, nx);
+            else
+                reverse(nx, x);
+            if (first != s2)
+                (next(x) == s2) ? reverse(s2, s1) : reverse(s1, s2);
+        }
+    };
+} // namespace tour
+
+// Optimiert die Reihenfolge der Stopps (IDs aus coords) als Rundreise ab stops[0] im Zeitbudget und meldet Zwischenstände
+// an report(const TourProgress &). Mit pool sucht jeder Thread parallel. Liefert die beste Tour (IDs, ab stops[0]).
+template <class Report>
+std::vector<uint32_t> optimizeTour(const CoordinateView &coords, const std::vector<uint32_t> &stops, const TourOptions &options, Report &&report,
+                                   ThreadPool *pool = nullptr)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const tour::Instance inst(coords, stops, options.neighbours, pool);
+    const auto n{inst.size()};
+    if (n == 0)
+        return {};
+
+    const auto start{Clock::now()};
+    const auto elapsed = [start]() { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    // Gemeinsamer Stand, geschützt durch mutex:
+    std::mutex mutex;
+    tour::Search first(inst, tour::nearestNeighbour(inst, inst.stop(0)));
+    first.improve();
+    std::vector<uint32_t> best{first.order()};
+    double bestKm{first.length()};
+    std::atomic<uint64_t> version{0}, kicks{0};
+    double lastReport{-options.reportInterval};
+
+    std::vector<uint32_t> ids(n);
+    const auto publish = [&](bool final) { // nur unter mutex
+        const auto now{elapsed()};
+        if (!final && (now - lastReport < options.reportInterval))
+            return;
+        lastReport = now;
+        const auto origin{std::find(best.begin(), best.end(), inst.stop(0)) - best.begin()};
+        for (size_t i = 0; i < n; i++)
+            ids[i] = inst.id(best[(origin + i) % n]);
+        report(TourProgress{ids, inst.length(best), now, kicks.load(), final});
+    };
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        publish(false);
+    }
+
+    auto worker = [&](size_t w) {
+        tour::Search search(inst, best);
+        std::mt19937 gen{options.seed + static_cast<uint32_t>(w)};
+        uint64_t seen{0};
+
+        for (uint64_t i = 0; (n >= 8) && (elapsed() < options.seconds); i++)
+        {
+            // Zurückliegende Threads übernehmen regelmäßig die beste Tour:
+            if (((i & 255) == 0) && (version.load() != seen))
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                seen = version.load();
+                if (bestKm < search.length() - tour::Eps)
+                    search.assign(best, bestKm);
+            }
+
+            const auto before{search.length()};
+            search.mark();
+            search.kick(gen);
+            search.improve();
+            kicks++;
+
+            if (search.length() < before - tour::Eps)
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                if (search.length() < bestKm - tour::Eps)
+                {
+                    best = search.order();
+                    bestKm = search.length();
+                    seen = ++version;
+                    publish(false);
+                }
+            }
+            else
+                search.undo();
+        }
+    };
+
+    if (!pool || (pool->size() == 1))
+        worker(0);
+    else
+        pool->run(pool->size(), worker);
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    publish(true);
+    return ids;
+}